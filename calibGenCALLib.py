@@ -5,6 +5,7 @@ def generate(env, **kw):
     env.Tool('addLibrary', library = env['rootLibs'])
     env.Tool('addLibrary', library = env['rootGuiLibs'])
     env.Tool('addLibrary', library = env['minuitLibs'])
+    env.Tool('addLibrary', library = ['Thread', 'pthread'])
     env.Tool('CalUtilLib')
     env.Tool('calibUtilLib')
     env.Tool('gcrSelectRootDataLib')
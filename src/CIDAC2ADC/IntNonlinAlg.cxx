@@ -20,7 +20,7 @@
 #include "CalUtil/SimpleCalCalib/CalPed.h"
 
 // EXTLIB INCLUDES
-#include "TH1S.h"
+#include "TH1.h"
 #include "TProfile.h"
 #include "TNtuple.h"
 #include "TTree.h"
@@ -48,6 +48,7 @@ namespace calibGenCAL {
   IntNonlinAlg::IntNonlinAlg(const singlex16 &sx16,
                              const bool hugeTuple) :
     m_singlex16(sx16),
+    m_adcSamples(sx16.nPulsesPerDAC),
     m_fitResults(0),
     m_hugeTuple(0) 
   {
@@ -73,31 +74,14 @@ namespace calibGenCAL {
 
   
   void IntNonlinAlg::AlgData::initHists() {
-    adcHists = new TObjArray(RngIdx::N_VALS);
-
-    // delete histograms w/ TObjArray, do not save in file...
-    adcHists->SetOwner(1);
     for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
-      {
-        ostringstream tmp;
-        tmp << "adc" << rngIdx.val();
-        TH1S *h = new TH1S(tmp.str().c_str(),
-                           tmp.str().c_str(),
-                           singlex16::MAX_DAC+1, -0.5, singlex16::MAX_DAC+.5);
-        h->SetDirectory(0);
-        
-        (*adcHists)[rngIdx.val()] = h;
-      }
-
-      {
-        ostringstream tmp;
-        tmp << "ciRaw_" << rngIdx.toStr();
-        profiles[rngIdx] = new TProfile(tmp.str().c_str(),
-                                        tmp.str().c_str(),
-                                        (singlex16::MAX_DAC+1)/2,
-                                        0,
-                                        singlex16::MAX_DAC+1);
-      }
+      ostringstream tmp;
+      tmp << "ciRaw_" << rngIdx.toStr();
+      profiles[rngIdx] = new TProfile(tmp.str().c_str(),
+                                      tmp.str().c_str(),
+                                      (singlex16::MAX_DAC+1)/2,
+                                      0,
+                                      singlex16::MAX_DAC+1);
     }
   }
 
@@ -235,32 +219,18 @@ namespace calibGenCAL {
         // retrieve adc value
         const unsigned short adc(acRo.getAdc((CalXtalId::XtalFace)face.val()));
 
-        // fill histogram
         const RngIdx rngIdx(twr,
                             lyr,
                             col,
                             face,
                             rng);
 
-        TH1S & h = *(dynamic_cast<TH1S *>(algData.adcHists->At(rngIdx.val())));
-
         const float cidac = m_singlex16.CIDACTestVals()[eventData.testDAC];
 
-        // reset histogram if we're starting a new DAC setting
-        if (eventData.iSamp == 0) {
-          h.Reset();
-          h.SetAxisRange(-0.5, m_singlex16.MAX_DAC+.5);
-          // update noise graph
-          delete algData.noiseGraphs[rngIdx];
-          algData.noiseGraphs[rngIdx] = new TGraph(m_singlex16.nPulsesPerDAC);
-        }
-
-        // fill histogram
-        h.Fill(adc);
+        // store sample, samples are reset on 1st sample of new DAC setting
+        m_adcSamples.add(rngIdx, eventData.iGoodEvt - eventData.iSamp, adc);
         // fill optional profile
         algData.profiles[rngIdx]->Fill(cidac, adc);
-        // fill noise graph
-        algData.noiseGraphs[rngIdx]->SetPoint(eventData.iSamp, eventData.iSamp, adc);
 
         /// fill optional tuple
         if (m_hugeTuple) {
@@ -271,22 +241,20 @@ namespace calibGenCAL {
           m_hugeTuple->Fill();
         }
 
-        // save histogram data if we're on last sample for current
+        // save sample statistics if we're on last sample for current
         // dac settigns
         if (eventData.iSamp == (m_singlex16.nPulsesPerDAC - 1)) {
           //-- TRIM OUTLIERS
+          // (same binning as original per channel TH1S)
+          float raw_adcmean, raw_adcrms;
           float adcmean, adcrms;
-          adcmean  = h.GetMean();
-          adcrms = h.GetRMS();
-
-          // remember initial average & rms
-          const float raw_adcmean = adcmean;
-          const float raw_adcrms  = adcrms;
-          for ( unsigned short iter = 0; iter < 3; iter++ ) {
-            h.SetAxisRange(adcmean-3*adcrms, adcmean+3*adcrms);
-            adcmean  = h.GetMean();
-            adcrms = h.GetRMS();
-          }
+          clippedMeanRMS(m_adcSamples.getSamples(rngIdx),
+                         m_adcSamples.getNSamples(rngIdx),
+                         singlex16::MAX_DAC+1, -0.5, singlex16::MAX_DAC+.5,
+                         raw_adcmean,
+                         raw_adcrms,
+                         adcmean,
+                         adcrms);
           // assign to table
           algData.adcMeans->getPtsADC(rngIdx).push_back(adcmean);
           algData.adcMeans->getPtsDAC(rngIdx).push_back(cidac);
@@ -322,11 +290,18 @@ namespace calibGenCAL {
             plotname.precision(2);
             plotname << "_rms_" << adcrms;
 
+            // graph all samples for this dac setting & channel
+            const unsigned short *const samples = m_adcSamples.getSamples(rngIdx);
+            const unsigned nSamples = m_adcSamples.getNSamples(rngIdx);
+            TGraph noiseGraph(nSamples);
+            for (unsigned i = 0; i < nSamples; i++)
+              noiseGraph.SetPoint(i, i, samples[i]);
+
             TCanvas c(plotname.str().c_str(),
                       plotname.str().c_str(),
                       -1);
-            algData.noiseGraphs[rngIdx]->GetHistogram()->Draw(); /// if you know a better way to do this, please tell me.
-            algData.noiseGraphs[rngIdx]->Draw("*");
+            noiseGraph.GetHistogram()->Draw(); /// if you know a better way to do this, please tell me.
+            noiseGraph.Draw("*");
             c.Write();
           }
         }
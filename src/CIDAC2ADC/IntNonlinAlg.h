@@ -8,20 +8,19 @@
 
 // LOCAL INCLUDES
 #include "src/lib/Specs/singlex16.h"
+#include "src/lib/Util/ChannelSampleBuf.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
 #include "CalUtil/CalVec.h"
 
 // EXTLIB INCLUDES
-#include "TObjArray.h"
 
 // STD INCLUDES
 
 class DigiEvent;
 class CalDigi;
 class TProfile;
-class TGraph;
 
 namespace CalUtil {
   class CIDAC2ADC;
@@ -72,24 +71,13 @@ namespace calibGenCAL {
         diode     = CalUtil::LRG_DIODE;
         bcastMode = true;
         adcMeans  = 0;
-        adcHists = 0;
         initHists();
       }
 
-
-      /// create one temporary histogram per adc channel.
-      /// this histogram will be reused for each new CIDAC
-      /// level.
-      TObjArray *adcHists;
-
       /// profiles owned by current ROOT directory/m_histFile.
       CalUtil::CalVec<CalUtil::RngIdx, TProfile *> profiles;
 
-      /// graph all samples for given dac setting & channel
-      CalUtil::CalVec<CalUtil::RngIdx, TGraph *> noiseGraphs;
-
-      /// create new histogram objects and accompanying TObjArray
-      /// create TNtuple object for storing fit results
+      /// create new profile objects
       void initHists();
 
       /// currently processing 1 of 2 diodes
@@ -139,6 +127,10 @@ namespace calibGenCAL {
     } eventData;
 
     const singlex16 &m_singlex16;
+
+    /// all adc samples for current CIDAC level, one row per channel.
+    /// reused for each new CIDAC level.
+    ChannelSampleBuf<CalUtil::RngIdx, unsigned short> m_adcSamples;
     
     /// ntuple keeps track of fit results
     TNtuple *m_fitResults;
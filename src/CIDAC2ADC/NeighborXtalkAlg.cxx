@@ -18,7 +18,6 @@
 #include "CalUtil/SimpleCalCalib/CalPed.h"
 
 // EXTLIB INCLUDES
-#include "TH1.h"
 
 // STD INCLUDES
 #include <sstream>
@@ -128,22 +127,6 @@ namespace calibGenCAL {
     }
   }
 
-  void NeighborXtalkAlg::AlgData::initHists() {
-    adcHists = new TObjArray(DiodeIdx::N_VALS);
-
-    // delete histograms w/ TObjArray, do not save in file...
-    adcHists->SetOwner(1);
-    for (DiodeIdx diodeIdx; diodeIdx.isValid(); diodeIdx++) {
-      {
-        ostringstream tmp;
-        tmp << "adc" << diodeIdx.val();
-        (*adcHists)[diodeIdx.val()] = new TH1S(tmp.str().c_str(),
-                                               tmp.str().c_str(),
-                                               singlex16::MAX_DAC+1, -0.5, singlex16::MAX_DAC+.5);
-      }
-    }
-  }
-
   void NeighborXtalkAlg::readRootData(const string &rootFileName,
                                       NeighborXtalk &xtalk) {
     algData.xtalk  = &xtalk;
@@ -257,36 +240,29 @@ namespace calibGenCAL {
         // retrieve adc value
         const unsigned short adc = acRo.getAdc((CalXtalId::XtalFace)face.val());
 
-        // fill histogram
         const DiodeIdx diodeIdx(twr,
                                 lyr,
                                 col,
                                 face,
                                 diode);
 
-        TH1S & h = *(dynamic_cast<TH1S *>(algData.adcHists->At(diodeIdx.val())));
+        // store sample, samples are reset on 1st sample of new DAC setting
+        m_adcSamples.add(diodeIdx, eventData.iGoodEvt - eventData.iSamp, adc);
 
-        // reset histogram if we're starting a new DAC setting
-        if (eventData.iSamp == 0) {
-          h.Reset();
-          h.SetAxisRange(-0.5, m_singlex16.MAX_DAC+.5);
-        }
-
-        // fill histogram
-        h.Fill(adc);
-
-        // save histogram data if we're on last sample for current
+        // save sample statistics if we're on last sample for current
         // dac settigns
         if (eventData.iSamp == (m_singlex16.nPulsesPerDAC - 1)) {
-          float av, err;
           // trim outliers
-          av  = h.GetMean();
-          err = h.GetRMS();
-          for ( unsigned short iter = 0; iter < 3; iter++ ) {
-            h.SetAxisRange(av-3*err, av+3*err);
-            av  = h.GetMean();
-            err = h.GetRMS();
-          }
+          // (same binning as original per channel TH1S)
+          float rawAv, rawErr;
+          float av, err;
+          clippedMeanRMS(m_adcSamples.getSamples(diodeIdx),
+                         m_adcSamples.getNSamples(diodeIdx),
+                         singlex16::MAX_DAC+1, -0.5, singlex16::MAX_DAC+.5,
+                         rawAv,
+                         rawErr,
+                         av,
+                         err);
 
           // assign to table
           // 'source' channel is current injected channel / LEX8
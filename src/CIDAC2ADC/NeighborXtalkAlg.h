@@ -8,6 +8,7 @@
 
 // LOCAL INCLUDES
 #include "src/lib/Specs/singlex16.h"
+#include "src/lib/Util/ChannelSampleBuf.h"
 
 // GLAST INCLUDES
 #include "CalUtil/SimpleCalCalib/NeighborXtalk.h"
@@ -15,7 +16,6 @@
 #include "CalUtil/CalVec.h"
 
 // EXTLIB INCLUDES
-#include "TObjArray.h"
 
 // STD INCLUDES
 
@@ -36,7 +36,8 @@ namespace calibGenCAL {
     NeighborXtalkAlg(const singlex16 &sx16,
                      const bool altLoopScheme=false) :
       eventData(altLoopScheme, sx16),
-      m_singlex16(sx16)
+      m_singlex16(sx16),
+      m_adcSamples(sx16.nPulsesPerDAC)
     {}
 
     /// process digi root event file
@@ -59,21 +60,8 @@ namespace calibGenCAL {
 
       void init() {
         xtalk  = 0;
-        initHists();
       }
 
-      ~AlgData() {
-        delete adcHists;
-      }
-
-      /// create one temporary histogram per adc channel.
-      /// this histogram will be reused for each new CIDAC
-      /// level.
-      TObjArray                                   *adcHists;
-
-      /// create new histogram objects and accompanying TObjArray
-      void initHists();
-
       /// fill in the mean values for each DAC setting here.
 	  CalUtil::NeighborXtalk        *xtalk;
     } algData;
@@ -125,6 +113,10 @@ namespace calibGenCAL {
     } eventData;
 
     const singlex16 &m_singlex16;
+
+    /// all adc samples for current CIDAC level, one row per channel.
+    /// reused for each new CIDAC level.
+    ChannelSampleBuf<CalUtil::DiodeIdx, unsigned short> m_adcSamples;
   };
 
 }; // namespace calibGenCAL
@@ -12,6 +12,7 @@
 #include "src/lib/Util/RootFileAnalysis.h"
 #include "src/lib/Util/SimpleIniFile.h"
 #include "src/lib/Util/CGCUtil.h"
+#include "src/lib/CalibDataTypes/CIDAC2ADCTable.h"
 
 // GLAST INCLUDES
 #include "gcrSelectRootData/GcrSelectEvent.h"
@@ -205,9 +206,14 @@ namespace calibGenCAL {
                               GCRHists &gcrHists,
                               AsymHists &asymHists
                               ) {
+    // LEX1 & HEX8 are only ranges converted to cidac
+    const CIDAC2ADCTable dac2adcTable(dac2adc,
+                                      CIDAC2ADCTable::rngBit(LEX1) |
+                                      CIDAC2ADCTable::rngBit(HEX8));
+
     algData.clear();
     algData.calPed  = &peds;
-    algData.dac2adc = &dac2adc;
+    algData.dac2adc = &dac2adcTable;
     algData.gcrHists = &gcrHists;
     algData.asymHists = &asymHists;
 
@@ -219,6 +225,10 @@ namespace calibGenCAL {
     rootFile.getDigiChain()->SetBranchStatus("m_summary");
     rootFile.getGcrSelectChain()->SetBranchStatus("m_gcrSelect");
 
+    // event loop only fills GCRHists (HistVec / HistMap & histograms
+    // created in GCRHists ctor) & AsymHists
+    rootFile.useDefaultReadAhead();
+
     const unsigned nTotalEvents = rootFile.getEntries();
     LogStrm::get() << __FILE__ << ": Processing: " << nTotalEvents << " events." << endl;
 
@@ -265,6 +275,9 @@ namespace calibGenCAL {
     }
 
     algData.summarizeAlg(LogStrm::get());
+
+    // table goes out of scope
+    algData.dac2adc = 0;
   }
 
   void GCRCalibAlg::AlgData::summarizeAlg(ostream &ostrm) const {
@@ -348,7 +361,7 @@ namespace calibGenCAL {
     algData.nHitsPos++;
 
     //-- ADD XTAL TO HIT 'FINAL' HIT LIST --//
-    eventData.finalHitMap[xtalIdx] = &gcrXtal;
+    eventData.finalHitMap.set(xtalIdx, &gcrXtal);
   }
 
   void GCRCalibAlg::processDigiEvent() {
@@ -383,13 +396,10 @@ namespace calibGenCAL {
 
     // see if current digi matches the 'blessed' list from numerous gcr cuts
     // remove from list if it does and process it
-    // this slick STL erase() method will return non-zero only if it finds the key
-    EventData::FinalHitMapIter hitIter(eventData.finalHitMap.find(xtalIdx));
-    if (hitIter != eventData.finalHitMap.end()) {
-      const GcrSelectedXtal &gcrXtal(*(hitIter->second));
-
-      // now remove this hit from list.
-      eventData.finalHitMap.erase(hitIter);
+    // take() will return non-zero only if it finds the key
+    const GcrSelectedXtal *const pGcrXtal = eventData.finalHitMap.take(xtalIdx);
+    if (pGcrXtal != 0) {
+      const GcrSelectedXtal &gcrXtal(*pGcrXtal);
 
       //-- BEST RANGE? --//
       // get 'best' range for each face
@@ -8,6 +8,7 @@
 */
 
 // LOCAL INCLUDES
+#include "src/lib/Util/IdxPtrTable.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
@@ -41,6 +42,7 @@ namespace CalUtil {
 namespace calibGenCAL {
   class GCRHists;
   class AsymHists;
+  class CIDAC2ADCTable;
 
   /** \brief Algorithm-type class for generating GLAST Cal optical Calibrations for 
       GCR events
@@ -146,8 +148,8 @@ namespace calibGenCAL {
       /// adc pedestals for use by algorithm
       const CalUtil::CalPed *                                 calPed;
 
-      /// cidac2adc for use by alg
-      const CalUtil::CIDAC2ADC *                              dac2adc;
+      /// (tabulated) cidac2adc for use by alg
+      const CIDAC2ADCTable *                                  dac2adc;
 
       GCRHists *                               gcrHists;
       AsymHists * asymHists;
@@ -185,10 +187,8 @@ namespace calibGenCAL {
       const GcrSelectEvent * gcrSelectEvent;
 
       /// list of xtals which passed GCR cuts
-      typedef std::map < CalUtil::XtalIdx, 
-                         const GcrSelectedXtal * > FinalHitMap;
-
-      typedef FinalHitMap::iterator  FinalHitMapIter;
+      typedef IdxPtrTable<CalUtil::XtalIdx,
+                          const GcrSelectedXtal> FinalHitMap;
 
       FinalHitMap      finalHitMap;
 
@@ -28,9 +28,9 @@ namespace calibGenCAL {
   using namespace CalUtil;
 
   MuonAsymAlg::MuonAsymAlg(const CalPed &ped,
-                           const CIDAC2ADC &dac2adc,
+                           const CIDAC2ADCTable &dac2adcTable,
                            AsymHists &asymHists) :
-    eventData(ped, dac2adc),
+    eventData(ped, dac2adcTable),
     m_asymHists(asymHists)
   {
   }
@@ -179,21 +179,30 @@ namespace calibGenCAL {
 
     // enable only needed branches in root file
     rootFile.getDigiChain()->SetBranchStatus("*", 0);
-    rootFile.getDigiChain()->SetBranchStatus("m_calDigiCloneCol");
-    rootFile.getDigiChain()->SetBranchStatus("m_summary");
+    vector<string> branches;
+    getDigiBranches(branches);
+    for (unsigned i = 0; i < branches.size(); i++)
+      rootFile.getDigiChain()->SetBranchStatus(branches[i].c_str());
+
+    // event loop only fills AsymHists (HistVec)
+    rootFile.useDefaultReadAhead();
 
     const unsigned nEvents = rootFile.getEntries();
     LogStrm::get() <<
       __FILE__ << ": Processing: " << nEvents << " events." << endl;
 
+    m_asymHists.setEntriesTarget(nEntries);
+
     // Basic digi-event loop
     for (eventData.eventNum = 0; eventData.eventNum < nEvents; eventData.eventNum++) {
       eventData.next();
+
+      // quit if we have enough entries in each histogram
+      if (m_asymHists.entriesTargetReached())
+        break;
+
       if (eventData.eventNum % 10000 == 0) {
-        // quit if we have enough entries in each histogram
         const unsigned currentMin = m_asymHists.getMinEntries();
-        if (currentMin >= nEntries) break;
-
         LogStrm::get() << "Event: " << eventData.eventNum
                          << " min entries per histogram: " << currentMin
                          << endl;
@@ -214,12 +223,38 @@ namespace calibGenCAL {
       processEvent(*digiEvent);
     }  // per event loop
 
-    LogStrm::get() << "Asymmetry histograms filled nEvents=" << algData.nGoodDirs
-                     << " algData.nXDirs="               << algData.nXDirs
-                     << " algData.nYDirs="               << algData.nYDirs << endl;
-    LogStrm::get() << " nHits measured="       <<               algData.nHits
-                     << " Bad hits="             << algData.nBadHits
-                     << endl;
+    summarizeAlg(LogStrm::get());
+  }
+
+  void MuonAsymAlg::summarizeAlg(ostream &ostrm) const {
+    ostrm << "Asymmetry histograms filled nEvents=" << algData.nGoodDirs
+          << " algData.nXDirs="               << algData.nXDirs
+          << " algData.nYDirs="               << algData.nYDirs << endl;
+    ostrm << " nHits measured="       <<               algData.nHits
+          << " Bad hits="             << algData.nBadHits
+          << endl;
+  }
+
+  void MuonAsymAlg::getDigiBranches(vector<string> &branches) const {
+    branches.push_back("m_calDigiCloneCol");
+    branches.push_back("m_summary");
+  }
+
+  void MuonAsymAlg::initConsumer(const unsigned nEntries) {
+    m_asymHists.setEntriesTarget(nEntries);
+  }
+
+  bool MuonAsymAlg::consumeEvent(const unsigned eventNum,
+                                 const DigiEvent &digiEvent) {
+    eventData.eventNum = eventNum;
+    eventData.next();
+
+    // quit if we have enough entries in each histogram
+    if (m_asymHists.entriesTargetReached())
+      return false;
+
+    processEvent(digiEvent);
+    return !m_asymHists.entriesTargetReached();
   }
 
 }; // namespace calibGenCAL
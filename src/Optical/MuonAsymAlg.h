@@ -8,6 +8,8 @@
 
 // LOCAL INCLUDES
 #include "src/lib/Util/TwrHodoscope.h"
+#include "src/lib/CalibDataTypes/CIDAC2ADCTable.h"
+#include "src/lib/Util/FusedDigiLoop.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
@@ -16,13 +18,13 @@
 // EXTLIB INCLUDES
 
 // STD INCLUDES
+#include <ostream>
 
 class DigiEvent;
 
 namespace CalUtil {
   class CalAsym;
   class CalPed;
-  class CIDAC2ADC;
 }
 
 namespace calibGenCAL {
@@ -35,16 +37,33 @@ namespace calibGenCAL {
 
       @author Zachary Fewtrell
   */
-  class MuonAsymAlg {
+  class MuonAsymAlg : public DigiEventConsumer {
   public:
+    /// \param dac2adcTable adc2dac table w/ LEX8 & HEX8 ranges,
+    /// may be shared w/ other algs, must outlive this object
     MuonAsymAlg(const CalUtil::CalPed &ped,
-                const CalUtil::CIDAC2ADC &dac2adc,
+                const CIDAC2ADCTable &dac2adcTable,
                 AsymHists &asymHists);
 
     /// populate asymmetry profiles w/ nEvt worth of data.
     void        fillHists(unsigned nEntries,
                           const vector<string> &rootFileList);
 
+    /// prepare for event loop driven by FusedDigiLoop in place of
+    /// fillHists()
+    void        initConsumer(const unsigned nEntries);
+
+    /// DigiEventConsumer interface
+    void        getDigiBranches(std::vector<std::string> &branches) const;
+
+    /// DigiEventConsumer interface
+    /// \pre initConsumer() has been called
+    bool        consumeEvent(const unsigned eventNum,
+                             const DigiEvent &digiEvent);
+
+    /// print event & hit counts
+    void        summarizeAlg(std::ostream &ostrm) const;
+
   private:
     /// process a single event for histogram fill
     void        processEvent(const DigiEvent &digiEvent);
@@ -91,9 +110,9 @@ namespace calibGenCAL {
 
     public:
       EventData(const CalUtil::CalPed &peds,
-                const CalUtil::CIDAC2ADC &dac2adc) :
+                const CIDAC2ADCTable &dac2adcTable) :
         hscopes(CalUtil::TwrNum::N_VALS,
-                TwrHodoscope(peds, dac2adc)),
+                TwrHodoscope(peds, dac2adcTable)),
         eventNum(0)
       {
       }
@@ -109,9 +109,14 @@ namespace calibGenCAL {
     // configure active branches from input ROOT trees
     cfgBranches(rootFile);
 
+    // match svac entries to digi events by (RunID, EventID)
+    rootFile.enableEventAlignment();
+
     const unsigned nEvents = rootFile.getEntries();
     LogStrm::get() << __FILE__ << ": Processing: " << nEvents << " events." << endl;
 
+    m_mpdHists.setEntriesTarget(nEntries);
+
     /////////////////////
     // DIGI Event Loop //
     /////////////////////
@@ -120,10 +125,12 @@ namespace calibGenCAL {
       eventData.next();
       //LogStrm::get() << "event: " << eventData.eventNum << endl;
 
+      // quit if we have enough entries in each histogram
+      if (m_mpdHists.entriesTargetReached())
+        break;
+
       if (eventData.eventNum % 10000 == 0) {
-        // quit if we have enough entries in each histogram
         const unsigned currentMin = m_mpdHists.getMinEntries();
-        if (currentMin >= nEntries) break;
         LogStrm::get() << "Event: " << eventData.eventNum
                        << " min entries per histogram: " << currentMin
                        << endl;
@@ -132,6 +139,7 @@ namespace calibGenCAL {
         algData.printStatus(LogStrm::get());
       }
 
+      // events missing from either chain are skipped
       if (!rootFile.getEvent(eventData.eventNum)) {
         LogStrm::get() << "Warning, event " << eventData.eventNum << " not read." << endl;
         continue;
@@ -144,8 +152,12 @@ namespace calibGenCAL {
       }
 
       // check that event ID is in sync for both SVAC & Digi
-      assert(digiEvent->getRunId()  == eventData.svacRunID &&
-             digiEvent->getEventId() == eventData.svacEventID);
+      if (digiEvent->getRunId()  != eventData.svacRunID ||
+          digiEvent->getEventId() != eventData.svacEventID) {
+        LogStrm::get() << "Warning, event " << eventData.eventNum
+                       << " SVAC & Digi event ids out of sync." << endl;
+        continue;
+      }
 
       // quick high level event cut
       if (!eventCut())
@@ -154,6 +166,10 @@ namespace calibGenCAL {
       if (!processEvent(*digiEvent))
         continue;
     }
+
+    LogStrm::get() << __FILE__ << ": " << rootFile.getNUnmatched()
+                   << " digi events w/out matching SVAC event skipped, "
+                   << rootFile.getNFailedReads() << " events could not be read." << endl;
   }
 
   bool MuonCalibTkrAlg::processEvent(const DigiEvent &digiEvent) {
@@ -9,6 +9,7 @@
 // LOCAL INCLUDES
 #include "src/lib/Specs/CalGeom.h"
 #include "src/lib/Util/CalHodoscope.h"
+#include "src/lib/CalibDataTypes/CIDAC2ADCTable.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
@@ -223,7 +224,10 @@ namespace calibGenCAL {
     public:
       EventData(const CalUtil::CalPed &ped,
                 const CalUtil::CIDAC2ADC &dac2adc) :
-        hscope(ped, dac2adc)
+        dac2adcTable(dac2adc,
+                     CIDAC2ADCTable::rngBit(CalUtil::LEX8) |
+                     CIDAC2ADCTable::rngBit(CalUtil::HEX8)),
+        hscope(ped, dac2adcTable)
       {
         init();
       }
@@ -258,6 +262,9 @@ namespace calibGenCAL {
       /// store set of valid hit xtals derived from tracker track
       std::map<CalUtil::XtalIdx, CalGeom::Vec3D> trkHitMap;
 
+      /// x8 range adc2dac used by hscope
+      const CIDAC2ADCTable dac2adcTable;
+
       /// store hodoscopic summary of all event hits.
       CalHodoscope hscope;
 
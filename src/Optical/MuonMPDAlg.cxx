@@ -11,6 +11,7 @@
 #include "src/lib/Util/RootFileAnalysis.h"
 #include "src/lib/Util/TwrHodoscope.h"
 #include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/LineFit.h"
 
 // GLAST INCLUDES
 #include "digiRootData/DigiEvent.h"
@@ -23,6 +24,7 @@
 
 // STD INCLUDES
 #include <sstream>
+#include <cmath>
 
 namespace calibGenCAL {
 
@@ -31,11 +33,11 @@ namespace calibGenCAL {
   using namespace CalGeom;
 
   MuonMPDAlg::MuonMPDAlg(const CalPed &ped,
-                         const CIDAC2ADC &dac2adc,
+                         const CIDAC2ADCTable &dac2adcTable,
                          const CalAsym &calAsym,
                          MPDHists &mpdHists) :
     algData(calAsym),
-    eventData(ped, dac2adc),
+    eventData(ped, dac2adcTable),
     m_mpdHists(mpdHists)
   {
   }
@@ -50,22 +52,31 @@ namespace calibGenCAL {
 
     // enable only needed branches in root file
     rootFile.getDigiChain()->SetBranchStatus("*", 0);
-    rootFile.getDigiChain()->SetBranchStatus("m_calDigiCloneCol");
-    rootFile.getDigiChain()->SetBranchStatus("m_summary");
+    vector<string> branches;
+    getDigiBranches(branches);
+    for (unsigned i = 0; i < branches.size(); i++)
+      rootFile.getDigiChain()->SetBranchStatus(branches[i].c_str());
+
+    // histograms were all created above, event loop only fills them
+    rootFile.useDefaultReadAhead();
 
     const unsigned nEvents = rootFile.getEntries();
     LogStrm::get() << __FILE__ << ": Processing: " << nEvents << " events." << endl;
 
+    m_mpdHists.setEntriesTarget(nEntries);
+
     ///////////////////////////////////////////
     // DIGI Event Loop - Fill Twr Hodoscopes //
     ///////////////////////////////////////////
     for (eventData.eventNum = 0; eventData.eventNum < nEvents; eventData.eventNum++) {
       eventData.next();
 
+      // quit if we have enough entries in each histogram
+      if (m_mpdHists.entriesTargetReached())
+        break;
+
       if (eventData.eventNum % 10000 == 0) {
-        // quit if we have enough entries in each histogram
         const unsigned currentMin = m_mpdHists.getMinEntries();
-        if (currentMin >= nEntries) break;
         LogStrm::get() << "Event: " << eventData.eventNum
                          << " min entries per histogram: " << currentMin
                          << endl;
@@ -87,6 +98,29 @@ namespace calibGenCAL {
     }
   }
 
+  void MuonMPDAlg::getDigiBranches(vector<string> &branches) const {
+    branches.push_back("m_calDigiCloneCol");
+    branches.push_back("m_summary");
+  }
+
+  void MuonMPDAlg::initConsumer(const unsigned nEntries) {
+    m_mpdHists.initHists();
+    m_mpdHists.setEntriesTarget(nEntries);
+  }
+
+  bool MuonMPDAlg::consumeEvent(const unsigned eventNum,
+                                const DigiEvent &digiEvent) {
+    eventData.eventNum = eventNum;
+    eventData.next();
+
+    // quit if we have enough entries in each histogram
+    if (m_mpdHists.entriesTargetReached())
+      return false;
+
+    processEvent(digiEvent);
+    return !m_mpdHists.entriesTargetReached();
+  }
+
   bool MuonMPDAlg::passCutX(const TwrHodoscope &hscope) {
     // max 2 hits on any layer
     if (hscope.maxPerLyr > 2)
@@ -196,21 +230,22 @@ namespace calibGenCAL {
       }
 
       //-- GET HODOSCOPIC TRACK FROM ORTHOGONAL XTALS --//
-      algData.graph.Set(hitListOrtho.size());
+      LineFit hodoTrack;
 
       // fill in each point val
       for (unsigned i = 0; i < hitListOrtho.size(); i++) {
         const XtalIdx xtalIdx(hitListOrtho[i]);
         const LyrNum  lyr(xtalIdx.getLyr());
         const ColNum  col(xtalIdx.getCol());
-        algData.graph.SetPoint(i, lyr.val(), col.val());
+        hodoTrack.addPoint(lyr.val(), col.val());
       }
 
-      // fit straight line through graph
-      algData.graph.Fit(&algData.lineFunc, "WQN");
+      // fit straight line through points
+      // (cannot fail as passCut requires >= 2 orthogonal layers)
+      if (!hodoTrack.fit()) continue;
 
       // throw out events which are greater than about 30 deg from vertical
-      float lineSlope(algData.lineFunc.GetParameter(1));
+      float lineSlope(hodoTrack.getSlope());
       if (abs(lineSlope) > 0.5) continue;
 
       //-- THROW OUT HITS NEAR END OF XTAL --//
@@ -220,7 +255,7 @@ namespace calibGenCAL {
         const XtalIdx xtalIdx(hitList[i]);
         const LyrNum  lyr(xtalIdx.getLyr());
 
-        const float   hitPos(algData.lineFunc.Eval(lyr.val()));    // find column for given lyr
+        const float   hitPos(hodoTrack.eval(lyr.val()));    // find column for given lyr
 
         //throw out event if energy centroid is in column 0 or 11 (3cm from end)
         if (hitPos < 1 || hitPos > 10) {
@@ -238,7 +273,7 @@ namespace calibGenCAL {
         //-- IMPROVE TRACK W/ ASYMMETRY FROM GOOD XTALS --//
         // now that we have eliminated events on the ends of xtals, we can use
         // asymmetry to get a higher precision slope
-        algData.graph.Set(hitList.size());    // reset graph size in case we removed any invalid points.
+        LineFit asymTrack;
         for (unsigned i = 0; i < hitList.size(); i++) {
           const XtalIdx xtalIdx(hitList[i]);
           const LyrNum  lyr(xtalIdx.getLyr());
@@ -251,11 +286,12 @@ namespace calibGenCAL {
           // get new position from asym
           const float   hitPos(algData.calAsym.asym2pos(xtalIdx, LRG_DIODE, asymLL));
 
-          algData.graph.SetPoint(i, lyr.val(), hitPos);
+          asymTrack.addPoint(lyr.val(), hitPos);
         }
 
-        algData.graph.Fit(&algData.lineFunc, "WQN");
-        lineSlope = algData.lineFunc.GetParameter(1);
+        // keep hodoscopic slope if remaining hits all share one layer
+        if (asymTrack.fit())
+          lineSlope = asymTrack.getSlope();
       }
 
       // NUMERIC CONSTANTS
@@ -293,24 +329,9 @@ namespace calibGenCAL {
   }
 
   MuonMPDAlg::AlgData::AlgData(const CalAsym &asym) :
-    canvas("canvas", "event display", 800, 600),
-    graph(4),
-    lineFunc("line", "pol1", 0, 8),
-    viewHist("viewHist", "viewHist",
-             8, -0.5, 7.5,    //X-limits lyr
-             12, -0.5, 11.5),
-    //Y-limits col
     calAsym(asym)
   {
     init();
-
-    ////////////////////////////////////////////////////
-    // INITIALIZE ROOT PLOTTING OBJECTS FOR LINE FITS //
-    ////////////////////////////////////////////////////
-    // viewHist is used to set scale before drawing TGraph
-    viewHist.Draw();
-    graph.Draw("*");
-    canvas.Update();
   }
 
 }; // namespace calibGenCAL
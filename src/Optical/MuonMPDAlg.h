@@ -8,16 +8,14 @@
 
 // LOCAL INCLUDES
 #include "src/lib/Util/TwrHodoscope.h"
+#include "src/lib/CalibDataTypes/CIDAC2ADCTable.h"
+#include "src/lib/Util/FusedDigiLoop.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
 #include "CalUtil/CalVec.h"
 
 // EXTLIB INCLUDES
-#include "TCanvas.h"
-#include "TGraph.h"
-#include "TF1.h"
-#include "TH2S.h"
 
 // STD INCLUDES
 #include <iostream>
@@ -26,7 +24,6 @@ class DigiEvent;
 
 namespace CalUtil {
   class CalPed;
-  class CIDAC2ADC;
   class CalAsym;
   class CalMPD;
 }
@@ -40,10 +37,12 @@ namespace calibGenCAL {
 
       @author Zachary Fewtrell
   */
-  class MuonMPDAlg {
+  class MuonMPDAlg : public DigiEventConsumer {
   public:
+    /// \param dac2adcTable adc2dac table w/ LEX8 & HEX8 ranges,
+    /// may be shared w/ other algs, must outlive this object
 	  MuonMPDAlg(const CalUtil::CalPed &ped,
-               const CalUtil::CIDAC2ADC &dac2adc,
+               const CIDAC2ADCTable &dac2adcTable,
                const CalUtil::CalAsym &asym,
                MPDHists &mpdHists);
 
@@ -51,6 +50,18 @@ namespace calibGenCAL {
     void        fillHists(const unsigned nEntries,
                           const std::vector<std::string> &rootFileList);
 
+    /// prepare for event loop driven by FusedDigiLoop in place of
+    /// fillHists()
+    void        initConsumer(const unsigned nEntries);
+
+    /// DigiEventConsumer interface
+    void        getDigiBranches(std::vector<std::string> &branches) const;
+
+    /// DigiEventConsumer interface
+    /// \pre initConsumer() has been called
+    bool        consumeEvent(const unsigned eventNum,
+                             const DigiEvent &digiEvent);
+
   private:
     /// process a single event for histogram fill
     void        processEvent(const DigiEvent &digiEvent);
@@ -81,11 +92,6 @@ namespace calibGenCAL {
       unsigned nYEvents;
       unsigned nXtals;
 
-      TCanvas  canvas;
-      TGraph   graph;
-      TF1      lineFunc;
-      TH2S     viewHist;
-
 	  const    CalUtil::CalAsym &calAsym;
     } algData;
 
@@ -100,8 +106,8 @@ namespace calibGenCAL {
 
     public:
 		EventData(const CalUtil::CalPed &ped,
-                const CalUtil::CIDAC2ADC &dac2adc) :
-        hscopes(CalUtil::TwrNum::N_VALS, TwrHodoscope(ped, dac2adc))
+                const CIDAC2ADCTable &dac2adcTable) :
+        hscopes(CalUtil::TwrNum::N_VALS, TwrHodoscope(ped, dac2adcTable))
       {
         init();
       }
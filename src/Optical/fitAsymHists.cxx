@@ -41,11 +41,16 @@ public:
     muonGain("muonGain",
              'm',
              "assume cal in MUON GAIN mode instead of FLIGHT_GAIN"),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
     help("help",
          'h',
          "print usage info")
   {
     cmdParser.registerArg(outputBasename);
+    cmdParser.registerVar(nFitWorkers);
     cmdParser.registerSwitch(help);
 
     try {
@@ -63,6 +68,9 @@ public:
   CmdArg<string> outputBasename;
 
   CmdSwitch muonGain;
+
+  CmdOptVar<unsigned> nFitWorkers;
+
   /// print usage string
   CmdSwitch help;
 
@@ -110,10 +118,10 @@ int main(int argc,
     }
     
     CalResponse::CAL_GAIN_INTENT calGain = (cfg.muonGain.getVal()) ? CalResponse::MUON_GAIN : CalResponse::FLIGHT_GAIN;
-    AsymHists asymHists(calGain, 12,10,0,&histFile);
+    AsymHists asymHists(calGain, 12,10,0,&histFile, true);
 
     LogStrm::get() << __FILE__ << ": fitting light asymmmetry histograms." << endl;
-    asymHists.fitHists(calAsym);
+    asymHists.fitHists(calAsym, cfg.nFitWorkers.getVal());
 
     LogStrm::get() << __FILE__ << ": writing light asymmetry: "
                      << outputTXTFile << endl;
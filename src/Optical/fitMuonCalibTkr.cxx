@@ -40,6 +40,10 @@ public:
     outputBasename("outputBasename",
                    "all output files will use this basename + some_ext",
                    ""),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
     help("help",
          'h',
          "print usage info")
@@ -47,6 +51,7 @@ public:
   {
     cmdParser.registerArg(outputBasename);
     cmdParser.registerSwitch(skipAsym);
+    cmdParser.registerVar(nFitWorkers);
     cmdParser.registerSwitch(help);
 
     try {
@@ -69,6 +74,8 @@ public:
   CmdArg<string> outputBasename;
 
 
+  CmdOptVar<unsigned> nFitWorkers;
+
   /// print usage string
   CmdSwitch help;
 };
@@ -120,9 +127,10 @@ int main(int argc,
       CalAsym   calAsym;
 
       AsymHists asymHists(CalResponse::MUON_GAIN);
-      asymHists.loadHists(histFile);
+      // only histogram being fitted is held in memory
+      asymHists.loadHists(histFile, true);
       LogStrm::get() << __FILE__ << ": fitting asymmetry histograms." << endl;
-      asymHists.fitHists(calAsym);
+      asymHists.fitHists(calAsym, cfg.nFitWorkers.getVal());
       
       string asymTXTFile(cfg.outputBasename.getVal() + ".calAsym.txt");
       LogStrm::get() << __FILE__ << ": writing light asymmetry: "
@@ -131,7 +139,7 @@ int main(int argc,
     }
 
     LogStrm::get() << __FILE__ << ": fitting MeVPerDAC histograms." << endl;
-    mpdHists.fitHists(calMPD);
+    mpdHists.fitHists(calMPD, cfg.nFitWorkers.getVal());
 
     LogStrm::get() << __FILE__ << ": writing muon mevPerDAC: "
                      << mpdTXTFile << endl;
@@ -13,6 +13,8 @@
 #include "GCRCalibAlg.h"
 #include "src/lib/Util/SimpleIniFile.h"
 #include "src/lib/Util/CfgMgr.h"
+#include "src/lib/Util/InputReadCfg.h"
+#include "src/lib/Util/RootFileAnalysis.h"
 #include "src/lib/Util/CGCUtil.h"
 #include "src/lib/Util/stl_util.h"
 #include "src/lib/Util/string_util.h"
@@ -69,6 +71,9 @@ public:
                 's',
                 "generate summary histograms only (no individual channel hists)"
                 ),
+    singlePass("singlePass",
+               'S',
+               "read each digi file once for both pedestal passes (buffers rough pass hits in memory)"),
     help("help",
          'h',
          "print usage info"),
@@ -86,8 +91,10 @@ public:
     cmdParser.registerArg(gcrFilenames);
     cmdParser.registerArg(outputBasename);
 
+    inputRead.registerVars(cmdParser);
     cmdParser.registerSwitch(help);
     cmdParser.registerSwitch(summaryMode);
+    cmdParser.registerSwitch(singlePass);
 
     cmdParser.registerVar(cfgPath);
     cmdParser.registerVar(inputMPDTXTFile);
@@ -116,6 +123,12 @@ public:
 
   CmdSwitch summaryMode;
 
+  /// single read of digi input for rough & final pedestals
+  CmdSwitch singlePass;
+
+  /// read ahead & TTreeCache options
+  InputReadCfg inputRead;
+
   /// print usage string
   CmdSwitch help;
 
@@ -133,6 +146,9 @@ int main(const int argc,
     AppCfg  cfg(argc,
                 argv);
 
+    // read ahead & TTreeCache settings for all event loops
+    cfg.inputRead.applyDefaults();
+
     // input file(s)
     const vector<string> digiFileList(getLinesFromFile(cfg.digiFilenames.getVal().c_str()));
     if (digiFileList.size() < 1) {
@@ -211,32 +227,45 @@ int main(const int argc,
 
       //-- DETERMINE PEDESTALS FROM DIGI FILE. --//
       // ped step 1: rough pedestals
-      MuonPedAlg roughPedAlg;
+      // (single pass: rough pass hits are buffered & replayed in step 2)
+      MuonPedAlg pedAlg;
       CalPed roughPed;
 
       LogStrm::get() << __FILE__ << ": filling rough pedestal histograms:" << *digiFileIt << endl;
       /// zero out pedestal histograms
       pedHists.resetHists();
-      roughPedAlg.fillHists(ROUGHPED_MIN_ENTRIES,
-                            curDigiFileList,
-                            NULL,
-                            pedHists,
-                            MuonPedAlg::PERIODIC_TRIGGER);
+      if (cfg.singlePass.getVal())
+        pedAlg.fillRoughHists(ROUGHPED_MIN_ENTRIES,
+                              curDigiFileList,
+                              pedHists,
+                              MuonPedAlg::PERIODIC_TRIGGER);
+      else
+        pedAlg.fillHists(ROUGHPED_MIN_ENTRIES,
+                         curDigiFileList,
+                         NULL,
+                         pedHists,
+                         MuonPedAlg::PERIODIC_TRIGGER);
       pedHists.trimHists();
       LogStrm::get() << __FILE__ << ": fitting rough pedestal histograms." << *digiFileIt << endl;
       pedHists.fitHists(roughPed);
 
       // ped step 2: rough pedestals
-      MuonPedAlg pedAlg;
       CalPed ped;
       LogStrm::get() << __FILE__ << ": filling final pedestal histograms:" << *digiFileIt << endl;
       /// zero out pedestal histograms
       pedHists.resetHists();
-      pedAlg.fillHists(PED_DESIRED_MIN_ENTRIES,
-                       curDigiFileList,
-                       &roughPed,
-                       pedHists,
-                       MuonPedAlg::PERIODIC_TRIGGER);
+      if (cfg.singlePass.getVal())
+        pedAlg.fillCutHists(PED_DESIRED_MIN_ENTRIES,
+                            roughPed,
+                            pedHists);
+      else {
+        MuonPedAlg cutPedAlg;
+        cutPedAlg.fillHists(PED_DESIRED_MIN_ENTRIES,
+                            curDigiFileList,
+                            &roughPed,
+                            pedHists,
+                            MuonPedAlg::PERIODIC_TRIGGER);
+      }
       pedHists.trimHists();
       if (pedHists.getMinEntries() < PED_MIN_ENTRIES) {
         LogStrm::get() << __FILE__ << ": digiFile " << *digiFileIt << "contains less than "
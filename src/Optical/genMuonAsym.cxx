@@ -9,7 +9,10 @@
 // LOCAL INCLUDES
 #include "MuonAsymAlg.h"
 #include "src/lib/Hists/AsymHists.h"
+#include "src/lib/CalibDataTypes/CIDAC2ADCTable.h"
 #include "src/lib/Util/CfgMgr.h"
+#include "src/lib/Util/InputReadCfg.h"
+#include "src/lib/Util/RootFileAnalysis.h"
 #include "src/lib/Util/CGCUtil.h"
 #include "src/lib/Util/string_util.h"
 #include "src/lib/Util/stl_util.h"
@@ -55,6 +58,10 @@ public:
                    'e',
                    "quit after all histograms have > n entries",
                    10000),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
     help("help",
          'h',
          "print usage info")
@@ -66,6 +73,8 @@ public:
     cmdParser.registerArg(digiFilenames);
     cmdParser.registerArg(outputBasename);
     cmdParser.registerVar(entriesPerHist);
+    cmdParser.registerVar(nFitWorkers);
+    inputRead.registerVars(cmdParser);
     cmdParser.registerSwitch(help);
 
     try {
@@ -85,6 +94,12 @@ public:
   CmdArg<string> digiFilenames;
   CmdArg<string> outputBasename;
   CmdOptVar<unsigned> entriesPerHist;
+
+  CmdOptVar<unsigned> nFitWorkers;
+
+  /// read ahead & TTreeCache options
+  InputReadCfg inputRead;
+
   /// print usage string
   CmdSwitch help;
 
@@ -96,6 +111,9 @@ int main(int argc,
   try {
     AppCfg cfg(argc, argv);
 
+    // read ahead & TTreeCache settings for all event loops
+    cfg.inputRead.applyDefaults();
+
     // input file(s)
     vector<string> digiFileList(getLinesFromFile(cfg.digiFilenames.getVal().c_str()));
     if (digiFileList.size() < 1) {
@@ -133,6 +151,11 @@ int main(int argc,
     LogStrm::get() << __FILE__ << ": generating dac2adc splines: " << endl;
     dac2adc.genSplines();
 
+    LogStrm::get() << __FILE__ << ": tabulating x8 range adc2dac: " << endl;
+    const CIDAC2ADCTable dac2adcTable(dac2adc,
+                                      CIDAC2ADCTable::rngBit(LEX8) |
+                                      CIDAC2ADCTable::rngBit(HEX8));
+
     //-- LIGHT ASYM
     // output histogram file name
     const string histFilename(cfg.outputBasename.getVal() + ".root");
@@ -151,7 +174,7 @@ int main(int argc,
 
     AsymHists asymHists(CalResponse::MUON_GAIN,12,10,&histFile);
     MuonAsymAlg muonAsym(peds,
-                         dac2adc,
+                         dac2adcTable,
                          asymHists);
 
 
@@ -167,7 +190,7 @@ int main(int argc,
     asymHists.summarizeHists(LogStrm::get());
 
     LogStrm::get() << __FILE__ << ": fitting light asymmmetry histograms." << endl;
-    asymHists.fitHists(calAsym);
+    asymHists.fitHists(calAsym, cfg.nFitWorkers.getVal());
 
     LogStrm::get() << __FILE__ << ": writing light asymmetry: "
                      << outputTXTFile << endl;
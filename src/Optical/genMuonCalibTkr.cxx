@@ -69,6 +69,10 @@ public:
             'c',
             "(optional) read cfg info from this file (supports env var expansion)",
             ""),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
     help("help",
          'h',
          "print usage info")
@@ -83,6 +87,7 @@ public:
     cmdParser.registerVar(entriesPerHist);
     cmdParser.registerVar(startEvent);
     cmdParser.registerVar(cfgPath);
+    cmdParser.registerVar(nFitWorkers);
     cmdParser.registerSwitch(help);
 
     try {
@@ -111,6 +116,8 @@ public:
 
   CmdOptVar<string> cfgPath;
 
+  CmdOptVar<unsigned> nFitWorkers;
+
   /// print usage string
   CmdSwitch help;
 };
@@ -201,14 +208,14 @@ int main(int argc,
     asymHists.trimHists();
 
     LogStrm::get() << __FILE__ << ": fitting asymmetry histograms." << endl;
-    asymHists.fitHists(calAsym);
+    asymHists.fitHists(calAsym, cfg.nFitWorkers.getVal());
 
     LogStrm::get() << __FILE__ << ": writing light asymmetry: "
                      << asymTXTFile << endl;
     calAsym.writeTXT(asymTXTFile);
 
     LogStrm::get() << __FILE__ << ": fitting MeVPerDAC histograms." << endl;
-    mpdHists.fitHists(calMPD);
+    mpdHists.fitHists(calMPD, cfg.nFitWorkers.getVal());
 
     LogStrm::get() << __FILE__ << ": writing muon mevPerDAC: "
                      << mpdTXTFile << endl;
@@ -8,7 +8,10 @@
 // LOCAL INCLUDES
 #include "src/lib/Hists/MPDHists.h"
 #include "MuonMPDAlg.h"
+#include "src/lib/CalibDataTypes/CIDAC2ADCTable.h"
 #include "src/lib/Util/CfgMgr.h"
+#include "src/lib/Util/InputReadCfg.h"
+#include "src/lib/Util/RootFileAnalysis.h"
 #include "src/lib/Util/CGCUtil.h"
 #include "src/lib/Util/string_util.h"
 #include "src/lib/Util/stl_util.h"
@@ -57,6 +60,10 @@ public:
                    'e',
                    "quit after all histograms have > n entries",
                    3000),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
     help("help",
          'h',
          "print usage info")
@@ -68,6 +75,8 @@ public:
     cmdParser.registerArg(digiFilenames);
     cmdParser.registerArg(outputBasename);
     cmdParser.registerVar(entriesPerHist);
+    cmdParser.registerVar(nFitWorkers);
+    inputRead.registerVars(cmdParser);
     cmdParser.registerSwitch(help);
         
     try {
@@ -92,6 +101,11 @@ public:
 
   CmdOptVar<unsigned> entriesPerHist;
 
+  CmdOptVar<unsigned> nFitWorkers;
+
+  /// read ahead & TTreeCache options
+  InputReadCfg inputRead;
+
   /// print usage string
   CmdSwitch help;
 
@@ -102,6 +116,9 @@ int main(int argc,
   // libCalibGenCAL will throw runtime_error
   try {
     AppCfg cfg(argc, argv);
+
+    // read ahead & TTreeCache settings for all event loops
+    cfg.inputRead.applyDefaults();
     // input file(s)
     vector<string> digiFileList(getLinesFromFile(cfg.digiFilenames.getVal().c_str()));
     if (digiFileList.size() < 1) {
@@ -136,6 +153,11 @@ int main(int argc,
     LogStrm::get() << __FILE__ << ": generating cidac2adc splines: " << endl;
     dac2adc.genSplines();
 
+    LogStrm::get() << __FILE__ << ": tabulating x8 range adc2dac: " << endl;
+    const CIDAC2ADCTable dac2adcTable(dac2adc,
+                                      CIDAC2ADCTable::rngBit(LEX8) |
+                                      CIDAC2ADCTable::rngBit(HEX8));
+
     //-- RETRIEVE ASYM
     CalAsym asym;
     LogStrm::get() << __FILE__ << ": reading in light asym file: " << cfg.asymTXTFile.getVal() << endl;
@@ -163,7 +185,7 @@ int main(int argc,
     
     MPDHists mpdHists(MPDHists::FitMethods::LANDAU);
     MuonMPDAlg  muonMPD(peds,
-                        dac2adc,
+                        dac2adcTable,
                         asym,
                         mpdHists);
 
@@ -178,7 +200,7 @@ int main(int argc,
     //histFile->Write();
     
     LogStrm::get() << __FILE__ << ": fitting muon mpd histograms." << endl;
-    mpdHists.fitHists(calMPD);
+    mpdHists.fitHists(calMPD, cfg.nFitWorkers.getVal());
 
     LogStrm::get() << __FILE__ << ": writing muon mpd: " << outputTXTFile << endl;
     calMPD.writeTXT(outputTXTFile);
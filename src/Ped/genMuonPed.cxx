@@ -9,7 +9,10 @@
 // LOCAL INCLUDES
 #include "src/lib/Algs/MuonPedAlg.h"
 #include "src/lib/Util/CfgMgr.h"
+#include "src/lib/Util/InputReadCfg.h"
+#include "src/lib/Util/RootFileAnalysis.h"
 #include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/CalSkimCache.h"
 #include "src/lib/Util/string_util.h"
 #include "src/lib/Util/stl_util.h"
 #include "src/lib/Hists/PedHists.h"
@@ -44,6 +47,20 @@ public:
                    'e',
                    "quit after all histograms have > n entries",
                    1000),
+    nThreads("nThreads",
+             'j',
+             "process input events & fit histograms w/ n worker processes",
+             1),
+    cacheDir("cacheDir",
+             'c',
+             "read events via Cal skim cache in this directory (created on first use)",
+             ""),
+    singlePass("singlePass",
+               's',
+               "read input events once, buffer rough pass hits in memory & replay them w/ outlier cut"),
+    fastFit("fastFit",
+            'f',
+            "closed form gaussian pedestal estimate, Minuit fit only for channels which fail quality check"),
     digiFilenames("digiFilenames",
                   "text file w/ newline delimited list of input digi ROOT files",
                   ""
@@ -59,6 +76,11 @@ public:
     cmdParser.registerArg(outputBasename);
     cmdParser.registerVar(triggerCut);
     cmdParser.registerVar(entriesPerHist);
+    cmdParser.registerVar(nThreads);
+    cmdParser.registerVar(cacheDir);
+    cmdParser.registerSwitch(singlePass);
+    cmdParser.registerSwitch(fastFit);
+    inputRead.registerVars(cmdParser);
     cmdParser.registerSwitch(help);
 
 
@@ -82,10 +104,24 @@ public:
 
   CmdOptVar<unsigned> entriesPerHist;
 
+  CmdOptVar<unsigned> nThreads;
+
+  /// optional Cal skim cache directory
+  CmdOptVar<string> cacheDir;
+
+  /// single pass over input digi files
+  CmdSwitch singlePass;
+
+  /// closed form pedestal fits
+  CmdSwitch fastFit;
+
   CmdArg<string> digiFilenames;
   
   CmdArg<string> outputBasename;
 
+  /// read ahead & TTreeCache options
+  InputReadCfg inputRead;
+
   /// print usage string
   CmdSwitch help;
 
@@ -97,6 +133,9 @@ int main(int argc,
   try {
     AppCfg cfg(argc,argv);
 
+    // read ahead & TTreeCache settings for all event loops
+    cfg.inputRead.applyDefaults();
+
     // input file(s)
     vector<string> digiFileList(getLinesFromFile(cfg.digiFilenames.getVal().c_str()));
     if (digiFileList.size() < 1) {
@@ -149,6 +188,20 @@ int main(int argc,
     MuonPedAlg::TRIGGER_CUT trigCut     = trigCutMap[trigCutStr];
 
     const unsigned nEntries(cfg.entriesPerHist.getVal());
+    const unsigned nThreads(cfg.nThreads.getVal());
+
+    // both passes read from same skim file
+    string skimPath;
+    if (!cfg.cacheDir.getVal().empty()) {
+      skimPath = getCalSkimCache(cfg.cacheDir.getVal(), digiFileList);
+      if (nThreads > 1)
+        LogStrm::get() << __FILE__ << ": Cal skim input is processed in single process." << endl;
+    }
+
+    // single pass applies to digi input only (skim input is cheap to re-read)
+    const bool singlePass = cfg.singlePass.getVal() && skimPath.empty();
+    if (singlePass && nThreads > 1)
+      LogStrm::get() << __FILE__ << ": single pass mode is processed in single process." << endl;
 
     // open new output histogram file
     LogStrm::get() << __FILE__ << ": opening output rough pedestal histogram file: " << roughPedHistFileName <<
@@ -159,17 +212,33 @@ int main(int argc,
     PedHists roughPedHists(&roughpedHistfile);
 
 
-    LogStrm::get() << __FILE__ << ": reading root event file(s) starting w/ " << digiFileList[0] << endl;
-    roughPedAlg.fillHists(nEntries,
-                          digiFileList,
-                          NULL,
-                          roughPedHists,
-                          trigCut);
+    if (!skimPath.empty()) {
+      LogStrm::get() << __FILE__ << ": reading Cal skim file " << skimPath << endl;
+      roughPedAlg.fillHistsFromSkim(nEntries,
+                                    skimPath,
+                                    NULL,
+                                    roughPedHists,
+                                    trigCut);
+    } else if (singlePass) {
+      LogStrm::get() << __FILE__ << ": reading root event file(s) starting w/ " << digiFileList[0] << endl;
+      roughPedAlg.fillRoughHists(nEntries,
+                                 digiFileList,
+                                 roughPedHists,
+                                 trigCut);
+    } else {
+      LogStrm::get() << __FILE__ << ": reading root event file(s) starting w/ " << digiFileList[0] << endl;
+      roughPedAlg.fillHists(nEntries,
+                            digiFileList,
+                            NULL,
+                            roughPedHists,
+                            trigCut,
+                            nThreads);
+    }
     roughPedHists.trimHists();
 
     
     LogStrm::get() << __FILE__ << ": fitting rough pedestal histograms." << endl;
-    roughPedHists.fitHists(roughPed);
+    roughPedHists.fitHists(roughPed, nThreads, cfg.fastFit.getVal());
     LogStrm::get() << __FILE__ << ": writing rough pedestals: " << roughPedTXTFile << endl;
     roughPed.writeTXT(roughPedTXTFile);
     roughpedHistfile.Write();
@@ -192,16 +261,31 @@ int main(int argc,
                         "pedestals");
     PedHists calPedHists(&mupedHistfile);
     
-    LogStrm::get() << __FILE__ << ": reading root event file(s) starting w/ " << digiFileList[0] << endl;
-    calPedAlg.fillHists(nEntries,
-                        digiFileList,
-                        &roughPed,
-                        calPedHists,
-                        trigCut);
+    if (!skimPath.empty()) {
+      LogStrm::get() << __FILE__ << ": reading Cal skim file " << skimPath << endl;
+      calPedAlg.fillHistsFromSkim(nEntries,
+                                  skimPath,
+                                  &roughPed,
+                                  calPedHists,
+                                  trigCut);
+    } else if (singlePass) {
+      LogStrm::get() << __FILE__ << ": replaying buffered rough pass hits" << endl;
+      roughPedAlg.fillCutHists(nEntries,
+                               roughPed,
+                               calPedHists);
+    } else {
+      LogStrm::get() << __FILE__ << ": reading root event file(s) starting w/ " << digiFileList[0] << endl;
+      calPedAlg.fillHists(nEntries,
+                          digiFileList,
+                          &roughPed,
+                          calPedHists,
+                          trigCut,
+                          nThreads);
+    }
     calPedHists.trimHists();
     
     LogStrm::get() << __FILE__ << ": fitting pedestal histograms." << endl;
-    calPedHists.fitHists(calPed);
+    calPedHists.fitHists(calPed, nThreads, cfg.fastFit.getVal());
     
     LogStrm::get() << __FILE__ << ": writing pedestals: " << calPedTXTFile << endl;
     calPed.writeTXT(calPedTXTFile);
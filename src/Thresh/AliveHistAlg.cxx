@@ -0,0 +1,210 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "AliveHistAlg.h"
+#include "src/lib/Util/CGCUtil.h"
+
+// GLAST INCLUDES
+#include "CalUtil/CalVec.h"
+#include "CalUtil/SimpleCalCalib/CalPed.h"
+#include "digiRootData/Gem.h"
+#include "digiRootData/DigiEvent.h"
+
+// EXTLIB INCLUDES
+#include "TH2.h"
+
+// STD INCLUDES
+#include <sstream>
+#include <algorithm>
+
+namespace calibGenCAL {
+
+  using namespace CalUtil;
+  using namespace std;
+
+  AliveHistAlg::AliveHistAlg(const CalPed &peds,
+                             TDirectory *const writeDir,
+                             const unsigned nEntries) :
+    m_calPed(peds),
+    m_lex8Hists("lex8Hist",
+                writeDir, 0,
+                200, 0, 4000),
+    m_hex8Hists("hex8Hist",
+                writeDir, 0,
+                200, 0, 4000),
+    m_p2nlex8Hists("p2nlex8Hist",
+                   writeDir, 0,
+                   100, 0, 2),
+    m_p2nhex8Hists("p2nhex8Hist",
+                   writeDir, 0,
+                   100, 0, 2),
+    m_lex8Entries(nEntries)
+  {
+    for (FaceIdx faceIdx; faceIdx.isValid(); faceIdx++) {
+      m_lex8Hists.produceHist(faceIdx);
+      m_hex8Hists.produceHist(faceIdx);
+    }
+    for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++) {
+      m_p2nlex8Hists.produceHist(xtalIdx);
+      m_p2nhex8Hists.produceHist(xtalIdx);
+    }
+  }
+
+  void AliveHistAlg::getDigiBranches(vector<string> &branches) const {
+    branches.push_back("m_calDigiCloneCol");
+    branches.push_back("m_summary");
+    branches.push_back("m_gem");
+  }
+
+  bool AliveHistAlg::consumeEvent(const unsigned eventNum,
+                                  const DigiEvent &digiEvent) {
+    // quit if we have enough entries in each histogram
+    if (m_lex8Entries.targetReached())
+      return false;
+
+    //-- retrieve trigger data
+    const Gem &gem = digiEvent.getGem();
+    const unsigned gemConditionsWord = gem.getConditionSummary();
+    const float gemDeltaEventTime = gem.getDeltaEventTime()*0.05;
+    if ((gemConditionsWord & 32) != 0 || gemDeltaEventTime < 70)
+      return true;
+
+    const TClonesArray *calDigiCol = digiEvent.getCalDigiCol();
+    if (!calDigiCol) {
+      LogStrm::get() << "no calDigiCol found for event#" << eventNum << endl;
+      return true;
+    }
+
+    TIter calDigiIter(calDigiCol);
+
+    const CalDigi      *pCalDigi = 0;
+
+    while ((pCalDigi = dynamic_cast<CalDigi *>(calDigiIter.Next()))) {
+      const CalDigi &calDigi = *pCalDigi;
+      //-- XtalId --//
+      const idents::CalXtalId id(calDigi.getPackedId()); 
+
+      const XtalIdx xtalIdx(id);
+
+      const unsigned nRO = calDigi.getNumReadouts();
+
+      for (unsigned short n = 0; n < nRO; n++) {
+        const CalXtalReadout &readout = *calDigi.getXtalReadout(n);
+        RngNum rngRo[2];
+        float adcPedRo[2];
+
+        for (FaceNum face; face.isValid(); face++) {
+          const RngNum rng(readout.getRange((idents::CalXtalId::XtalFace)face.val()));
+          const unsigned short adc(readout.getAdc((idents::CalXtalId::XtalFace)face.val()));
+          const RngIdx rngIdx(xtalIdx,face,rng);
+          const FaceIdx faceIdx(xtalIdx,face);
+          const float adcPed = adc - m_calPed.getPed(rngIdx);
+          rngRo[face.val()] = rng;
+          adcPedRo[face.val()] = adcPed;
+
+          if (rng == LEX8) {
+            m_lex8Hists.produceHist(faceIdx).Fill(adcPed);
+            m_lex8Entries.count(faceIdx);
+          }
+          if (rng == HEX8)
+            m_hex8Hists.produceHist(faceIdx).Fill(adcPed);
+        }
+
+        if (rngRo[0] == rngRo[1] && adcPedRo[1] > 30) {
+          if (rngRo[0] == LEX8)
+            m_p2nlex8Hists.produceHist(xtalIdx).Fill(adcPedRo[0]/adcPedRo[1]);
+          if (rngRo[0] == HEX8)
+            m_p2nhex8Hists.produceHist(xtalIdx).Fill(adcPedRo[0]/adcPedRo[1]);
+        }
+      }
+    }
+
+    return !m_lex8Entries.targetReached();
+  }
+
+  namespace {
+    /// new per-tower summary map in current ROOT directory
+    TH2F *newTwrMap(const string &prefix,
+                    const unsigned twr,
+                    const unsigned nCols,
+                    const char *xTitle) {
+      ostringstream name;
+      name << prefix << "_twr" << twr;
+      ostringstream title;
+      title << "tower " << twr;
+
+      TH2F *const hist = new TH2F(name.str().c_str(), title.str().c_str(),
+                                  nCols, 0, 12, 8, 0, 8);
+      hist->SetMinimum(0);
+      hist->SetXTitle(xTitle);
+      hist->SetYTitle("layer");
+      return hist;
+    }
+  }
+
+  void AliveHistAlg::fillSummaryHists() {
+    CalVec<TwrNum, TH2F*> hnlex8;
+    CalVec<TwrNum, TH2F*> hnhex8;
+    CalVec<TwrNum, TH2F*> havlex8;
+    CalVec<TwrNum, TH2F*> havhex8;
+    CalVec<TwrNum, TH2F*> hp2nlex8;
+    CalVec<TwrNum, TH2F*> hp2nhex8;
+    for (TwrNum twr; twr.isValid(); twr++) {
+      hnlex8[twr]   = newTwrMap("hnlex8",   twr.val(), 24, "col+0.5*face");
+      hnhex8[twr]   = newTwrMap("hnhex8",   twr.val(), 24, "col+0.5*face");
+      havhex8[twr]  = newTwrMap("havhex8",  twr.val(), 24, "col+0.5*face");
+      havlex8[twr]  = newTwrMap("havlex8",  twr.val(), 24, "col+0.5*face");
+      hp2nlex8[twr] = newTwrMap("hp2nlex8", twr.val(), 12, "col");
+      hp2nlex8[twr]->SetMaximum(2);
+      hp2nhex8[twr] = newTwrMap("hp2nhex8", twr.val(), 12, "col");
+      hp2nhex8[twr]->SetMaximum(2);
+    }
+
+    float maxnlex8 = 0;
+    float maxnhex8 = 0;
+    float maxavlex8 = 0;
+    float maxavhex8 = 0;
+
+    for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++) {
+      const float p2nlex8 = m_p2nlex8Hists.produceHist(xtalIdx).GetMean();
+      const float p2nhex8 = m_p2nhex8Hists.produceHist(xtalIdx).GetMean();
+      const TwrNum twr = xtalIdx.getTwr();
+      const unsigned short lyr = xtalIdx.getLyr().val();
+      const unsigned short col = xtalIdx.getCol().val();
+      hp2nlex8[twr]->Fill(col,lyr,p2nlex8);
+      hp2nhex8[twr]->Fill(col,lyr,p2nhex8);
+    }
+
+    for (FaceIdx faceIdx; faceIdx.isValid(); faceIdx++) {
+      const int nlex8 = (int)m_lex8Hists.produceHist(faceIdx).GetEntries();
+      const int nhex8 = (int)m_hex8Hists.produceHist(faceIdx).GetEntries();
+      const float avlex8 = m_lex8Hists.produceHist(faceIdx).GetMean();
+      const float avhex8 = m_hex8Hists.produceHist(faceIdx).GetMean();
+      maxnlex8 = max<float>(maxnlex8, nlex8);
+      maxnhex8 = max<float>(maxnhex8, nhex8);
+      maxavlex8 = max(maxavlex8, avlex8);
+      maxavhex8 = max(maxavhex8, avhex8);
+
+      const TwrNum twr = faceIdx.getTwr();
+      const unsigned short lyr = faceIdx.getLyr().val();
+      const unsigned short col = faceIdx.getCol().val();
+      const unsigned short face = faceIdx.getFace().val();
+
+      hnlex8[twr]->Fill(col+face*0.5,lyr,nlex8);
+      hnhex8[twr]->Fill(col+face*0.5,lyr,nhex8);
+      havlex8[twr]->Fill(col+face*0.5,lyr,avlex8);
+      havhex8[twr]->Fill(col+face*0.5,lyr,avhex8);
+    }
+
+    for (TwrNum twr; twr.isValid(); twr++) {
+      hnhex8[twr]->SetMaximum(maxnhex8*1.5);
+      hnlex8[twr]->SetMaximum(maxnlex8*1.5);
+      havhex8[twr]->SetMaximum(maxavhex8*1.5);
+      havlex8[twr]->SetMaximum(maxavlex8*1.5);
+    }
+  }
+
+}; // namespace calibGenCAL
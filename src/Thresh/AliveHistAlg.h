@@ -0,0 +1,73 @@
+#ifndef AliveHistAlg_h
+#define AliveHistAlg_h
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "src/lib/Hists/TrigHists.h"
+#include "src/lib/Hists/MinEntriesTracker.h"
+#include "src/lib/Util/FusedDigiLoop.h"
+
+// GLAST INCLUDES
+#include "CalUtil/CalDefs.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <vector>
+#include <string>
+
+class TDirectory;
+class DigiEvent;
+
+namespace CalUtil {
+  class CalPed;
+};
+
+namespace calibGenCAL {
+
+  /** \brief fill LEX8 & HEX8 channel alive histograms & POS/NEG face
+      signal ratios from non-periodic triggers.
+  */
+  class AliveHistAlg : public DigiEventConsumer {
+  public:
+    /// @param writeDir output directory for all histograms
+    /// @param nEntries minimum number of entries in each LEX8 histogram before quitting
+    AliveHistAlg(const CalUtil::CalPed &peds,
+                 TDirectory *const writeDir,
+                 const unsigned nEntries);
+
+    /// DigiEventConsumer interface
+    void getDigiBranches(std::vector<std::string> &branches) const;
+
+    /// DigiEventConsumer interface
+    bool consumeEvent(const unsigned eventNum,
+                      const DigiEvent &digiEvent);
+
+    /// create per-tower summary maps of entries, means & face
+    /// ratios in current ROOT directory
+    /// \note call after event loop
+    void fillSummaryHists();
+
+  private:
+    const CalUtil::CalPed &m_calPed;
+
+    /// pedestal subtracted LEX8 adc
+    TrigHists m_lex8Hists;
+    /// pedestal subtracted HEX8 adc
+    TrigHists m_hex8Hists;
+
+    /// POS / NEG face LEX8 adc ratio
+    HistVec<CalUtil::XtalIdx, TH1S> m_p2nlex8Hists;
+    /// POS / NEG face HEX8 adc ratio
+    HistVec<CalUtil::XtalIdx, TH1S> m_p2nhex8Hists;
+
+    /// fills per m_lex8Hists channel (early stop check)
+    MinEntriesTracker<CalUtil::FaceIdx> m_lex8Entries;
+
+  }; // class AliveHistAlg
+
+}; // namespace calibGenCAL
+#endif
@@ -0,0 +1,106 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "LACHistAlg.h"
+
+// GLAST INCLUDES
+#include "CalUtil/SimpleCalCalib/CalPed.h"
+#include "CalUtil/SimpleCalCalib/ADC2NRG.h"
+#include "digiRootData/Gem.h"
+#include "digiRootData/DigiEvent.h"
+
+// EXTLIB INCLUDES
+#include "TH1I.h"
+
+// STD INCLUDES
+#include <sstream>
+
+namespace calibGenCAL {
+
+  using namespace CalUtil;
+  using namespace std;
+
+  static const unsigned MAX_DELTA_EVENT_TIME_MUS = 100;
+
+  LACHistAlg::LACHistAlg(const FaceNum face,
+                         const CalPed &peds,
+                         const ADC2NRG &adc2nrg,
+                         const unsigned maxEvents) :
+    m_face(face),
+    m_maxEvents(maxEvents),
+    m_calSignalArray(peds, adc2nrg)
+  {
+    for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++) {
+      const FaceIdx faceIdx(xtalIdx, face);
+
+      ostringstream hadcname;
+      hadcname << "hadc_" << faceIdx.toStr();
+      m_hadc[xtalIdx] = new TH1I(hadcname.str().c_str(),hadcname.str().c_str(),60,0,300);
+
+      ostringstream hpedname;
+      hpedname << "hped_" << faceIdx.toStr();
+      m_hped[xtalIdx] = new TH1I(hpedname.str().c_str(),hpedname.str().c_str(),200,-100,100);
+    }
+  }
+
+  void LACHistAlg::getDigiBranches(vector<string> &branches) const {
+    branches.push_back("m_calDigiCloneCol");
+    branches.push_back("m_summary");
+    branches.push_back("m_gem");
+  }
+
+  bool LACHistAlg::consumeEvent(const unsigned eventNum,
+                                const DigiEvent &digiEvent) {
+    if (eventNum >= m_maxEvents)
+      return false;
+
+    // read in cal digis
+    m_calSignalArray.clear();
+    m_calSignalArray.fillArray(digiEvent);
+
+    //-- retrieve trigger data
+    const Gem &gem = digiEvent.getGem();
+    const unsigned gemConditionsWord = gem.getConditionSummary();
+    const float gemDeltaEventTime = gem.getDeltaEventTime()*0.05;
+
+    CalVec<FaceNum, float> ene;
+    CalVec<FaceNum, float> adc;
+    CalVec<FaceNum, RngNum> rng;
+
+    for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++) {
+      for (FaceNum tmpFace; tmpFace.isValid(); tmpFace++) {
+        const FaceIdx faceIdx(xtalIdx, tmpFace);
+        ene[tmpFace] = m_calSignalArray.getFaceSignal(faceIdx);
+        adc[tmpFace] = m_calSignalArray.getAdcPed(faceIdx);
+        rng[tmpFace] = m_calSignalArray.getAdcRng(faceIdx);
+      }
+
+      /// skip any events w/ gemDeltaEventTime < 500 muS
+      if (gemDeltaEventTime < MAX_DELTA_EVENT_TIME_MUS)
+        continue;
+
+      /// avoid periodic triggers (pedestals)
+      if(!gem.getPeriodicSet()){
+        if(rng[POS_FACE] == LEX8 && rng[NEG_FACE] == LEX8 && 
+           adc[POS_FACE]>3 && adc[NEG_FACE]>3 && 
+           adc[POS_FACE]<350 && adc[NEG_FACE]<350) {
+          /// skip direct deposit hits by comparing asymmetry between xtal faces
+          const FaceNum oppFace(m_face.oppositeFace());
+          /// 'healthy assymmetry maxes around 2:1, so we'll cut anything above 3:1
+          if (ene[m_face] / ene[oppFace] < 3)
+            m_hadc[xtalIdx]->Fill(adc[m_face]); 
+        }
+      }
+        
+      /// select periodic (only) triggers for pedestals
+      if(gemConditionsWord == enums::PERIODIC)
+        m_hped[xtalIdx]->Fill(adc[m_face]); 
+    }
+
+    return eventNum + 1 < m_maxEvents;
+  }
+
+}; // namespace calibGenCAL
@@ -0,0 +1,69 @@
+#ifndef LACHistAlg_h
+#define LACHistAlg_h
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "src/lib/Util/CalSignalArray.h"
+#include "src/lib/Util/FusedDigiLoop.h"
+
+// GLAST INCLUDES
+#include "CalUtil/CalDefs.h"
+#include "CalUtil/CalVec.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <vector>
+#include <string>
+
+class TH1I;
+class DigiEvent;
+
+namespace CalUtil {
+  class CalPed;
+  class ADC2NRG;
+};
+
+namespace calibGenCAL {
+
+  /** \brief fill LAC threshold & pedestal histograms for single
+      crystal face from zero suppressed data.
+  */
+  class LACHistAlg : public DigiEventConsumer {
+  public:
+    /// histograms are created in current ROOT directory
+    /// @param face which xtal face to process
+    /// @param maxEvents process at most this many input events
+    LACHistAlg(const CalUtil::FaceNum face,
+               const CalUtil::CalPed &peds,
+               const CalUtil::ADC2NRG &adc2nrg,
+               const unsigned maxEvents);
+
+    /// DigiEventConsumer interface
+    void getDigiBranches(std::vector<std::string> &branches) const;
+
+    /// DigiEventConsumer interface
+    bool consumeEvent(const unsigned eventNum,
+                      const DigiEvent &digiEvent);
+
+  private:
+    const CalUtil::FaceNum m_face;
+
+    const unsigned m_maxEvents;
+
+    /// store cal signal levels for each channel
+    CalSignalArray m_calSignalArray;
+
+    /// LAC threshold histograms (non-periodic triggers)
+    CalUtil::CalVec<CalUtil::XtalIdx, TH1I*> m_hadc;
+
+    /// pedestal histograms (periodic triggers)
+    CalUtil::CalVec<CalUtil::XtalIdx, TH1I*> m_hped;
+
+  }; // class LACHistAlg
+
+}; // namespace calibGenCAL
+#endif
@@ -28,7 +28,6 @@ namespace CalUtil {
 };
 
 namespace calibGenCAL {
-  class RootFileAnalysis;
 
   /** \brief Algorithm class fill & fit FHE Trigger threshold histograms.
       @author Zachary Fewtrell
@@ -50,12 +49,6 @@ namespace calibGenCAL {
       LPATrigAlg(trigPattern, peds, adc2nrg, specHists, trigHists, expectedThresh, safetyMargin)
     {}
 
-    /// Fill histograms w/ nEvt event data
-    /// @param nEntrries minimum number of entries in each histogram before quitting
-    /// @param digiFileList list of digi files to process
-    void fillHists(const unsigned nEntries,
-                   const std::vector<std::string> &digiFileList);
-
   private:
     void processEvent(const DigiEvent &digiEvent);
 
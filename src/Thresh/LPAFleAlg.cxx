@@ -5,7 +5,6 @@
 */
 
 // LOCAL INCLUDES
-#include "src/lib/Util/RootFileAnalysis.h"
 #include "LPAFleAlg.h"
 #include "src/lib/Util/ROOTUtil.h"
 #include "src/lib/Util/CGCUtil.h"
@@ -35,54 +34,6 @@ namespace calibGenCAL {
   using namespace CalUtil;
   using namespace std;
 
-  void LPAFleAlg::fillHists(const unsigned nEntries,
-                            const std::vector<std::string> &digiFileList) {
-
-    /////////////////////////////////////////
-    /// Open ROOT Event File  ///////////////
-    /////////////////////////////////////////
-    RootFileAnalysis rootFile(0,             // mc
-                              &digiFileList);
-
-    // configure active branches from input ROOT trees
-    cfgBranches(rootFile);
-
-
-    const unsigned nEvents = rootFile.getEntries();
-    LogStrm::get() << __FILE__ << ": Processing: " << nEvents << " events." << endl;
-
-    /////////////////////////////////////////
-    /// Event Loop //////////////////////////
-    /////////////////////////////////////////
-    for (eventData.init(); eventData.m_eventNum < nEvents; eventData.nextEvent()) {
-      /////////////////////////////////////////
-      /// Load new event //////////////////////
-      /////////////////////////////////////////
-      if (eventData.m_eventNum % 2000 == 0) {
-        // quit if we have enough entries in each histogram
-        const unsigned currentMin = m_trigHists.getMinEntries();
-        if (currentMin >= nEntries) break;
-        LogStrm::get() << "Event: " << eventData.m_eventNum
-                       << " min entries per histogram: " << currentMin
-                       << endl;
-        LogStrm::get().flush();
-      }
-
-      if (!rootFile.getEvent(eventData.m_eventNum)) {
-        LogStrm::get() << "Warning, event " << eventData.m_eventNum << " not read." << endl;
-        continue;
-      }
-
-      DigiEvent const*const digiEvent = rootFile.getDigiEvent();
-      if (!digiEvent) {
-        LogStrm::get() << __FILE__ << ": Unable to read DigiEvent " << eventData.m_eventNum  << endl;
-        continue;
-      }
-
-      processEvent(*digiEvent);
-    }
-  }
-
   /// check that layer matches expected configuration (mostly that we're
   /// not triggering on the wrong columns
   bool LPAFleAlg::checkLyr(const LyrIdx lyrIdx, const FaceNum face) {
@@ -199,6 +150,7 @@ namespace calibGenCAL {
     
     /// FILL 2: trigger histogram
     m_trigHists.produceHist(faceIdx).Fill(faceSignal);
+    m_trigEntries.count(faceIdx);
   }
 
   bool LPAFleAlg::channelEnabled(const FaceIdx faceIdx) {
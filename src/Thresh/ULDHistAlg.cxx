@@ -0,0 +1,95 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "ULDHistAlg.h"
+
+// GLAST INCLUDES
+#include "digiRootData/DigiEvent.h"
+
+// EXTLIB INCLUDES
+#include "TH1S.h"
+
+// STD INCLUDES
+#include <sstream>
+#include <stdexcept>
+
+namespace calibGenCAL {
+
+  using namespace CalUtil;
+  using namespace std;
+
+  // CONSTANTS
+  namespace {
+    static const unsigned short ULDHIST_MIN_ADC = 3095;
+    static const unsigned short ULDHIST_MAX_ADC = 4095;
+    static const unsigned short ULDHIST_N_BINS = 100;
+  }
+
+  ULDHistAlg::ULDHistAlg(const unsigned maxEvents) :
+    m_maxEvents(maxEvents)
+  {
+    // create ULD threshold histograms, one per range (skip HEX1)
+    for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
+      if (rngIdx.getRng() == HEX1)
+        continue;
+      ostringstream histname;
+      histname << "uld_" << rngIdx.toStr();
+
+      m_uldHist[rngIdx] = new TH1S(histname.str().c_str(),
+                                   histname.str().c_str(),
+                                   ULDHIST_N_BINS,
+                                   ULDHIST_MIN_ADC,
+                                   ULDHIST_MAX_ADC);
+    }
+  }
+
+  void ULDHistAlg::fillReadout(const XtalIdx xtalIdx,
+                               const FaceNum face,
+                               const RngNum rng,
+                               const unsigned short adc) {
+    if (rng == HEX1)
+      return;
+
+    if (adc > ULDHIST_MIN_ADC) {
+      const RngIdx rngIdx(xtalIdx, face, rng);
+      m_uldHist[rngIdx]->Fill(adc);
+    }
+  }
+
+  void ULDHistAlg::getDigiBranches(vector<string> &branches) const {
+    branches.push_back("m_calDigiCloneCol");
+  }
+
+  bool ULDHistAlg::consumeEvent(const unsigned eventNum,
+                                const DigiEvent &digiEvent) {
+    if (eventNum >= m_maxEvents)
+      return false;
+
+    //-- loop through each 'hit' in one event --//
+    const TClonesArray *calDigiCol = digiEvent.getCalDigiCol();
+    if (!calDigiCol)
+      throw runtime_error("no calDigiCol found.");
+
+    TIter calDigiIter(calDigiCol);
+    const CalDigi      *pCalDigi = 0;
+    while ((pCalDigi = dynamic_cast<CalDigi *>(calDigiIter.Next()))) {
+      const     CalDigi &calDigi = *pCalDigi;    // use reference to avoid -> syntax
+      //-- XtalId --//
+      const idents::CalXtalId id(calDigi.getPackedId());   // get interaction information
+      const XtalIdx xtalIdx(id);
+
+      // first readout only
+      for (FaceNum face; face.isValid(); face++) {
+        const RngNum rng(calDigi.getRange(0, (idents::CalXtalId::XtalFace)face.val()));
+        const unsigned short adc(calDigi.getAdc(0, (idents::CalXtalId::XtalFace)face.val()));
+        fillReadout(xtalIdx, face, rng, adc);
+      }
+    }
+
+    return eventNum + 1 < m_maxEvents;
+  }
+
+}; // namespace calibGenCAL
@@ -0,0 +1,57 @@
+#ifndef ULDHistAlg_h
+#define ULDHistAlg_h
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "src/lib/Util/FusedDigiLoop.h"
+
+// GLAST INCLUDES
+#include "CalUtil/CalDefs.h"
+#include "CalUtil/CalVec.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <vector>
+#include <string>
+
+class TH1S;
+class DigiEvent;
+
+namespace calibGenCAL {
+
+  /** \brief fill ULD threshold histograms (non pedestal subtracted
+      adc) from first readout of best-range-first LPA data.
+  */
+  class ULDHistAlg : public DigiEventConsumer {
+  public:
+    /// histograms are created in current ROOT directory
+    /// @param maxEvents process at most this many input events
+    explicit ULDHistAlg(const unsigned maxEvents);
+
+    /// fill ULD histogram w/ single readout (HEX1 & adc below hist range are skipped)
+    void fillReadout(const CalUtil::XtalIdx xtalIdx,
+                     const CalUtil::FaceNum face,
+                     const CalUtil::RngNum rng,
+                     const unsigned short adc);
+
+    /// DigiEventConsumer interface
+    void getDigiBranches(std::vector<std::string> &branches) const;
+
+    /// DigiEventConsumer interface
+    bool consumeEvent(const unsigned eventNum,
+                      const DigiEvent &digiEvent);
+
+  private:
+    const unsigned m_maxEvents;
+
+    /// one histogram per range (HEX1 is NULL)
+    CalUtil::CalVec<CalUtil::RngIdx, TH1S*> m_uldHist;
+
+  }; // class ULDHistAlg
+
+}; // namespace calibGenCAL
+#endif
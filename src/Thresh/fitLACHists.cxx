@@ -10,6 +10,7 @@
 #include "src/lib/Util/CfgMgr.h"
 #include "src/lib/Util/string_util.h"
 #include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/ChannelFitExecutor.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
@@ -19,15 +20,15 @@
 #include "TFile.h"
 #include "TNtuple.h"
 #include "TH1I.h"
-#include "TCanvas.h"
-#include "TGraph.h"
 #include "TF1.h"
+#include "TROOT.h"
 
 
 // STD INCLUDES
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <vector>
 
 using namespace std;
 using namespace CfgMgr;
@@ -50,6 +51,10 @@ public:
     outputBasename("outputBasename",
                    "all output files will use this basename + some_ext",
                    ""),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
     help("help",
          'h',
          "print usage info")
@@ -57,6 +62,7 @@ public:
     cmdParser.registerArg(histFilePath);
     cmdParser.registerArg(adc2nrgFilename);
     cmdParser.registerArg(outputBasename);
+    cmdParser.registerVar(nFitWorkers);
     cmdParser.registerSwitch(help);
 
     try {
@@ -81,6 +87,8 @@ public:
 
   CmdArg<string> outputBasename;
 
+  CmdOptVar<unsigned> nFitWorkers;
+
   /// print usage string
   CmdSwitch help;
 
@@ -89,318 +97,396 @@ public:
 /// percent of max histogram hieght required for first significant bin
 static const float FIRSTBIN_FRAC_MAX = 0.15;
 
-int main(const int argc, const char **argv) {
-  // libCalibGenCAL will throw runtime_error
-  try {
-    AppCfg cfg(argc,argv);
-
-    //-- SETUP LOG FILE --//
-    /// multiplexing output streams
-    /// simultaneously to cout and to logfile
-    LogStrm::addStream(cout);
-
-    // generate logfile name
-    const string logfile(cfg.outputBasename.getVal() + ".lac_fit.log.txt");
-    ofstream tmpStrm(logfile.c_str());
-    LogStrm::addStream(tmpStrm);
-
-    string outputTXTPath(cfg.outputBasename.getVal() + ".lac_fit.txt");
-  
-    LogStrm::get() << __FILE__ << ": opening output TXT file: " << outputTXTPath << endl;
-    ofstream outfile(outputTXTPath.c_str());
-    /// print column headers
-    outfile << ";twr lyr col face lac errlac pedDrift lacMeV errlacMeV" << endl;
-    LogStrm::get() << ";twr lyr col face lac errlac pedDrift lacMeV fitstat chi2 mev_slope mev_offset" << endl;
-
-    // open input files
-    ADC2NRG adc2nrg;
-    LogStrm::get() << __FILE__ << ": calib file: " << cfg.adc2nrgFilename.getVal() << endl;
-    adc2nrg.readTXT(cfg.adc2nrgFilename.getVal());
-
-    // open output files
-    LogStrm::get() << __FILE__ << ": opening output histogram file: " << cfg.histFilePath.getVal() << endl;
-    TFile fhist(cfg.histFilePath.getVal().c_str(),"UPDATE");
-    TNtuple* ntp = 
-      new TNtuple("lacadcntp","lacadcntp",
-                  "twr:lyr:col:face:lac:errlac:pedDrift:lacMeV:errlacMeV:bkg0:bkg_steepness:chi2:nent:fitstat");
-
-    TCanvas*  canv = new TCanvas("canv","canv",100,100,600,600);
-    int ipad=0;
-    int npad=4;
-    canv->Divide(2,2);
-
+/// LAC fit functions
+typedef enum {
+  /// first bin above pedestal, signal + background
+  LACFIT_SIGNAL = 1,
+  /// threshold between pedDrift & pedDrift+2*pedSigma, signal + background + pedestal
+  LACFIT_PED_TAIL,
+  /// threshold below pedDrift, pedestal only
+  LACFIT_PED
+} LACFIT_CASE;
+
+/// new LAC threshold fit function w/ parameter names for given fit case
+TF1 *newLACFunc(const string &name,
+                const LACFIT_CASE fitCase) {
+  TF1 *fun = 0;
+  switch (fitCase) {
+  case LACFIT_SIGNAL:
+    fun = new TF1(name.c_str(),
+                  "([2]/x+[3])/(1+exp(([0]-x)/[1]))", -50, 300);
+    fun->SetParName(0,"lac threhsold");
+    fun->SetParName(1,"threshold width");
+    fun->SetParName(2,"bkg steepness");
+    fun->SetParName(3,"bkg constant");
+    break;
+  case LACFIT_PED_TAIL:
+    fun = new TF1(name.c_str(),
+                  "(gaus+([5]/x+[6]))/(1+exp(([3]-x)/[4]))", 0, 300);
+    fun->SetParName(3,"lac threhsold");
+    fun->SetParName(4,"threshold width");
+    fun->SetParName(5,"bkg steepness");
+    fun->SetParName(6,"bkg constant");
+    break;
+  case LACFIT_PED:
+    fun = new TF1(name.c_str(),
+                  "gaus/(1+exp(([3]-x)/[4]))", 0, 300);
+    fun->SetParName(3,"lac threhsold");
+    fun->SetParName(4,"threshold width");
+    break;
+  default:
+    throw std::runtime_error("Invalid LAC fit condition.");
+  }
 
-    TH1I* hadc;
-    TH1I* hped;
+  fun->SetNpx(500);
+  return fun;
+}
 
-    float pedSigma=0;
-    float pedDrift=0;
-  
+/// fit LAC histogram for each crystal face (see ChannelFitExecutor)
+class LACFitter : public ChannelFitter {
+public:
+  LACFitter(TFile &fhist,
+            const ADC2NRG &adc2nrg,
+            ostream &outfile,
+            TNtuple &ntp) :
+    m_fhist(fhist),
+    m_adc2nrg(adc2nrg),
+    m_outfile(outfile),
+    m_ntp(ntp),
+    m_gaus(*(TF1*)gROOT->GetFunction("gaus"))
+  {
     for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++)
       for (FaceNum face; face.isValid(); face++) {
         const FaceIdx faceIdx(xtalIdx, face);
 
         ostringstream hadcname;
         hadcname << "hadc_" << faceIdx.toStr();
-        hadc = (TH1I*)fhist.Get(hadcname.str().c_str());
+        TH1I *const hadc = (TH1I*)fhist.Get(hadcname.str().c_str());
         /// skip missing channels
         if (!hadc)
           continue;
 
         ostringstream hpedname;
         hpedname << "hped_" << faceIdx.toStr();
-        hped = (TH1I*)fhist.Get(hpedname.str().c_str());
+        TH1I *const hped = (TH1I*)fhist.Get(hpedname.str().c_str());
 
-        ostringstream lacfitname;
-        lacfitname << "lacfit_" << faceIdx.toStr();
+        m_faceIdx.push_back(faceIdx);
+        m_hadc.push_back(hadc);
+        m_hped.push_back(hped);
+      }
+  }
 
-        ostringstream hrbname;
-        hrbname << "hrbadc_" << faceIdx.toStr();
-                        
-        ostringstream lacrbfitname;
-        lacrbfitname << "lacrbfit_" << faceIdx.toStr();
-
-        canv->cd(1+(ipad%npad));
-        ipad++;
-                                
-        canv->cd(1+(ipad%npad));
-        ipad++;
-
-        hped->Fit("gaus","Q");
-        pedSigma = hped->GetFunction("gaus")->GetParameter(2);
-        pedDrift = hped->GetFunction("gaus")->GetParameter(1);
-
-        //-- PHASE 1: FIND THRESHOLD IN REBINNED HISTOGRAM --//
-        //-- get 'fist pass' estimates @ fitting parms
-        TF1* funrb = new TF1(lacrbfitname.str().c_str(),
-                             "([2]/x+[3])/(1+exp(([0]-x)/[1]))", -50, 300);
-        funrb->SetNpx(500);
-        funrb->SetParName(0, "lac threhsold");
-        funrb->SetParName(1, "threshold width");
-        funrb->SetParName(2, "bkg steepness");
-        funrb->SetParName(3, "bkg constant");
-
-        TH1I* h = hadc;
-        canv->cd(1+(ipad%npad));
-        ipad++;
-
-        // original binning was 5 adc units, rebinned should be 20 adc units per bin.
-        TH1I* hrebin = (TH1I*)h->Rebin(4,hrbname.str().c_str());
-        hrebin->SetTitle(hrbname.str().c_str());
+  unsigned nChannels() const {
+    return m_hadc.size();
+  }
+
+  /// results: fit case, fit status, packed pedestal, rebinned & final
+  /// threshold functions
+  bool fitChannel(const unsigned channel,
+                  vector<double> &results) {
+    const FaceIdx faceIdx = m_faceIdx[channel];
+    TH1I *const h = m_hadc[channel];
+    TH1I *const hped = m_hped[channel];
+
+    hped->Fit("gaus","Q");
+    const float pedSigma = hped->GetFunction("gaus")->GetParameter(2);
+    const float pedDrift = hped->GetFunction("gaus")->GetParameter(1);
+
+    //-- PHASE 1: FIND THRESHOLD IN REBINNED HISTOGRAM --//
+    //-- get 'fist pass' estimates @ fitting parms
+    TF1 *const funrb = newLACFunc(rebinFuncName(faceIdx), LACFIT_SIGNAL);
+
+    TH1I *const hrebin = rebin(channel);
         
-        /// LAC threshold is usually near the highest bin
-        const int mbin = hrebin->GetMaximumBin();
-        float lac_thresh = hrebin->GetBinCenter(mbin);
+    /// LAC threshold is usually near the highest bin
+    const int mbin = hrebin->GetMaximumBin();
+    float lac_thresh = hrebin->GetBinCenter(mbin);
                         
-        /// bkg constant will usually be close to level of last bin
-        const unsigned short lastBinRB = hrebin->GetNbinsX()-1;
-        float bkg_constant = hrebin->GetBinContent(lastBinRB);
-        // bin 10 should be 200 ADC, or about 6.5 MeV, 
-        float bkg_steepness = ((hrebin->GetBinContent(10))-bkg_constant)/(1.0/10 - 1.0/lastBinRB);
-
-        funrb->SetParameters(lac_thresh,
-                             1.0,
-                             bkg_steepness,
-                             bkg_constant);
-        // lac threshold (should be near rebinned threshold (30 adc = 1mev))
-        funrb->SetParLimits(0, lac_thresh-30, lac_thresh+30);
-
-        // thresh width
-        funrb->FixParameter(1, 1.0);
-
-        // background steepness
-        funrb->SetParLimits(2,   0, hrebin->GetEntries()*300);
-        
-        // bkg constant
-        funrb->SetParLimits(3, 0, hrebin->GetEntries());
-
-        hrebin->Fit(lacrbfitname.str().c_str(),"RLQ");
-        // since we rebineed by factor 4, constants will be four times smaller under default binning.
-        bkg_constant = funrb->GetParameter(3)*0.25;
-        bkg_steepness = funrb->GetParameter(2)*0.25;
-
-        canv->cd(1+(ipad%npad));
-        ipad++;
-
-        //-- PHASE 2: FIND precise THRESHOLD WITH NORMAL BINNING --//
-
-        //Decalration of variable
-        float fitstat, lac,errlac,chi2,nent;
-
-        // Look for the first bin w/ significant height (15% of max) in LEX8 histogram
-        float FirstBin=0;
-        int ibin=0;
-
-        const float maxHeight = h->GetMaximum();
-        const float maxBinCtr = h->GetBinCenter(h->GetMaximumBin());
-        while (ibin < h->GetEntries()){
-          if (h->GetBinContent(ibin) > FIRSTBIN_FRAC_MAX*maxHeight) {
-            FirstBin = h->GetBinWidth(ibin)*(ibin-1.);
-            break;
-          }
-          ibin++;
-        }
-
-        //CASE 1
-        // firstbin is > pedDrift+2*pedSigma
-        if (FirstBin > pedDrift+2*pedSigma) { 
-          TF1* fun = new TF1(lacfitname.str().c_str(),
-                             "([2]/x+[3])/(1+exp(([0]-x)/[1]))", -50, 300);
-
-          fun->SetNpx(500);
-          fun->SetParName(0,"lac threhsold");
-          fun->SetParName(1,"threshold width");
-          fun->SetParName(2,"bkg steepness");
-          fun->SetParName(3,"bkg constant");
-
-          fun->SetParameters(lac_thresh,
-                             1.0,
-                             bkg_steepness,
-                             bkg_constant);
-
-          // lac threshold
-          fun->SetParLimits(0, FirstBin-10, 300);
-
-          // thresh width
-          fun->FixParameter(1, 1.0);
-
-          // background steepness
-          fun->SetParLimits(2,   0, maxHeight*maxBinCtr);
+    /// bkg constant will usually be close to level of last bin
+    const unsigned short lastBinRB = hrebin->GetNbinsX()-1;
+    float bkg_constant = hrebin->GetBinContent(lastBinRB);
+    // bin 10 should be 200 ADC, or about 6.5 MeV, 
+    float bkg_steepness = ((hrebin->GetBinContent(10))-bkg_constant)/(1.0/10 - 1.0/lastBinRB);
+
+    funrb->SetParameters(lac_thresh,
+                         1.0,
+                         bkg_steepness,
+                         bkg_constant);
+    // lac threshold (should be near rebinned threshold (30 adc = 1mev))
+    funrb->SetParLimits(0, lac_thresh-30, lac_thresh+30);
+
+    // thresh width
+    funrb->FixParameter(1, 1.0);
+
+    // background steepness
+    funrb->SetParLimits(2,   0, hrebin->GetEntries()*300);
         
-          // bkg constant
-          fun->SetParLimits(3, 0, maxHeight);
-
-          fitstat = h->Fit(lacfitname.str().c_str(),"RLQ");
-
-          lac = fun->GetParameter(0);
-          errlac = fun->GetParError(0);
-          chi2 = fun->GetChisquare();
-          nent = h->GetEntries();
-          bkg_steepness = fun->GetParameter(2);
-          bkg_constant = fun->GetParameter(3);
-        }
-
-
-        // CASE 2
-        // The LAC value is between pedDrift and pedDrift+2.*pedSigma
-        // the new fun is (fsigna+gauss)*feff
-
-        else if (FirstBin < pedDrift+2.*pedSigma && FirstBin > pedDrift ) {
-          float Rmax = pedDrift+4.*pedSigma;
-          TF1* fun = new TF1(lacfitname.str().c_str(),
-                             "(gaus+([5]/x+[6]))/(1+exp(([3]-x)/[4]))", 0, 300);
-          fun->SetNpx(500);
-          fun->SetParName(3,"lac threhsold");
-          fun->SetParName(4,"threshold width");
-          fun->SetParName(5,"bkg steepness");
-          fun->SetParName(6,"bkg constant");
-
-          fun->SetParameters(1.0,
-                             1.0,
-                             1.0,
-                             Rmax,
-                             1.0,
-                             bkg_steepness,
-                             bkg_constant);
-
-          //Fix the parameter og the gaussian equal to the parameter of the pedestal
-          fun->FixParameter(1, pedDrift);
-          fun->FixParameter(2, pedSigma);
-
-          // lac threshold
-          fun->SetParLimits(3, FirstBin*0.8, FirstBin*2);
-
-          // thresh width
-          fun->FixParameter(4, 1.0);
-
-          // background steepness
-          fun->SetParLimits(5,   0, maxHeight*maxBinCtr);
+    // bkg constant
+    funrb->SetParLimits(3, 0, hrebin->GetEntries());
+
+    hrebin->Fit(funrb,"RLQ");
+    // since we rebineed by factor 4, constants will be four times smaller under default binning.
+    bkg_constant = funrb->GetParameter(3)*0.25;
+    bkg_steepness = funrb->GetParameter(2)*0.25;
+
+    //-- PHASE 2: FIND precise THRESHOLD WITH NORMAL BINNING --//
+
+    // Look for the first bin w/ significant height (15% of max) in LEX8 histogram
+    float FirstBin=0;
+    int ibin=0;
+
+    const float maxHeight = h->GetMaximum();
+    const float maxBinCtr = h->GetBinCenter(h->GetMaximumBin());
+    while (ibin < h->GetEntries()){
+      if (h->GetBinContent(ibin) > FIRSTBIN_FRAC_MAX*maxHeight) {
+        FirstBin = h->GetBinWidth(ibin)*(ibin-1.);
+        break;
+      }
+      ibin++;
+    }
+
+    LACFIT_CASE fitCase;
+    TF1 *fun = 0;
+    float fitstat;
+
+    //CASE 1
+    // firstbin is > pedDrift+2*pedSigma
+    if (FirstBin > pedDrift+2*pedSigma) { 
+      fitCase = LACFIT_SIGNAL;
+      fun = newLACFunc(fitFuncName(faceIdx), fitCase);
+
+      fun->SetParameters(lac_thresh,
+                         1.0,
+                         bkg_steepness,
+                         bkg_constant);
+
+      // lac threshold
+      fun->SetParLimits(0, FirstBin-10, 300);
+
+      // thresh width
+      fun->FixParameter(1, 1.0);
+
+      // background steepness
+      fun->SetParLimits(2,   0, maxHeight*maxBinCtr);
         
-          // bkg constant
-          fun->SetParLimits(6, 0, maxHeight);
+      // bkg constant
+      fun->SetParLimits(3, 0, maxHeight);
 
-          fitstat = h->Fit(lacfitname.str().c_str(),"RLQ");
+      fitstat = h->Fit(fun,"RLQ");
+    }
+
+
+    // CASE 2
+    // The LAC value is between pedDrift and pedDrift+2.*pedSigma
+    // the new fun is (fsigna+gauss)*feff
+
+    else if (FirstBin < pedDrift+2.*pedSigma && FirstBin > pedDrift ) {
+      float Rmax = pedDrift+4.*pedSigma;
+      fitCase = LACFIT_PED_TAIL;
+      fun = newLACFunc(fitFuncName(faceIdx), fitCase);
 
-          lac = fun->GetParameter(3);
+      fun->SetParameters(1.0,
+                         1.0,
+                         1.0,
+                         Rmax,
+                         1.0,
+                         bkg_steepness,
+                         bkg_constant);
 
-          errlac = fun->GetParError(3);
-          chi2 = fun->GetChisquare();
-          nent = h->GetEntries();
-          bkg_steepness = fun->GetParameter(5);
-          bkg_constant = fun->GetParameter(6);
+      //Fix the parameter og the gaussian equal to the parameter of the pedestal
+      fun->FixParameter(1, pedDrift);
+      fun->FixParameter(2, pedSigma);
 
-        }
+      // lac threshold
+      fun->SetParLimits(3, FirstBin*0.8, FirstBin*2);
 
-        // CASE 3
-        // LAC value is below pedDrift
-        // new fun is gauss*feff
+      // thresh width
+      fun->FixParameter(4, 1.0);
+
+      // background steepness
+      fun->SetParLimits(5,   0, maxHeight*maxBinCtr);
         
-        else if (FirstBin < pedDrift) {
-          float Rmax = pedDrift+3.*pedSigma;
-          TF1* fun = new TF1(lacfitname.str().c_str(),
-                             "gaus/(1+exp(([3]-x)/[4]))", FirstBin, Rmax);
+      // bkg constant
+      fun->SetParLimits(6, 0, maxHeight);
 
-          fun->SetNpx(500);
-          fun->SetParName(3,"lac threhsold");
-          fun->SetParName(4,"threshold width");
+      fitstat = h->Fit(fun,"RLQ");
+    }
 
-          fun->SetParameters(1.0,
-                             1.0,
-                             1.0,
-                             Rmax,
-                             1.0);
+    // CASE 3
+    // LAC value is below pedDrift
+    // new fun is gauss*feff
+        
+    else if (FirstBin < pedDrift) {
+      float Rmax = pedDrift+3.*pedSigma;
+      fitCase = LACFIT_PED;
+      fun = newLACFunc(fitFuncName(faceIdx), fitCase);
+      fun->SetRange(FirstBin, Rmax);
 
-          //Fix the parameter og the gaussian equal to the parameter of the pedestal
-          fun->FixParameter(1, pedDrift);
-          fun->FixParameter(2, pedSigma);
+      fun->SetParameters(1.0,
+                         1.0,
+                         1.0,
+                         Rmax,
+                         1.0);
 
-          // lac threshold
-          fun->SetParLimits(3, FirstBin, Rmax);
+      //Fix the parameter og the gaussian equal to the parameter of the pedestal
+      fun->FixParameter(1, pedDrift);
+      fun->FixParameter(2, pedSigma);
 
-          // thresh width
-          fun->FixParameter(4, 1.0);
+      // lac threshold
+      fun->SetParLimits(3, FirstBin, Rmax);
 
-          fitstat = h->Fit(lacfitname.str().c_str(),"RLQ","",0,Rmax);
+      // thresh width
+      fun->FixParameter(4, 1.0);
 
-          lac = fun->GetParameter(3);
-          errlac = fun->GetParError(3);
-          chi2 = fun->GetChisquare();
-          nent = h->GetEntries();
-          bkg_steepness = 0.;
-          bkg_constant = 0.;
-        } 
+      fitstat = h->Fit(fun,"RLQ","",0,Rmax);
+    } 
 
-        else {
-          throw std::runtime_error("Invalid LAC fit condition.");
-        }
+    else {
+      throw std::runtime_error("Invalid LAC fit condition.");
+    }
 
+    results.push_back(fitCase);
+    results.push_back(fitstat);
+    ChannelFitExecutor::packFitFunc((TF1&)*hped->GetFunction("gaus"), results);
+    ChannelFitExecutor::packFitFunc(*funrb, results);
+    ChannelFitExecutor::packFitFunc(*fun, results);
 
-        // END DAVID SANCHEZ'S PATCH
-        ///////////////////////////////////////////////////////////////////////////////////
+    delete funrb;
+    delete fun;
+    return true;
+  }
 
-        const float lacMeV = (lac-pedDrift)*adc2nrg.getADC2NRG(RngIdx(faceIdx,LEX8));
-        const float errlacMeV = errlac*lacMeV/(lac-pedDrift);
-        const float mev_slope = adc2nrg.getADC2NRG(RngIdx(faceIdx, LEX8));
-        const float mev_offset = 0;
+  void storeResults(const unsigned channel,
+                    const vector<double> &results) {
+    const FaceIdx faceIdx = m_faceIdx[channel];
+    TH1I &h = *m_hadc[channel];
+    TH1I &hped = *m_hped[channel];
+
+    const LACFIT_CASE fitCase = (LACFIT_CASE)results[0];
+    const float fitstat = results[1];
+
+    /// restore fit functions on pedestal, rebinned & LAC histograms
+    unsigned pos = ChannelFitExecutor::attachFitFunc(hped, m_gaus, results, 2);
+    const float pedDrift = hped.GetFunction("gaus")->GetParameter(1);
+
+    TF1 *const funrb = newLACFunc(rebinFuncName(faceIdx), LACFIT_SIGNAL);
+    pos = ChannelFitExecutor::attachFitFunc(*rebin(channel), *funrb, results, pos);
+    delete funrb;
+
+    TF1 *const proto = newLACFunc(fitFuncName(faceIdx), fitCase);
+    ChannelFitExecutor::attachFitFunc(h, *proto, results, pos);
+    delete proto;
+
+    const TF1 &fun = *h.GetFunction(fitFuncName(faceIdx).c_str());
+    const unsigned short lacPar = (fitCase == LACFIT_SIGNAL) ? 0 : 3;
+    const float lac = fun.GetParameter(lacPar);
+    const float errlac = fun.GetParError(lacPar);
+    const float chi2 = fun.GetChisquare();
+    const float nent = h.GetEntries();
+    float bkg_steepness = 0.;
+    float bkg_constant = 0.;
+    if (fitCase == LACFIT_SIGNAL) {
+      bkg_steepness = fun.GetParameter(2);
+      bkg_constant = fun.GetParameter(3);
+    } else if (fitCase == LACFIT_PED_TAIL) {
+      bkg_steepness = fun.GetParameter(5);
+      bkg_constant = fun.GetParameter(6);
+    }
 
-        const unsigned short twr = faceIdx.getTwr().val();
-        const unsigned short lyr = faceIdx.getLyr().val();
-        const unsigned short col = faceIdx.getCol().val();
+    const float lacMeV = (lac-pedDrift)*m_adc2nrg.getADC2NRG(RngIdx(faceIdx,LEX8));
+    const float errlacMeV = errlac*lacMeV/(lac-pedDrift);
+    const float mev_slope = m_adc2nrg.getADC2NRG(RngIdx(faceIdx, LEX8));
+    const float mev_offset = 0;
 
-        LogStrm::get() << twr << " " << lyr << " " << col << " " << face << " "
-                       << lac << " " << errlac << " " << pedDrift << " " 
-                       << lacMeV << " " << fitstat << " " << chi2 << " " 
-                       << mev_slope << " " << mev_offset << " " 
-                       << endl;
+    const unsigned short twr = faceIdx.getTwr().val();
+    const unsigned short lyr = faceIdx.getLyr().val();
+    const unsigned short col = faceIdx.getCol().val();
+    const unsigned short face = faceIdx.getFace().val();
 
-        ntp->Fill(twr,lyr,col,face,lac,errlac,pedDrift,lacMeV,errlacMeV,bkg_constant,bkg_steepness,chi2,nent,fitstat);
+    LogStrm::get() << twr << " " << lyr << " " << col << " " << face << " "
+                   << lac << " " << errlac << " " << pedDrift << " " 
+                   << lacMeV << " " << fitstat << " " << chi2 << " " 
+                   << mev_slope << " " << mev_offset << " " 
+                   << endl;
 
-        outfile << twr << " " << lyr << " " << col << " " << face << " " << lacMeV << " " << errlacMeV << endl;
+    m_ntp.Fill(twr,lyr,col,face,lac,errlac,pedDrift,lacMeV,errlacMeV,bkg_constant,bkg_steepness,chi2,nent,fitstat);
 
-        canv->Update();
-      }
+    m_outfile << twr << " " << lyr << " " << col << " " << face << " " << lacMeV << " " << errlacMeV << endl;
+  }
+
+private:
+  static string fitFuncName(const FaceIdx faceIdx) {
+    return "lacfit_" + faceIdx.toStr();
+  }
+
+  static string rebinFuncName(const FaceIdx faceIdx) {
+    return "lacrbfit_" + faceIdx.toStr();
+  }
+
+  /// rebinned copy of LAC histogram in output file
+  TH1I *rebin(const unsigned channel) {
+    const string hrbname("hrbadc_" + m_faceIdx[channel].toStr());
+
+    // original binning was 5 adc units, rebinned should be 20 adc units per bin.
+    m_fhist.cd();
+    TH1I *const hrebin = (TH1I*)m_hadc[channel]->Rebin(4,hrbname.c_str());
+    hrebin->SetTitle(hrbname.c_str());
+
+    return hrebin;
+  }
+
+  TFile &m_fhist;
+  const ADC2NRG &m_adc2nrg;
+  ostream &m_outfile;
+  TNtuple &m_ntp;
 
+  /// prototype for pedestal fit function
+  const TF1 &m_gaus;
+
+  vector<FaceIdx> m_faceIdx;
+  vector<TH1I *> m_hadc;
+  vector<TH1I *> m_hped;
+};
+
+int main(const int argc, const char **argv) {
+  // libCalibGenCAL will throw runtime_error
+  try {
+    AppCfg cfg(argc,argv);
+
+    //-- SETUP LOG FILE --//
+    /// multiplexing output streams
+    /// simultaneously to cout and to logfile
+    LogStrm::addStream(cout);
+
+    // generate logfile name
+    const string logfile(cfg.outputBasename.getVal() + ".lac_fit.log.txt");
+    ofstream tmpStrm(logfile.c_str());
+    LogStrm::addStream(tmpStrm);
+
+    string outputTXTPath(cfg.outputBasename.getVal() + ".lac_fit.txt");
   
+    LogStrm::get() << __FILE__ << ": opening output TXT file: " << outputTXTPath << endl;
+    ofstream outfile(outputTXTPath.c_str());
+    /// print column headers
+    outfile << ";twr lyr col face lac errlac pedDrift lacMeV errlacMeV" << endl;
+    LogStrm::get() << ";twr lyr col face lac errlac pedDrift lacMeV fitstat chi2 mev_slope mev_offset" << endl;
+
+    // open input files
+    ADC2NRG adc2nrg;
+    LogStrm::get() << __FILE__ << ": calib file: " << cfg.adc2nrgFilename.getVal() << endl;
+    adc2nrg.readTXT(cfg.adc2nrgFilename.getVal());
+
+    // open output files
+    LogStrm::get() << __FILE__ << ": opening output histogram file: " << cfg.histFilePath.getVal() << endl;
+    TFile fhist(cfg.histFilePath.getVal().c_str(),"UPDATE");
+    TNtuple* ntp = 
+      new TNtuple("lacadcntp","lacadcntp",
+                  "twr:lyr:col:face:lac:errlac:pedDrift:lacMeV:errlacMeV:bkg0:bkg_steepness:chi2:nent:fitstat");
+
+    // fit each crystal face
+    LACFitter fitter(fhist, adc2nrg, outfile, *ntp);
+    ChannelFitExecutor(cfg.nFitWorkers.getVal()).run(fitter, fitter.nChannels());
+
     LogStrm::get() << __FILE__ << ": Writing output ROOT file." << endl;
     fhist.Write();
     fhist.Close();
@@ -12,6 +12,7 @@
 #include "src/lib/Util/string_util.h"
 #include "src/lib/Util/CGCUtil.h"
 #include "src/lib/Hists/TrigHists.h"
+#include "src/lib/Util/ChannelFitExecutor.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
@@ -31,6 +32,7 @@
 #include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 using namespace std;
 using namespace CfgMgr;
@@ -50,12 +52,17 @@ public:
     outputBasename("outputBasename",
                    "all output files will use this basename + some_ext",
                    ""),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
     help("help",
          'h',
          "print usage info")
   {
     cmdParser.registerArg(histFilePath);
     cmdParser.registerArg(outputBasename);
+    cmdParser.registerVar(nFitWorkers);
     cmdParser.registerSwitch(help);
 
     try {
@@ -78,6 +85,8 @@ public:
 
   CmdArg<string> outputBasename;
 
+  CmdOptVar<unsigned> nFitWorkers;
+
   /// print usage string
   CmdSwitch help;
 
@@ -104,106 +113,54 @@ public:
   float width;
 };
 
-/// fit trigger threshold given vectors of energy (X-axis) & trigger efficiency (Y-axis)
-/// \param mev vector of x-axis energy values
-/// \param eff trigger efficiency each energy value
-/// \param effErr errors on each efficiency value
-/// \param effHist histogram of efficiency vs energy
-FitResults fitChannel(const FaceIdx faceIdx,
-                      vector<float> &mev,
-                      vector<float> &eff,
-                      vector<float> &effErr,
-                      TH1S &effHist) {
-  // find threshold center point, where efficiency > 0.5
-  float mevThresh=0;
-  for (unsigned i = 0; i < eff.size(); i++)
-    if (eff[i] > 0.5) {
-      mevThresh = mev[i];
-      break;
-    }  
-
-  // copy data into arrays for passing to ROOT
-  const unsigned nBins = effHist.GetNbinsX();
-  float * const mev_arr = new float[nBins];
-  float * const mevErr_arr = new float[nBins];
-  float * const eff_arr = new float[nBins];
-  float * const effErr_arr = new float[nBins];
-
-  const unsigned short nPts = mev.size();
-
-  copy(mev.begin(), mev.end(), mev_arr);
-  /// fill mevErr_arr with equal value
-  for (unsigned i=0;i<nBins;i++)mevErr_arr[i]=1.0;
-
-  copy(eff.begin(), eff.end(), eff_arr);
-  copy(effErr.begin(), effErr.end(), effErr_arr);
+/// trigger efficiency data points for single channel
+class EffData {
+public:
+  /// mev @ bin center
+  vector<float> mev;
+  /// percent total hits triggered
+  vector<float> eff;
+  /// error of efficiency
+  vector<float> effErr;
+};
+
+/// load efficiency data points & errors into graph
+void fillEffGraph(const FaceIdx faceIdx,
+                  const EffData &effData,
+                  TGraphErrors &geffs) {
+  const unsigned short nPts = effData.mev.size();
+
+  geffs.Set(nPts);
+  for (unsigned i = 0; i < nPts; i++) {
+    geffs.SetPoint(i, effData.mev[i], effData.eff[i]);
+    /// equal error on each mev value
+    geffs.SetPointError(i, 1.0, effData.effErr[i]);
+  }
   
   const string name = string("fit_trig_eff") + faceIdx.toStr();
-  TGraphErrors geffs(nPts,
-                     mev_arr, 
-                     eff_arr, 
-                     mevErr_arr, 
-                     effErr_arr);
   geffs.SetNameTitle(name.c_str(), name.c_str());
+}
 
-  TCanvas c(name.c_str(), name.c_str(), -1);
-
-  const float maxEne = effHist.GetXaxis()->GetXmax();
-  TF1 step("step", "1.0/(1.0+exp(-[1]*(x-[0])))",0,maxEne);
-  step.SetNpx(500);
-  step.SetParName(0, "threshold MeV");
-  step.SetParLimits(0, 0, maxEne);
-  step.SetParName(1, "threshold sharpness");
-  step.FixParameter(1, nBins/maxEne); /// set steepness to about 1 bin width
-  step.SetParameters(mevThresh, nBins/maxEne);
-
-
-  FitResults fr;
-  fr.fitStat = geffs.Fit(&step,"QLB","");
-  fr.threshMeV = step.GetParameter(0);
-  fr.threshErrMeV = step.GetParError(0);
-  fr.chisq = step.GetChisquare();
-  fr.nEntries = effHist.GetEntries();
-  fr.width = step.GetParameter(1);
-
-
-
-  TH1S heff(effHist);   
-  heff.Reset();
-  heff.SetMaximum(3);
-  heff.SetMinimum(-1.5); 
-  heff.Draw();
-
-  geffs.SetMarkerStyle(22);
-  geffs.SetMarkerSize(0.8);
-  geffs.Draw("PSAME");
-
-  c.Write();
-
-  delete [] mev_arr;
-  delete [] mevErr_arr;
-  delete [] eff_arr;
-  delete [] effErr_arr;
+/// new threshold step function w/ parameter names (caller owns)
+TF1 *newStepFunc(const float maxEne) {
+  TF1 *const step = new TF1("step", "1.0/(1.0+exp(-[1]*(x-[0])))",0,maxEne);
+  step->SetNpx(500);
+  step->SetParName(0, "threshold MeV");
+  step->SetParName(1, "threshold sharpness");
 
-  return fr;
+  return step;
 }
 
-/// fit trigger threshold given histograms of total hits and of triggered hits
-FitResults fitHists(const FaceIdx faceIdx,
-                    TH1S &trigHist,
-                    TH1S &specHist) {
+/// fill efficiency data points given histograms of total hits and of
+/// triggered hits, replace trigHist w/ efficiency histogram
+void calcEfficiency(TH1S &trigHist,
+                    TH1S &specHist,
+                    EffData &effData) {
   /// retreive bin Data from histograms
   short const * const specHistData = specHist.GetArray();
   short const * const trigHistData = trigHist.GetArray();
 
   /// actual data points (skip overflow bins in histograms
-  /// mev @ bin center
-  vector<float> mevCtr;
-  /// percent total hits triggered
-  vector<float> eff;
-  /// error of efficiency
-  vector<float> effErr;
-
   for (unsigned short nBin = 0;
        nBin < trigHist.GetNbinsX();
        nBin++) {
@@ -215,9 +172,9 @@ FitResults fitHists(const FaceIdx faceIdx,
     const float trig = trigHistData[nBin+1];
     const float noTrig = totalHits - trig;
 
-    eff.push_back(trig / totalHits);
+    effData.eff.push_back(trig / totalHits);
     const float mev = specHist.GetBinCenter(nBin+1); 
-    mevCtr.push_back(mev);
+    effData.mev.push_back(mev);
 
     // used in efferr calc, must be >= 1.0
     const float strig = max<float>(1.0,trig);
@@ -225,15 +182,147 @@ FitResults fitHists(const FaceIdx faceIdx,
     const float snotrig = max<float>(1.0,noTrig);
 
     const float err = sqrt(strig*noTrig*noTrig + snotrig*trig*trig)/(totalHits*totalHits); 
-    effErr.push_back(err);
+    effData.effErr.push_back(err);
   }
 
   // create effHist (not used for fitting, but good for plotting)
   trigHist.Divide(&specHist);
-  
-  return fitChannel(faceIdx, mevCtr, eff, effErr, trigHist);
 }
 
+/// fit trigger threshold for each crystal face (see ChannelFitExecutor)
+class TrigFitter : public ChannelFitter {
+public:
+  TrigFitter(ostream &outfileTXT,
+             TNtuple &ntp) :
+    m_outfileTXT(outfileTXT),
+    m_ntp(ntp)
+  {}
+
+  /// add channel to fit, trigHist is replaced w/ efficiency histogram
+  void addChannel(const FaceIdx faceIdx,
+                  TH1S &trigHist,
+                  TH1S &specHist) {
+    m_faceIdx.push_back(faceIdx);
+    m_effHists.push_back(&trigHist);
+    m_effData.push_back(EffData());
+    calcEfficiency(trigHist, specHist, m_effData.back());
+  }
+
+  unsigned nChannels() const {
+    return m_effHists.size();
+  }
+
+  /// fit trigger threshold given vectors of energy (X-axis) & trigger efficiency (Y-axis)
+  /// results: fit status, packed step function
+  bool fitChannel(const unsigned channel,
+                  vector<double> &results) {
+    const EffData &effData = m_effData[channel];
+    TH1S &effHist = *m_effHists[channel];
+
+    // find threshold center point, where efficiency > 0.5
+    float mevThresh=0;
+    for (unsigned i = 0; i < effData.eff.size(); i++)
+      if (effData.eff[i] > 0.5) {
+        mevThresh = effData.mev[i];
+        break;
+      }  
+
+    TGraphErrors geffs;
+    fillEffGraph(m_faceIdx[channel], effData, geffs);
+
+    const unsigned nBins = effHist.GetNbinsX();
+
+    const float maxEne = effHist.GetXaxis()->GetXmax();
+    TF1 *const step = newStepFunc(maxEne);
+    step->SetParLimits(0, 0, maxEne);
+    step->FixParameter(1, nBins/maxEne); /// set steepness to about 1 bin width
+    step->SetParameters(mevThresh, nBins/maxEne);
+
+    results.push_back(geffs.Fit(step,"QLB",""));
+    ChannelFitExecutor::packFitFunc(*step, results);
+
+    delete step;
+    return true;
+  }
+
+  /// write efficiency plot & fit results
+  void storeResults(const unsigned channel,
+                    const vector<double> &results) {
+    const FaceIdx faceIdx = m_faceIdx[channel];
+    TH1S &effHist = *m_effHists[channel];
+
+    const float maxEne = effHist.GetXaxis()->GetXmax();
+
+    /// restore TGraph::Fit() side effect, graph owns function
+    TGraphErrors geffs;
+    fillEffGraph(faceIdx, m_effData[channel], geffs);
+    TF1 *const step = newStepFunc(maxEne);
+    ChannelFitExecutor::unpackFitFunc(*step, results, 1);
+    geffs.GetListOfFunctions()->Add(step);
+
+    FitResults fr;
+    fr.fitStat = results[0];
+    fr.threshMeV = step->GetParameter(0);
+    fr.threshErrMeV = step->GetParError(0);
+    fr.chisq = step->GetChisquare();
+    fr.nEntries = effHist.GetEntries();
+    fr.width = step->GetParameter(1);
+
+    const string name = string("fit_trig_eff") + faceIdx.toStr();
+    TCanvas c(name.c_str(), name.c_str(), -1);
+
+    TH1S heff(effHist);   
+    heff.Reset();
+    heff.SetMaximum(3);
+    heff.SetMinimum(-1.5); 
+    heff.Draw();
+
+    geffs.SetMarkerStyle(22);
+    geffs.SetMarkerSize(0.8);
+    geffs.Draw("PSAME");
+
+    c.Write();
+
+    const float twr = faceIdx.getTwr().val();
+    const float lyr = faceIdx.getLyr().val();
+    const float col = faceIdx.getCol().val();
+    const float face = faceIdx.getFace().val();
+
+    LogStrm::get() << twr << " " << lyr << " " << col << " " << face << " "
+                   << fr.threshMeV << " " 
+                   << fr.threshErrMeV << " "
+                   << fr.width << " "
+                   << fr.chisq     << " "
+                   << fr.nEntries  << " "
+                   << fr.fitStat   
+                   << endl;
+
+    m_outfileTXT << twr << " " << lyr << " " << col << " " << face 
+                 << " " << fr.threshMeV 
+                 << " " << fr.threshErrMeV << endl;
+
+    m_ntp.Fill(twr,
+               lyr,
+               col,
+               face,
+               fr.threshMeV,
+               fr.threshErrMeV,
+               fr.chisq,
+               fr.fitStat,
+               fr.nEntries,
+               fr.width);
+  }
+
+private:
+  ostream &m_outfileTXT;
+  TNtuple &m_ntp;
+
+  vector<FaceIdx> m_faceIdx;
+  /// trigger histograms, divided by spectrum histograms
+  vector<TH1S *> m_effHists;
+  vector<EffData> m_effData;
+};
+
 int main(const int argc, const char **argv) {
   // libCalibGenCAL will throw runtime_error
   try {
@@ -278,6 +367,7 @@ int main(const int argc, const char **argv) {
     LogStrm::get() << ";twr lyr col face threshMeV errThreshMeV width chi2 nEntries fitstat" << endl;
     outfileTXT << ";twr lyr col face threshMeV errthresMeV" << endl;
 
+    TrigFitter fitter(outfileTXT, *ntp);
     for (FaceIdx faceIdx; faceIdx.isValid(); faceIdx++) {
       TH1S *const trigHist = trigHists.getHist(faceIdx);
       /// we don't require every channel to be present
@@ -297,40 +387,11 @@ int main(const int argc, const char **argv) {
       if (specHist->GetEntries() <= 0)
         continue;
 
-
-      FitResults fr = fitHists(faceIdx, *trigHist, *specHist);
-
-      const float twr = faceIdx.getTwr().val();
-      const float lyr = faceIdx.getLyr().val();
-      const float col = faceIdx.getCol().val();
-      const float face = faceIdx.getFace().val();
-
-      LogStrm::get() << twr << " " << lyr << " " << col << " " << face << " "
-                     << fr.threshMeV << " " 
-                     << fr.threshErrMeV << " "
-                     << fr.width << " "
-                     << fr.chisq     << " "
-                     << fr.nEntries  << " "
-                     << fr.fitStat   
-                     << endl;
-
-      outfileTXT << twr << " " << lyr << " " << col << " " << face 
-                 << " " << fr.threshMeV 
-                 << " " << fr.threshErrMeV << endl;
-
-      ntp->Fill(twr,
-                lyr,
-                col,
-                face,
-                fr.threshMeV,
-                fr.threshErrMeV,
-                fr.chisq,
-                fr.fitStat,
-                fr.nEntries,
-                fr.width);
+      fitter.addChannel(faceIdx, *trigHist, *specHist);
     }
 
-  
+    ChannelFitExecutor(cfg.nFitWorkers.getVal()).run(fitter, fitter.nChannels());
+
     LogStrm::get() << __FILE__ << ": Writing output ROOT file." << endl;
     outRootFile.Write();
     outRootFile.Close();
@@ -11,6 +11,7 @@
 #include "src/lib/Util/CfgMgr.h"
 #include "src/lib/Hists/TrigHists.h"
 #include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/ChannelFitExecutor.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
@@ -25,6 +26,7 @@
 #include <string>
 #include <fstream>
 #include <cmath>
+#include <vector>
 
 using namespace std;
 using namespace CfgMgr;
@@ -44,12 +46,17 @@ public:
     outputBasename("outputBasename",
                    "all output files will use this basename + some_ext",
                    ""),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
     help("help",
          'h',
          "print usage info")
   {
     cmdParser.registerArg(histFilePath);
     cmdParser.registerArg(outputBasename);
+    cmdParser.registerVar(nFitWorkers);
     cmdParser.registerSwitch(help);
 
     try {
@@ -72,6 +79,8 @@ public:
 
   CmdArg<string> outputBasename;
 
+  CmdOptVar<unsigned> nFitWorkers;
+
   /// print usage string
   CmdSwitch help;
 
@@ -116,6 +125,164 @@ void fitSpectrum(TH1S &h, float &height, float &power) {
   power = spec.GetParameter(NPARM_SPEC_POWER);
 }
 
+/// enumerate fit paramters.
+typedef enum {
+  NPARM_THOLD,
+  NPARM_WIDTH,
+  NPARM_SPEC_HEIGHT,
+  NPARM_SPEC_POWER,
+  NPARM_BKG_PCT
+} TRIGHIST_PARMS;
+
+/// fit trigger threshold for each diode (see ChannelFitExecutor)
+class TrigMonitorFitter : public ChannelFitter {
+public:
+  TrigMonitorFitter(TrigHists &fleHists,
+                    TrigHists &fheHists,
+                    TNtuple &ntp) :
+    m_ntp(ntp),
+    /// create fitting stepction (straight line 'background' multiplied by a
+    /// sigmoidal 'threshold')
+    m_step("trig_fit","([2]*x**[3])*([4]+(1-[4])/(1+exp(([0]-x)/[1])))")
+  {
+    m_step.SetNpx(500);
+    
+    m_step.SetParName(NPARM_THOLD, "threshold");
+    m_step.SetParName(NPARM_WIDTH, "threshold width");
+    m_step.SetParName(NPARM_SPEC_HEIGHT,   "spectrum height");
+    m_step.SetParName(NPARM_SPEC_POWER, "spectral index");
+    m_step.SetParName(NPARM_BKG_PCT, "trigger efficiency below threshold");
+
+    for (DiodeIdx diodeIdx; diodeIdx.isValid(); diodeIdx++) {
+      const DiodeNum diode = diodeIdx.getDiode();
+
+      /// select histogram collection for current diode
+      TrigHists &trigHists = (diode == LRG_DIODE) ? fleHists : fheHists;
+      
+      /// retrieve histogram from collection
+      const FaceIdx faceIdx = diodeIdx.getFaceIdx();
+      TH1S *const trigHist = trigHists.getHist(faceIdx);
+      /// we don't require every channel to be present
+      if (!trigHist)
+        continue;
+
+      m_diodeIdx.push_back(diodeIdx);
+      m_hists.push_back(trigHist);
+    }
+  }
+
+  unsigned nChannels() const {
+    return m_hists.size();
+  }
+
+  /// results: spectrum height & power, fit status, packed step function
+  bool fitChannel(const unsigned channel,
+                  vector<double> &results) {
+    TH1S *const trigHist = m_hists[channel];
+
+    /// find background spectrum
+    float spec_height, spec_power;
+    fitSpectrum(*trigHist, spec_height, spec_power);
+      
+    /// setup fitting parameters.
+    const float maxEne = trigHist->GetXaxis()->GetXmax();
+    const unsigned nBins = trigHist->GetNbinsX();
+    const unsigned maxBin = trigHist->GetMaximumBin();
+    const float maxBinCenter = trigHist->GetBinCenter(maxBin);
+
+    /// threshold must be on x-axis, start @ middle of hist
+    m_step.SetParLimits(NPARM_THOLD, maxBinCenter*.75, std::min<float>(maxBinCenter*1.25,maxEne));
+    m_step.SetParameter(NPARM_THOLD, maxBinCenter);
+
+    /// threshold width should be roughly one bin.
+    m_step.FixParameter(NPARM_WIDTH, maxEne/nBins);
+
+    /// background spectra now defined.
+    m_step.FixParameter(NPARM_SPEC_HEIGHT, spec_height);
+    m_step.FixParameter(NPARM_SPEC_POWER, spec_power);
+
+    m_step.SetParLimits(NPARM_BKG_PCT,0,.5);
+    m_step.SetParameter(NPARM_BKG_PCT,0);
+
+    /// fit histogram
+    unsigned fitstat = 0;
+
+    fitstat = trigHist->Fit(&m_step,
+                            "QLB",
+                            "",
+                            maxBinCenter/2,
+                            maxEne); // start fitting @ 50% of threshold (background is usually flat above this point)
+
+    results.push_back(spec_height);
+    results.push_back(spec_power);
+    results.push_back(fitstat);
+    ChannelFitExecutor::packFitFunc((TF1&)*trigHist->GetFunction(m_step.GetName()), results);
+    return true;
+  }
+
+  void storeResults(const unsigned channel,
+                    const vector<double> &results) {
+    const DiodeIdx diodeIdx = m_diodeIdx[channel];
+    TH1S *const trigHist = m_hists[channel];
+
+    const float spec_height = results[0];
+    const float spec_power = results[1];
+    const unsigned fitstat = (unsigned)results[2];
+    ChannelFitExecutor::attachFitFunc(*trigHist, m_step, results, 3);
+
+    /// get fit results
+    const TF1 &step = (TF1&)*trigHist->GetFunction(m_step.GetName());
+    const float threshMeV = step.GetParameter(NPARM_THOLD);
+    const float threshErrMeV = step.GetParError(NPARM_THOLD);
+    const float bkg = step.GetParameter(NPARM_BKG_PCT);
+    const float chisq = step.GetChisquare();
+    const unsigned nEntries = (unsigned)trigHist->GetEntries();
+    const float width = step.GetParameter(NPARM_WIDTH);
+
+    /// output results
+    LogStrm::get() << diodeIdx.getTwr().val()
+                   << " " << diodeIdx.getLyr().val()
+                   << " " << diodeIdx.getCol().val()
+                   << " " << diodeIdx.getFace().val()
+                   << " " << diodeIdx.getDiode().val()
+                   << " " << threshMeV
+                   << " " << threshErrMeV
+                   << " " << width
+                   << " " << spec_height
+                   << " " << spec_power
+                   << " " << bkg
+                   << " " << chisq
+                   << " " << nEntries
+                   << " " << fitstat
+                   << endl;
+
+    m_ntp.Fill(diodeIdx.getTwr().val(),
+               diodeIdx.getLyr().val(),
+               diodeIdx.getCol().val(),
+               diodeIdx.getFace().val(),
+               diodeIdx.getDiode().val(),
+               threshMeV,
+               threshErrMeV,
+               width,
+               spec_height,
+               spec_power,
+               bkg,
+               chisq,
+               nEntries,
+               fitstat
+               );
+  }
+
+private:
+  TNtuple &m_ntp;
+
+  /// threshold fit function, prototype for histogram fit function
+  TF1 m_step;
+
+  vector<DiodeIdx> m_diodeIdx;
+  vector<TH1S *> m_hists;
+};
+
 int main(const int argc, const char **argv) {
   // libCalibGenCAL will throw runtime_error
   try {
@@ -147,119 +314,14 @@ int main(const int argc, const char **argv) {
     TrigHists fheHists("fheHist",
                        &outROOTFile, &inROOTFile);
 
-    /// create fitting stepction (straight line 'background' multiplied by a
-    /// sigmoidal 'threshold')
-    TF1* step = new TF1("trig_fit","([2]*x**[3])*([4]+(1-[4])/(1+exp(([0]-x)/[1])))");
-    step->SetNpx(500);
-    
-    /// enumerate fit paramters.
-    typedef enum {
-      NPARM_THOLD,
-      NPARM_WIDTH,
-      NPARM_SPEC_HEIGHT,
-      NPARM_SPEC_POWER,
-      NPARM_BKG_PCT
-    } TRIGHIST_PARMS;
-
-    step->SetParName(NPARM_THOLD, "threshold");
-    step->SetParName(NPARM_WIDTH, "threshold width");
-    step->SetParName(NPARM_SPEC_HEIGHT,   "spectrum height");
-    step->SetParName(NPARM_SPEC_POWER, "spectral index");
-    step->SetParName(NPARM_BKG_PCT, "trigger efficiency below threshold");
-
     TNtuple* ntp = 
       new TNtuple("trig_fit_ntp","trig_fit_ntp",
                   "twr:lyr:col:face:diode:thresh:err:width:spec_height:spec_power:bkg:chisq:nEntries:fitstat");
 
     /// print column headers
     LogStrm::get() << ";twr lyr col face diode threshMeV errThreshMeV width spec_height spec_power bkg chi2 nEntries fitstat" << endl;
-    for (DiodeIdx diodeIdx; diodeIdx.isValid(); diodeIdx++) {
-      const DiodeNum diode = diodeIdx.getDiode();
-
-      /// select histogram collection for current diode
-      TrigHists &trigHists = (diode == LRG_DIODE) ? fleHists : fheHists;
-      
-      /// retrieve histogram from collection
-      const FaceIdx faceIdx = diodeIdx.getFaceIdx();
-      TH1S *const trigHist = trigHists.getHist(faceIdx);
-      /// we don't require every channel to be present
-      if (!trigHist)
-        continue;
-
-      /// find background spectrum
-      float spec_height, spec_power;
-      fitSpectrum(*trigHist, spec_height, spec_power);
-      
-      /// setup fitting parameters.
-      const float maxEne = trigHist->GetXaxis()->GetXmax();
-      const unsigned nBins = trigHist->GetNbinsX();
-      const unsigned maxBin = trigHist->GetMaximumBin();
-      const float maxBinCenter = trigHist->GetBinCenter(maxBin);
-
-      /// threshold must be on x-axis, start @ middle of hist
-      step->SetParLimits(NPARM_THOLD, maxBinCenter*.75, std::min<float>(maxBinCenter*1.25,maxEne));
-      step->SetParameter(NPARM_THOLD, maxBinCenter);
-
-      /// threshold width should be roughly one bin.
-      step->FixParameter(NPARM_WIDTH, maxEne/nBins);
-
-      /// background spectra now defined.
-      step->FixParameter(NPARM_SPEC_HEIGHT, spec_height);
-      step->FixParameter(NPARM_SPEC_POWER, spec_power);
-
-      step->SetParLimits(NPARM_BKG_PCT,0,.5);
-      step->SetParameter(NPARM_BKG_PCT,0);
-
-      /// fit histogram
-      unsigned fitstat = 0;
-
-      fitstat = trigHist->Fit(step,
-                              "QLB",
-                              "",
-                              maxBinCenter/2,
-                              maxEne); // start fitting @ 50% of threshold (background is usually flat above this point)
-
-      /// get fit results
-      const float threshMeV = step->GetParameter(NPARM_THOLD);
-      const float threshErrMeV = step->GetParError(NPARM_THOLD);
-      const float bkg = step->GetParameter(NPARM_BKG_PCT);
-      const float chisq = step->GetChisquare();
-      const unsigned nEntries = (unsigned)trigHist->GetEntries();
-      const float width = step->GetParameter(NPARM_WIDTH);
-
-      /// output results
-      LogStrm::get() << diodeIdx.getTwr().val()
-                     << " " << diodeIdx.getLyr().val()
-                     << " " << diodeIdx.getCol().val()
-                     << " " << diodeIdx.getFace().val()
-                     << " " << diodeIdx.getDiode().val()
-                     << " " << threshMeV
-                     << " " << threshErrMeV
-                     << " " << width
-                     << " " << spec_height
-                     << " " << spec_power
-                     << " " << bkg
-                     << " " << chisq
-                     << " " << nEntries
-                     << " " << fitstat
-                     << endl;
-
-      ntp->Fill(diodeIdx.getTwr().val(),
-                diodeIdx.getLyr().val(),
-                diodeIdx.getCol().val(),
-                diodeIdx.getFace().val(),
-                diodeIdx.getDiode().val(),
-                threshMeV,
-                threshErrMeV,
-                width,
-                spec_height,
-                spec_power,
-                bkg,
-                chisq,
-                nEntries,
-                fitstat
-                );
-    }
+    TrigMonitorFitter fitter(fleHists, fheHists, *ntp);
+    ChannelFitExecutor(cfg.nFitWorkers.getVal()).run(fitter, fitter.nChannels());
 
     LogStrm::get() << __FILE__ << ": Writing output ROOT file." << endl;
     outROOTFile.Write();
@@ -10,6 +10,7 @@
 #include "src/lib/Util/CfgMgr.h"
 #include "src/lib/Util/string_util.h"
 #include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/ChannelFitExecutor.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
@@ -27,6 +28,7 @@
 #include <sstream>
 #include <cfloat>
 #include <cmath>
+#include <vector>
 
 using namespace std;
 using namespace CfgMgr;
@@ -46,12 +48,17 @@ public:
     outputBasename("outputBasename",
                    "all output files will use this basename + some_ext",
                    ""),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
     help("help",
          'h',
          "print usage info")
   {
     cmdParser.registerArg(histFilePath);
     cmdParser.registerArg(outputBasename);
+    cmdParser.registerVar(nFitWorkers);
     cmdParser.registerSwitch(help);
 
     try {
@@ -74,6 +81,8 @@ public:
 
   CmdArg<string> outputBasename;
 
+  CmdOptVar<unsigned> nFitWorkers;
+
   /// print usage string
   CmdSwitch help;
 
@@ -96,6 +105,14 @@ float findLastNonZeroBin(TH1S &h) {
   return h.GetBinCenter(currentBin);
 }
 
+/// ULD fit params
+typedef enum {
+  PARMID_ULD_THOLD,
+  PARMID_ULD_SHARPNESS,
+  PARMID_SPEC_SLOPE,
+  PARMID_SPEC_OFFSET
+} PARMID;
+
 /// find slope, offset for spectrum model
 /// \param slope output slope value
 /// \param offset oiutput offset value
@@ -114,6 +131,134 @@ void findSpectrumModel(TH1S &h,
   slope = h.GetFunction("pol1")->GetParameter(1);
 }
 
+/// ULD threshold fit function w/ parameter names, name is uldfit_<rngIdx>
+TF1 *newULDFunc(const RngIdx rngIdx) {
+  const string name("uldfit_" + rngIdx.toStr());
+  TF1 *const fun = new TF1(name.c_str(),"([2]*x+[3])/(1+exp((x-[0])/[1]))",3095,4095);
+  fun->SetNpx(500);
+
+  fun->SetParName(PARMID_ULD_THOLD, "uld threshold (adc)");
+  fun->SetParName(PARMID_ULD_SHARPNESS, "threshold sharpness");
+  fun->SetParName(PARMID_SPEC_SLOPE, "spec slope");
+  fun->SetParName(PARMID_SPEC_OFFSET, "spec constant");
+
+  return fun;
+}
+
+/// fit ULD histogram for each channel (see ChannelFitExecutor)
+class ULDFitter : public ChannelFitter {
+public:
+  ULDFitter(TFile &fhist,
+            ostream &outfile,
+            TNtuple &ntp) :
+    m_outfile(outfile),
+    m_ntp(ntp)
+  {
+    for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
+      // no ULD for HEX1
+      if (rngIdx.getRng() == HEX1)
+        continue;
+      
+      ostringstream hadcname;
+      hadcname << "uld_" << rngIdx.toStr();
+      TH1S *const hadc = (TH1S*)fhist.Get(hadcname.str().c_str());
+
+      /// skip missing channels
+      if (!hadc)
+        continue;
+
+      m_rngIdx.push_back(rngIdx);
+      m_hists.push_back(hadc);
+    }
+  }
+
+  unsigned nChannels() const {
+    return m_hists.size();
+  }
+
+  /// results: initial threshold, fit status, packed ULD function
+  bool fitChannel(const unsigned channel,
+                  vector<double> &results) {
+    TH1S &hadc = *m_hists[channel];
+
+    const float initial_uld_thresh = findLastNonZeroBin(hadc);
+
+    /// find slope, offset for spectral model
+    float spec_slope=0, spec_offset=0;
+    findSpectrumModel(hadc, 
+                      spec_slope, 
+                      spec_offset,
+                      initial_uld_thresh-50);
+
+    TF1 *const fun = newULDFunc(m_rngIdx[channel]);
+    // INIT/LIMIT FIT PARMS
+    static const float uld_sharpness = 3;
+    fun->SetParameters(initial_uld_thresh, uld_sharpness, spec_slope, spec_offset);
+
+    /// limit ULD thresh to real ADC values
+    fun->SetParLimits(PARMID_ULD_THOLD, 3095, 4096);
+    /// sharpness is positive value (should be very small)
+    fun->FixParameter(PARMID_ULD_SHARPNESS, uld_sharpness);
+    /// spec slope
+    fun->FixParameter(PARMID_SPEC_SLOPE, spec_slope);
+    /// limit background constant to positive values (scale to size of histogram)
+    fun->FixParameter(PARMID_SPEC_OFFSET, spec_offset);
+      
+    const float fitstat = hadc.Fit(fun,"QRLB");
+
+    results.push_back(initial_uld_thresh);
+    results.push_back(fitstat);
+    ChannelFitExecutor::packFitFunc(*fun, results);
+
+    delete fun;
+    return true;
+  }
+
+  void storeResults(const unsigned channel,
+                    const vector<double> &results) {
+    const RngIdx rngIdx = m_rngIdx[channel];
+    TH1S &hadc = *m_hists[channel];
+
+    const float initial_uld_thresh = results[0];
+    const float fitstat = results[1];
+
+    TF1 *const proto = newULDFunc(rngIdx);
+    ChannelFitExecutor::attachFitFunc(hadc, *proto, results, 2);
+    delete proto;
+
+    const TF1 &fun = *hadc.GetFunction(("uldfit_" + rngIdx.toStr()).c_str());
+    const float uld = fun.GetParameter(PARMID_ULD_THOLD);
+    const float erruld = fun.GetParError(PARMID_ULD_THOLD);
+    const float chi2 = fun.GetChisquare();
+    const float nent = hadc.GetEntries();
+    const float spec1 = fun.GetParameter(PARMID_SPEC_SLOPE);
+    const float spec0 = fun.GetParameter(PARMID_SPEC_OFFSET);
+
+    const unsigned short twr = rngIdx.getTwr().val();
+    const unsigned short lyr = rngIdx.getLyr().val();
+    const unsigned short col = rngIdx.getCol().val();
+    const unsigned short face = rngIdx.getFace().val();
+    const unsigned short rng = rngIdx.getRng().val();
+      
+    LogStrm::get() << twr << " " << lyr << " " << col << " " << face << " " << rng << " "
+                   << uld << " " << erruld << " " 
+                   << fitstat << " " << chi2 << " " << initial_uld_thresh << " "
+                   << endl;
+    m_outfile << twr << " " << lyr << " " << col << " " << face << " " << rng << " " << uld << " " << erruld << endl;
+
+    m_ntp.Fill(twr,lyr,col,face,rng,
+               uld, erruld, spec0, spec1,
+               chi2, nent, fitstat);
+  }
+
+private:
+  ostream &m_outfile;
+  TNtuple &m_ntp;
+
+  vector<RngIdx> m_rngIdx;
+  vector<TH1S *> m_hists;
+};
+
 int main(const int argc, const char **argv) {
   // libCalibGenCAL will throw runtime_error
   try {
@@ -143,91 +288,13 @@ int main(const int argc, const char **argv) {
       new TNtuple("uld_ntp","uld_ntp",
                   "twr:lyr:col:face:rng:uld:erruld:spec0:spec1:chi2:nent:fitstat");
 
-    TH1S* hadc;
-  
-    // loop through each channel
     /// output column headers
     LogStrm::get() << "twr lyr col face rng uld erruld fitstat chi2 initial_uld_thresh" << endl;
-    for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
-      // no ULD for HEX1
-      if (rngIdx.getRng() == HEX1)
-        continue;
-      
-      ostringstream hadcname;
-      hadcname << "uld_" << rngIdx.toStr();
-      hadc = (TH1S*)fhist.Get(hadcname.str().c_str());
 
-      /// skip missing channels
-      if (!hadc)
-        continue;
-
-      ostringstream uldfitname;
-      uldfitname << "uldfit_" << rngIdx.toStr();
-
-      const float initial_uld_thresh = findLastNonZeroBin(*hadc);
-
-      /// find slope, offset for spectral model
-      float spec_slope=0, spec_offset=0;
-      findSpectrumModel(*hadc, 
-                        spec_slope, 
-                        spec_offset,
-                        initial_uld_thresh-50);
-      
-
-      // fit params
-      typedef enum {
-        PARMID_ULD_THOLD,
-        PARMID_ULD_SHARPNESS,
-        PARMID_SPEC_SLOPE,
-        PARMID_SPEC_OFFSET
-      } PARMID;
-      TF1* fun = new TF1(uldfitname.str().c_str(),"([2]*x+[3])/(1+exp((x-[0])/[1]))",3095,4095);
-      fun->SetNpx(500);
-      // INIT/LIMIT FIT PARMS
-      static const float uld_sharpness = 3;
-      fun->SetParameters(initial_uld_thresh, uld_sharpness, spec_slope, spec_offset);
-
-      /// limit ULD thresh to real ADC values
-      fun->SetParName(PARMID_ULD_THOLD, "uld threshold (adc)");
-      fun->SetParLimits(PARMID_ULD_THOLD, 3095, 4096);
-      /// sharpness is positive value (should be very small)
-      fun->SetParName(PARMID_ULD_SHARPNESS, "threshold sharpness");
-      fun->FixParameter(PARMID_ULD_SHARPNESS, uld_sharpness);
-      /// spec slope
-      fun->SetParName(PARMID_SPEC_SLOPE, "spec slope");
-      fun->FixParameter(PARMID_SPEC_SLOPE, spec_slope);
-      /// limit background constant to positive values (scale to size of histogram)
-      fun->SetParName(PARMID_SPEC_OFFSET, "spec constant");
-      fun->FixParameter(PARMID_SPEC_OFFSET, spec_offset);
-      
-      const float fitstat = hadc->Fit(uldfitname.str().c_str(),"QRLB");
-      
-      const float uld = fun->GetParameter(0);
-      const float erruld = fun->GetParError(0);
-      const float chi2 = fun->GetChisquare();
-      const float nent = hadc->GetEntries();
-      const float spec1 = fun->GetParameter(2);
-      const float spec0 = fun->GetParameter(3);
-
-      const unsigned short twr = rngIdx.getTwr().val();
-      const unsigned short lyr = rngIdx.getLyr().val();
-      const unsigned short col = rngIdx.getCol().val();
-      const unsigned short face = rngIdx.getFace().val();
-      const unsigned short rng = rngIdx.getRng().val();
-      
-      LogStrm::get() << twr << " " << lyr << " " << col << " " << face << " " << rng << " "
-                     << uld << " " << erruld << " " 
-                     << fitstat << " " << chi2 << " " << initial_uld_thresh << " "
-                     << endl;
-      outfile << twr << " " << lyr << " " << col << " " << face << " " << rng << " " << uld << " " << erruld << endl;
-
-      ntp->Fill(twr,lyr,col,face,rng,
-                uld, erruld, spec0, spec1,
-                chi2, nent, fitstat);
+    // fit each channel
+    ULDFitter fitter(fhist, outfile, *ntp);
+    ChannelFitExecutor(cfg.nFitWorkers.getVal()).run(fitter, fitter.nChannels());
 
-    }
-
-  
     LogStrm::get() << __FILE__ << ": Writing output ROOT file." << endl;
     fhist.Write();
     fhist.Close();
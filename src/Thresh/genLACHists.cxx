@@ -9,11 +9,11 @@
 
 
 // LOCAL INCLUDES
+#include "LACHistAlg.h"
 #include "src/lib/Util/CfgMgr.h"
 #include "src/lib/Util/string_util.h"
 #include "src/lib/Util/CGCUtil.h"
-#include "src/lib/Util/RootFileAnalysis.h"
-#include "src/lib/Util/CalSignalArray.h"
+#include "src/lib/Util/FusedDigiLoop.h"
 #include "src/lib/Util/stl_util.h"
 
 // GLAST INCLUDES
@@ -21,15 +21,9 @@
 #include "CalUtil/CalVec.h"
 #include "CalUtil/SimpleCalCalib/CalPed.h"
 #include "CalUtil/SimpleCalCalib/ADC2NRG.h"
-#include "digiRootData/Gem.h"
-#include "digiRootData/DigiEvent.h"
 
 // EXTLIB INCLUDES
 #include "TFile.h"
-#include "TTree.h"
-#include "TH2F.h"
-#include "TH1I.h"
-#include "TF1.h"
 
 // STD INCLUDES
 #include <string>
@@ -114,9 +108,6 @@ public:
 
 };
 
-
-static const unsigned MAX_DELTA_EVENT_TIME_MUS = 100;
-
 int main(const int argc, const char **argv) {
 
   // libCalibGenCAL will throw runtime_error
@@ -166,103 +157,17 @@ int main(const int argc, const char **argv) {
     adc2nrg.readTXT(cfg.adc2nrgFilename.getVal());
 
 
-    RootFileAnalysis rootFile(0,
-                              &digiFileList,
-                              0);
-
     // open output files
     LogStrm::get() << __FILE__ << ": opening output ROOT file: " << outputPath << endl;
     TFile output(outputPath.c_str(),"RECREATE");
 
-    // ENABLE / REGISTER TUPLE BRANCHES
-    rootFile.getDigiChain()->SetBranchStatus("*", 0);
-    rootFile.getDigiChain()->SetBranchStatus("m_calDigiCloneCol");
-    rootFile.getDigiChain()->SetBranchStatus("m_summary");
-    rootFile.getDigiChain()->SetBranchStatus("m_gem");
-
-    CalVec<XtalIdx, TH1I*> hadc;
-    CalVec<XtalIdx, TH1I*> hped;
-
-    for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++) {
-      const FaceIdx faceIdx(xtalIdx, face);
-
-      ostringstream hadcname;
-      hadcname << "hadc_" << faceIdx.toStr();
-      hadc[xtalIdx] = new TH1I(hadcname.str().c_str(),hadcname.str().c_str(),60,0,300);
-
-      ostringstream hpedname;
-      hpedname << "hped_" << faceIdx.toStr();
-      hped[xtalIdx] = new TH1I(hpedname.str().c_str(),hpedname.str().c_str(),200,-100,100);
-    }
-
-    /// store cal signal levels for each channel
-    CalSignalArray calSignalArray(calPed, adc2nrg);
+    // histograms are created in output file
+    LACHistAlg lacAlg(face, calPed, adc2nrg, cfg.nEvts.getVal());
 
     // EVENT LOOP
-    const unsigned  nEvents = min<unsigned>(rootFile.getEntries(), cfg.nEvts.getVal());
-    LogStrm::get() << __FILE__ << ": Processing: " << nEvents << " events." << endl;
-
-    for (unsigned nEvt = 0;
-         nEvt < nEvents;
-         nEvt++) {
-
-      // read new event
-      rootFile.getEvent(nEvt);
-
-      // read in cal digis
-      calSignalArray.clear();
-      
-      DigiEvent const*const digiEvent = rootFile.getDigiEvent();
-      if (!digiEvent) {
-        LogStrm::get() << __FILE__ << ": Unable to read DigiEvent " << nEvt  << endl;
-        continue;
-      }
-
-      calSignalArray.fillArray(*digiEvent);
-
-      //-- retrieve trigger data
-      const Gem &gem =digiEvent->getGem();
-      const unsigned gemConditionsWord = gem.getConditionSummary();
-      const float gemDeltaEventTime = gem.getDeltaEventTime()*0.05;
-      
-      // status print out
-      if (nEvt % 1000 == 0)
-        LogStrm::get() << nEvt << endl;
-      
-      CalVec<FaceNum, float> ene;
-      CalVec<FaceNum, float> adc;
-      CalVec<FaceNum, RngNum> rng;
-
-      for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++) {
-        for (FaceNum tmpFace; tmpFace.isValid(); tmpFace++) {
-          const FaceIdx faceIdx(xtalIdx, tmpFace);
-          ene[tmpFace] = calSignalArray.getFaceSignal(faceIdx);
-          adc[tmpFace] = calSignalArray.getAdcPed(faceIdx);
-          rng[tmpFace] = calSignalArray.getAdcRng(faceIdx);
-        }
-
-        /// skip any events w/ gemDeltaEventTime < 500 muS
-        if (gemDeltaEventTime < MAX_DELTA_EVENT_TIME_MUS)
-          continue;
-
-        /// avoid periodic triggers (pedestals)
-        if(!gem.getPeriodicSet()){
-          if(rng[POS_FACE] == LEX8 && rng[NEG_FACE] == LEX8 && 
-             adc[POS_FACE]>3 && adc[NEG_FACE]>3 && 
-             adc[POS_FACE]<350 && adc[NEG_FACE]<350) {
-            /// skip direct deposit hits by comparing asymmetry between xtal faces
-            const FaceNum oppFace(face.oppositeFace());
-            /// 'healthy assymmetry maxes around 2:1, so we'll cut anything above 3:1
-            if (ene[face] / ene[oppFace] < 3)
-              hadc[xtalIdx]->Fill(adc[face]); 
-          }
-        }
-        
-        /// select periodic (only) triggers for pedestals
-        if(gemConditionsWord == enums::PERIODIC)
-          hped[xtalIdx]->Fill(adc[face]); 
-      }
-    }
+    FusedDigiLoop digiLoop(digiFileList);
+    digiLoop.addConsumer(lacAlg);
+    digiLoop.run();
    
     LogStrm::get() << __FILE__ << ": Writing output ROOT file." << endl;
     output.Write();
@@ -4,27 +4,28 @@
     Generate ULD threshold histograms for each crystal face from best-range-first LPA data.
     Histograms are in non pedestal subtracted adc units.
     Histograms are filled from first readout only
+
+    input may optionally be Cal skim files generated by skimCalDigi (see -s option),
+    or cached Cal skim of digi input (see -c option)
 */
 
 // LOCAL INCLUDES
+#include "ULDHistAlg.h"
 #include "src/lib/Util/CfgMgr.h"
-#include "src/lib/Util/RootFileAnalysis.h"
+#include "src/lib/Util/FusedDigiLoop.h"
+#include "src/lib/Util/CalSkimCache.h"
 #include "src/lib/Util/CGCUtil.h"
 #include "src/lib/Util/string_util.h"
 #include "src/lib/Util/stl_util.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
-#include "CalUtil/CalVec.h"
-#include "digiRootData/DigiEvent.h"
 
 // EXTLIB INCLUDES
 #include "TFile.h"
-#include "TH1S.h"
 
 // STD INCLUDES
 #include <iostream>
-#include <sstream>
 #include <fstream>
 
 using namespace std;
@@ -32,14 +33,6 @@ using namespace CfgMgr;
 using namespace calibGenCAL;
 using namespace CalUtil;
 
-
-// CONSTANTS
-namespace {
-  static const unsigned short ULDHIST_MIN_ADC = 3095;
-  static const unsigned short ULDHIST_MAX_ADC = 4095;
-  static const unsigned short ULDHIST_N_BINS = 100;
-}
-
 /// Manage application configuraiton parameters
 class AppCfg {
 public:
@@ -56,6 +49,13 @@ public:
           'n',
           "number of events to process",
           0xffffffff),
+    skimInput("skimInput",
+              's',
+              "digiFilenames lists Cal skim files (from skimCalDigi) instead of digi ROOT files"),
+    cacheDir("cacheDir",
+             'c',
+             "read events via Cal skim cache in this directory (created on first use)",
+             ""),
     help("help",
          'h',
          "print usage info")
@@ -63,6 +63,8 @@ public:
     cmdParser.registerArg(digiFilenames);
     cmdParser.registerArg(outputBasename);
     cmdParser.registerVar(nEvts);
+    cmdParser.registerSwitch(skimInput);
+    cmdParser.registerVar(cacheDir);
     cmdParser.registerSwitch(help);
 
     try {
@@ -86,11 +88,58 @@ public:
 
   CmdOptVar<unsigned> nEvts;
 
+  /// read from Cal skim files
+  CmdSwitch skimInput;
+
+  /// optional Cal skim cache directory
+  CmdOptVar<string> cacheDir;
+
   /// print usage string
   CmdSwitch help;
 
 };
 
+/// fill ULD histograms from list of Cal skim files
+/// \return # of events processed
+static unsigned fillFromSkim(const vector<string> &skimFileList,
+                             const unsigned maxEvents,
+                             ULDHistAlg &uldAlg) {
+  unsigned nEvt = 0;
+  for (unsigned nFile = 0; nFile < skimFileList.size() && nEvt < maxEvents; nFile++) {
+    LogStrm::get() << __FILE__ << ": Reading skim file: " << skimFileList[nFile] << endl;
+    CalDigiSkimReader skim(skimFileList[nFile]);
+
+    while (nEvt < maxEvents && skim.nextBlock()) {
+      const CalSkimBlock &block = skim.getBlock();
+
+      for (unsigned evt = 0; evt < block.nEvents && nEvt < maxEvents; evt++, nEvt++) {
+        // status print out
+        if (nEvt % 10000 == 0)
+          LogStrm::get() << nEvt << endl;
+
+        if (!(block.flags[evt] & CalSkimBlock::EVT_VALID)) {
+          LogStrm::get() << __FILE__ << ": Unable to read DigiEvent " << nEvt  << endl;
+          continue;
+        }
+
+        if (!(block.flags[evt] & CalSkimBlock::EVT_CALDIGI))
+          throw runtime_error("no calDigiCol found.");
+
+        for (unsigned hit = block.hitBegin(evt); hit < block.hitEnd[evt]; hit++) {
+          const XtalIdx xtalIdx(idents::CalXtalId(block.xtalId[hit]));
+
+          // first readout only
+          for (FaceNum face; face.isValid(); face++) {
+            const unsigned ro = CalSkimBlock::roIdx(hit, 0, face);
+            uldAlg.fillReadout(xtalIdx, face, RngNum(block.range[ro]), block.adc[ro]);
+          }
+        }
+      }
+    }
+  }
+
+  return nEvt;
+}
 
 int main(const int argc, const char **argv) {
   // libCalibGenCAL will throw runtime_error
@@ -117,81 +166,34 @@ int main(const int argc, const char **argv) {
       cout << __FILE__ << ": No input files specified" << endl;
       return -1;
     }
-    RootFileAnalysis rootFile(0,
-                              &digiFileList,
-                              0);
 
     // open output files
     LogStrm::get() << __FILE__ << ": Opening output ROOT file: " << outputPath << endl;
     TFile output(outputPath.c_str(),"RECREATE");
 
-    // ENABLE / REGISTER TUPLE BRANCHES
-    rootFile.getDigiChain()->SetBranchStatus("*", 0);
-    rootFile.getDigiChain()->SetBranchStatus("m_calDigiCloneCol");
-
-    // create ULD threshold histograms, one per range (skip HEX1)
-    CalVec<RngIdx, TH1S*> uldHist;
-    for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
-      if (rngIdx.getRng() == HEX1)
-        continue;
-      ostringstream histname;
-      histname << "uld_" << rngIdx.toStr();
-
-      uldHist[rngIdx] = new TH1S(histname.str().c_str(),
-                                 histname.str().c_str(),
-                                 ULDHIST_N_BINS,
-                                 ULDHIST_MIN_ADC,
-                                 ULDHIST_MAX_ADC);
-    }
+    // histograms are created in output file
+    ULDHistAlg uldAlg(cfg.nEvts.getVal());
 
-    // EVENT LOOP
-    const unsigned  nEvents = min<unsigned>(rootFile.getEntries(), cfg.nEvts.getVal());
-    LogStrm::get() << __FILE__ << ": Processing: " << nEvents << " events." << endl;
-
-    for (unsigned nEvt = 0;
-         nEvt < nEvents;
-         nEvt++) {
-
-      // read new event
-      rootFile.getEvent(nEvt);
-      DigiEvent const*const digiEvent = rootFile.getDigiEvent();
-      if (!digiEvent) {
-        LogStrm::get() << __FILE__ << ": Unable to read DigiEvent " << nEvt  << endl;
-        continue;
-      }
+    if (!cfg.cacheDir.getVal().empty() && !cfg.skimInput.getVal())
+      digiFileList = vector<string>(1, getCalSkimCache(cfg.cacheDir.getVal(), digiFileList));
 
-      // status print out
-      if (nEvt % 10000 == 0)
-        LogStrm::get() << nEvt << endl;
+    if (cfg.skimInput.getVal() || !cfg.cacheDir.getVal().empty()) {
+      const unsigned nEvents = fillFromSkim(digiFileList, cfg.nEvts.getVal(), uldAlg);
+      LogStrm::get() << __FILE__ << ": Processed: " << nEvents << " skimmed events." << endl;
 
-      //-- loop through each 'hit' in one event --//
-      const TClonesArray *calDigiCol = digiEvent->getCalDigiCol();
-      if (!calDigiCol) {
-        LogStrm::get() << "no calDigiCol found." << endl;
-        return -1;
-      }
-      TIter calDigiIter(calDigiCol);
-      const CalDigi      *pCalDigi = 0;
-      while ((pCalDigi = dynamic_cast<CalDigi *>(calDigiIter.Next()))) {
-        const     CalDigi &calDigi = *pCalDigi;    // use reference to avoid -> syntax
-        //-- XtalId --//
-        const idents::CalXtalId id(calDigi.getPackedId());   // get interaction information
-        const XtalIdx xtalIdx(id);
-
-        for (FaceNum face; face.isValid(); face++) {
-          const RngNum rng(calDigi.getRange(0, (CalXtalId::XtalFace)face.val()));
-          if (rng == HEX1)
-            continue;
-
-          const unsigned short adc(calDigi.getAdc(0, (CalXtalId::XtalFace)face.val()));
-          if (adc > ULDHIST_MIN_ADC) {
-            const RngIdx rngIdx(xtalIdx, face, rng);
-            uldHist[rngIdx]->Fill(adc);
-          }
-        }
-      }
+      LogStrm::get() << __FILE__ << ": Writing output ROOT file." << endl;
+      output.Write();
+      output.Close();
+
+      LogStrm::get() << __FILE__ << ": Successfully completed." << endl;
+      return 0;
     }
 
+    // EVENT LOOP
+    FusedDigiLoop digiLoop(digiFileList);
+    digiLoop.addConsumer(uldAlg);
+    digiLoop.run();
+
     LogStrm::get() << __FILE__ << ": Writing output ROOT file." << endl;
     output.Write();
     output.Close();
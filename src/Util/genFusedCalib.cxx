@@ -0,0 +1,666 @@
+// $Header: $
+
+/** @file
+    fill histograms for several Cal calibrations w/ single read of
+    input digi files.  each enabled calibration writes same txt & ROOT
+    output as the equivalent standalone application.
+
+    muon pedestals w/out roughPedTXTFile generate rough pedestals from
+    the same read (see MuonPedAlg::initSinglePassConsumer()).  muonAsym
+    & muonMPD calibrate hits w/ input pedestal / asymmetry files, so
+    they can not use pedestals / asymmetry generated in the same job.
+
+    threshold histograms (LAC, ULD, alive, FLE, FHE) are filled only,
+    fit w/ the usual fit* applications.
+*/
+
+// LOCAL INCLUDES
+#include "src/lib/Algs/MuonPedAlg.h"
+#include "src/Optical/MuonAsymAlg.h"
+#include "src/Optical/MuonMPDAlg.h"
+#include "src/Thresh/LACHistAlg.h"
+#include "src/Thresh/ULDHistAlg.h"
+#include "src/Thresh/AliveHistAlg.h"
+#include "src/Thresh/LPAFleAlg.h"
+#include "src/Thresh/LPAFheAlg.h"
+#include "src/lib/Hists/PedHists.h"
+#include "src/lib/Hists/AsymHists.h"
+#include "src/lib/Hists/MPDHists.h"
+#include "src/lib/Hists/TrigHists.h"
+#include "src/lib/CalibDataTypes/CIDAC2ADCTable.h"
+#include "src/lib/Util/FusedDigiLoop.h"
+#include "src/lib/Util/CfgMgr.h"
+#include "src/lib/Util/InputReadCfg.h"
+#include "src/lib/Util/RootFileAnalysis.h"
+#include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/string_util.h"
+#include "src/lib/Util/stl_util.h"
+
+// GLAST INCLUDES
+#include "CalUtil/SimpleCalCalib/CalPed.h"
+#include "CalUtil/SimpleCalCalib/CIDAC2ADC.h"
+#include "CalUtil/SimpleCalCalib/CalAsym.h"
+#include "CalUtil/SimpleCalCalib/CalMPD.h"
+#include "CalUtil/SimpleCalCalib/ADC2NRG.h"
+
+// EXTLIB INCLUDES
+#include "TFile.h"
+
+// STD INCLUDES
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+using namespace calibGenCAL;
+using namespace CfgMgr;
+using namespace CalUtil;
+
+/// Manage application configuration parameters
+class AppCfg {
+public:
+  AppCfg(const int argc,
+         const char **argv) :
+    cmdParser(path_remove_ext(__FILE__)),
+    digiFilenames("digiFilenames",
+                  "text file w/ newline delimited list of input digi ROOT files",
+                  ""),
+    outputBasename("outputBasename",
+                   "all output files will use this basename + some_ext",
+                   ""),
+    muonPed("muonPed",
+            'P',
+            "generate muon pedestals, output to basename.muonPed.*"),
+    muonAsym("muonAsym",
+             'A',
+             "generate muon light asymmetry (requires pedTXTFile, inlTXTFile), output to basename.muonAsym.*"),
+    muonMPD("muonMPD",
+            'M',
+            "generate muon MeV per DAC (requires pedTXTFile, inlTXTFile, asymTXTFile), output to basename.muonMPD.*"),
+    lacFace("lacFace",
+            'L',
+            "fill LAC threshold histograms for crystal face 'POS'|'NEG' (requires pedTXTFile, muSlopeTXTFile), output to basename.lac_hist.root",
+            ""),
+    uldHists("uldHists",
+             'U',
+             "fill ULD threshold histograms, output to basename.uld_hist.root"),
+    aliveHists("aliveHists",
+               'V',
+               "fill channel alive histograms (requires pedTXTFile), output to basename.Alive.root"),
+    fleFace("fleFace",
+            'F',
+            "fill FLE trigger histograms for crystal face 'POS'|'NEG' (requires pedTXTFile, muSlopeTXTFile, triggerPattern), output to basename.FLE.face.pattern.root",
+            ""),
+    fheHists("fheHists",
+             'H',
+             "fill FHE trigger histograms (requires pedTXTFile, muSlopeTXTFile, triggerPattern), output to basename.FHE.pattern.root"),
+    roughPedTXTFile("roughPedTXTFile",
+                    'r',
+                    "input rough pedestals txt file (e.g. from genMuonPed) for muonPed outlier cut (default: generate from same read)",
+                    ""),
+    pedTXTFile("pedTXTFile",
+               'p',
+               "input cal pedestals txt file",
+               ""),
+    inlTXTFile("inlTXTFile",
+               'i',
+               "input cal cidac2adc txt file",
+               ""),
+    asymTXTFile("asymTXTFile",
+                'a',
+                "input cal asym txt file",
+                ""),
+    muSlopeTXTFile("muSlopeTXTFile",
+                   'm',
+                   "input muSlope (adc2mev) txt file",
+                   ""),
+    triggerPattern("triggerPattern",
+                   0,
+                   "FLE/FHE enabled channels 'EREC' (even row (gcrc) even column) or 'EROC' (even row (gcrc) odd column)",
+                   ""),
+    triggerCut("triggerCut",
+               't',
+               "muonPed event filter 'ALL'|'PERIODIC'|'EXTERNAL' (default='PERIODIC')",
+               "PERIODIC"),
+    pedEntriesPerHist("pedEntriesPerHist",
+                      0,
+                      "muonPed: stop after all histograms have > n entries",
+                      1000),
+    asymEntriesPerHist("asymEntriesPerHist",
+                       0,
+                       "muonAsym: stop after all histograms have > n entries",
+                       10000),
+    mpdEntriesPerHist("mpdEntriesPerHist",
+                      0,
+                      "muonMPD: stop after all histograms have > n entries",
+                      3000),
+    threshEvents("threshEvents",
+                 0,
+                 "LAC, ULD: number of events to process",
+                 0xffffffff),
+    trigEntriesPerHist("trigEntriesPerHist",
+                       0,
+                       "alive, FLE, FHE: stop after all histograms have > n entries",
+                       1000),
+    fleThresh("fleThresh",
+              0,
+              "FLE: expected threshold in MeV",
+              100),
+    fheThresh("fheThresh",
+              0,
+              "FHE: expected threshold in MeV",
+              1000),
+    nFitWorkers("nFitWorkers",
+                'j',
+                "fit histograms w/ n parallel worker processes",
+                1),
+    help("help",
+         'h',
+         "print usage info")
+  {
+    cmdParser.registerArg(digiFilenames);
+    cmdParser.registerArg(outputBasename);
+    cmdParser.registerSwitch(muonPed);
+    cmdParser.registerSwitch(muonAsym);
+    cmdParser.registerSwitch(muonMPD);
+    cmdParser.registerVar(lacFace);
+    cmdParser.registerSwitch(uldHists);
+    cmdParser.registerSwitch(aliveHists);
+    cmdParser.registerVar(fleFace);
+    cmdParser.registerSwitch(fheHists);
+    cmdParser.registerVar(roughPedTXTFile);
+    cmdParser.registerVar(pedTXTFile);
+    cmdParser.registerVar(inlTXTFile);
+    cmdParser.registerVar(asymTXTFile);
+    cmdParser.registerVar(muSlopeTXTFile);
+    cmdParser.registerVar(triggerPattern);
+    cmdParser.registerVar(triggerCut);
+    cmdParser.registerVar(pedEntriesPerHist);
+    cmdParser.registerVar(asymEntriesPerHist);
+    cmdParser.registerVar(mpdEntriesPerHist);
+    cmdParser.registerVar(threshEvents);
+    cmdParser.registerVar(trigEntriesPerHist);
+    cmdParser.registerVar(fleThresh);
+    cmdParser.registerVar(fheThresh);
+    cmdParser.registerVar(nFitWorkers);
+    inputRead.registerVars(cmdParser);
+    cmdParser.registerSwitch(help);
+
+    try {
+      cmdParser.parseCmdLine(argc, argv);
+    } catch (exception &e) {
+      // ignore invalid commandline if user asked for help.
+      if (!help.getVal())
+        cout << e.what() << endl;
+      cmdParser.printUsage();
+      exit(-1);
+    }
+  }
+
+  /// construct new parser
+  CmdLineParser cmdParser;
+
+  CmdArg<string> digiFilenames;
+  CmdArg<string> outputBasename;
+
+  CmdSwitch muonPed;
+  CmdSwitch muonAsym;
+  CmdSwitch muonMPD;
+  CmdOptVar<string> lacFace;
+  CmdSwitch uldHists;
+  CmdSwitch aliveHists;
+  CmdOptVar<string> fleFace;
+  CmdSwitch fheHists;
+
+  CmdOptVar<string> roughPedTXTFile;
+  CmdOptVar<string> pedTXTFile;
+  CmdOptVar<string> inlTXTFile;
+  CmdOptVar<string> asymTXTFile;
+  CmdOptVar<string> muSlopeTXTFile;
+
+  CmdOptVar<string> triggerPattern;
+
+  CmdOptVar<string> triggerCut;
+
+  CmdOptVar<unsigned> pedEntriesPerHist;
+  CmdOptVar<unsigned> asymEntriesPerHist;
+  CmdOptVar<unsigned> mpdEntriesPerHist;
+  CmdOptVar<unsigned> threshEvents;
+  CmdOptVar<unsigned> trigEntriesPerHist;
+
+  CmdOptVar<float> fleThresh;
+  CmdOptVar<float> fheThresh;
+
+  CmdOptVar<unsigned> nFitWorkers;
+
+  /// read ahead & TTreeCache options
+  InputReadCfg inputRead;
+
+  /// print usage string
+  CmdSwitch help;
+};
+
+namespace {
+  /// throw if required option is empty
+  void requireOpt(const CmdOptVar<string> &opt,
+                  const string &calibName) {
+    if (opt.getVal().empty())
+      throw runtime_error(calibName + " requires --" + opt.getLongName());
+  }
+}
+
+int main(int argc,
+         const char **argv) {
+  // libCalibGenCAL will throw runtime_error
+  try {
+    AppCfg cfg(argc, argv);
+
+    // read ahead & TTreeCache settings for all event loops
+    cfg.inputRead.applyDefaults();
+
+    const bool doPed  = cfg.muonPed.getVal();
+    const bool doAsym = cfg.muonAsym.getVal();
+    const bool doMPD  = cfg.muonMPD.getVal();
+    const bool doLAC   = !cfg.lacFace.getVal().empty();
+    const bool doULD   = cfg.uldHists.getVal();
+    const bool doAlive = cfg.aliveHists.getVal();
+    const bool doFLE   = !cfg.fleFace.getVal().empty();
+    const bool doFHE   = cfg.fheHists.getVal();
+    if (!doPed && !doAsym && !doMPD &&
+        !doLAC && !doULD && !doAlive && !doFLE && !doFHE) {
+      cout << __FILE__ << ": No calibrations selected" << endl;
+      cfg.cmdParser.printUsage();
+      return -1;
+    }
+
+    if (doAsym || doMPD) {
+      requireOpt(cfg.pedTXTFile, doAsym ? "muonAsym" : "muonMPD");
+      requireOpt(cfg.inlTXTFile, doAsym ? "muonAsym" : "muonMPD");
+    }
+    if (doMPD)
+      requireOpt(cfg.asymTXTFile, "muonMPD");
+    if (doLAC || doAlive || doFLE || doFHE)
+      requireOpt(cfg.pedTXTFile, doLAC ? "lacFace" : doAlive ? "aliveHists" : doFLE ? "fleFace" : "fheHists");
+    if (doLAC || doFLE || doFHE)
+      requireOpt(cfg.muSlopeTXTFile, doLAC ? "lacFace" : doFLE ? "fleFace" : "fheHists");
+    if (doFLE || doFHE)
+      requireOpt(cfg.triggerPattern, doFLE ? "fleFace" : "fheHists");
+
+    // input file(s)
+    vector<string> digiFileList(getLinesFromFile(cfg.digiFilenames.getVal().c_str()));
+    if (digiFileList.size() < 1) {
+      cout << __FILE__ << ": No input files specified" << endl;
+      return -1;
+    }
+
+    //-- SETUP LOG FILE --//
+    /// multiplexing output streams
+    /// simultaneously to cout and to logfile
+    LogStrm::addStream(cout);
+    const string logfile(cfg.outputBasename.getVal() + ".log.txt");
+    ofstream tmpStrm(logfile.c_str());
+
+    LogStrm::addStream(tmpStrm);
+
+    //-- LOG SOFTWARE VERSION INFO --//
+    output_env_banner(LogStrm::get());
+    LogStrm::get() << endl;
+    cfg.cmdParser.printStatus(LogStrm::get());
+    LogStrm::get() << endl;
+
+    //-- INPUT CALIBRATIONS --//
+    CalPed roughPeds;
+    const bool singlePassPed = doPed && cfg.roughPedTXTFile.getVal().empty();
+    if (doPed && !singlePassPed) {
+      LogStrm::get() << __FILE__ << ": reading in rough pedestal file: "
+                     << cfg.roughPedTXTFile.getVal() << endl;
+      roughPeds.readTXT(cfg.roughPedTXTFile.getVal());
+    }
+
+    CalPed peds;
+    if (!cfg.pedTXTFile.getVal().empty()) {
+      LogStrm::get() << __FILE__ << ": reading in pedestal file: "
+                     << cfg.pedTXTFile.getVal() << endl;
+      peds.readTXT(cfg.pedTXTFile.getVal());
+    }
+
+    CIDAC2ADC dac2adc;
+    /// x8 range adc2dac, one table shared by asym & mpd algs
+    auto_ptr<CIDAC2ADCTable> dac2adcTable;
+    if (doAsym || doMPD) {
+      LogStrm::get() << __FILE__ << ": reading in cidac2adc txt file: "
+                     << cfg.inlTXTFile.getVal() << endl;
+      dac2adc.readTXT(cfg.inlTXTFile.getVal());
+      LogStrm::get() << __FILE__ << ": generating cidac2adc splines: " << endl;
+      dac2adc.genSplines();
+      LogStrm::get() << __FILE__ << ": tabulating x8 range adc2dac: " << endl;
+      dac2adcTable.reset(new CIDAC2ADCTable(dac2adc,
+                                            CIDAC2ADCTable::rngBit(LEX8) |
+                                            CIDAC2ADCTable::rngBit(HEX8)));
+    }
+
+    CalAsym inputAsym;
+    if (doMPD) {
+      LogStrm::get() << __FILE__ << ": reading in light asym file: "
+                     << cfg.asymTXTFile.getVal() << endl;
+      inputAsym.readTXT(cfg.asymTXTFile.getVal());
+      LogStrm::get() << __FILE__ << ": building asymmetry splines: " << endl;
+      inputAsym.genSplines();
+    }
+
+    ADC2NRG adc2nrg;
+    if (doLAC || doFLE || doFHE) {
+      LogStrm::get() << __FILE__ << ": reading in muSlope file: "
+                     << cfg.muSlopeTXTFile.getVal() << endl;
+      adc2nrg.readTXT(cfg.muSlopeTXTFile.getVal());
+    }
+
+    map<string, LPATrigAlg::TriggerPattern> trigPatternMap;
+    trigPatternMap["EREC"] = LPATrigAlg::EvenRowEvenCol;
+    trigPatternMap["EROC"] = LPATrigAlg::EvenRowOddCol;
+    const string trigPatternStr(cfg.triggerPattern.getVal());
+    if ((doFLE || doFHE) && trigPatternMap.find(trigPatternStr) == trigPatternMap.end()) {
+      LogStrm::get() << __FILE__ << ": ERROR! Invalid trigPattern string: "
+                     << trigPatternStr << endl;
+      return -1;
+    }
+
+    FusedDigiLoop digiLoop(digiFileList);
+
+    //-- MUON PEDS --//
+    const string pedBasename(cfg.outputBasename.getVal() + ".muonPed");
+    auto_ptr<TFile> pedHistFile;
+    auto_ptr<PedHists> pedHists;
+    auto_ptr<TFile> roughPedHistFile;
+    auto_ptr<PedHists> roughPedHists;
+    MuonPedAlg pedAlg;
+    if (doPed) {
+      map<string, MuonPedAlg::TRIGGER_CUT> trigCutMap;
+      trigCutMap["ALL"]      = MuonPedAlg::PASS_THROUGH;
+      trigCutMap["PERIODIC"] = MuonPedAlg::PERIODIC_TRIGGER;
+      trigCutMap["EXTERNAL"] = MuonPedAlg::EXTERNAL_TRIGGER;
+
+      const string trigCutStr(cfg.triggerCut.getVal());
+      if (trigCutMap.find(trigCutStr) == trigCutMap.end()) {
+        LogStrm::get() << __FILE__ << ": ERROR! Invalid trigger_cut string: "
+                       << trigCutStr << endl;
+        return -1;
+      }
+
+      LogStrm::get() << __FILE__ << ": opening pedestal output histogram file: "
+                     << pedBasename << ".root" << endl;
+      pedHistFile.reset(new TFile((pedBasename + ".root").c_str(),
+                                  "RECREATE",
+                                  "pedestals"));
+      pedHists.reset(new PedHists(pedHistFile.get()));
+
+      if (singlePassPed) {
+        LogStrm::get() << __FILE__ << ": opening output rough pedestal histogram file: "
+                       << pedBasename << ".roughPeds.root" << endl;
+        roughPedHistFile.reset(new TFile((pedBasename + ".roughPeds.root").c_str(),
+                                         "RECREATE",
+                                         "Muon rough pedestals"));
+        roughPedHists.reset(new PedHists(roughPedHistFile.get()));
+
+        pedAlg.initSinglePassConsumer(cfg.pedEntriesPerHist.getVal(),
+                                      *roughPedHists,
+                                      roughPeds,
+                                      *pedHists,
+                                      trigCutMap[trigCutStr],
+                                      cfg.nFitWorkers.getVal());
+      } else
+        pedAlg.initConsumer(cfg.pedEntriesPerHist.getVal(),
+                            &roughPeds,
+                            *pedHists,
+                            trigCutMap[trigCutStr]);
+      digiLoop.addConsumer(pedAlg);
+    }
+
+    //-- LIGHT ASYM --//
+    const string asymBasename(cfg.outputBasename.getVal() + ".muonAsym");
+    auto_ptr<TFile> asymHistFile;
+    auto_ptr<AsymHists> asymHists;
+    auto_ptr<MuonAsymAlg> asymAlg;
+    if (doAsym) {
+      LogStrm::get() << __FILE__ << ": opening output histogram file: "
+                     << asymBasename << ".root" << endl;
+      asymHistFile.reset(new TFile((asymBasename + ".root").c_str(),
+                                   "RECREATE",
+                                   "CAL Light Asymmetry"));
+      asymHists.reset(new AsymHists(CalResponse::MUON_GAIN, 12, 10, asymHistFile.get()));
+      asymAlg.reset(new MuonAsymAlg(peds, *dac2adcTable, *asymHists));
+
+      asymAlg->initConsumer(cfg.asymEntriesPerHist.getVal());
+      digiLoop.addConsumer(*asymAlg);
+    }
+
+    //-- MUON MPD --//
+    const string mpdBasename(cfg.outputBasename.getVal() + ".muonMPD");
+    auto_ptr<TFile> mpdHistFile;
+    auto_ptr<MPDHists> mpdHists;
+    auto_ptr<MuonMPDAlg> mpdAlg;
+    if (doMPD) {
+      LogStrm::get() << __FILE__ << ": opening output histogram file: "
+                     << mpdBasename << ".root" << endl;
+      mpdHistFile.reset(new TFile((mpdBasename + ".root").c_str(),
+                                  "RECREATE",
+                                  "CAL Muon Calib"));
+      mpdHists.reset(new MPDHists(MPDHists::FitMethods::LANDAU));
+      mpdAlg.reset(new MuonMPDAlg(peds, *dac2adcTable, inputAsym, *mpdHists));
+
+      // MPD histograms are created in current directory
+      mpdHistFile->cd();
+      mpdAlg->initConsumer(cfg.mpdEntriesPerHist.getVal());
+      digiLoop.addConsumer(*mpdAlg);
+    }
+
+    //-- LAC THRESHOLD --//
+    const string lacHistPath(cfg.outputBasename.getVal() + ".lac_hist.root");
+    auto_ptr<TFile> lacHistFile;
+    auto_ptr<LACHistAlg> lacAlg;
+    if (doLAC) {
+      LogStrm::get() << __FILE__ << ": opening output histogram file: "
+                     << lacHistPath << endl;
+      lacHistFile.reset(new TFile(lacHistPath.c_str(), "RECREATE"));
+
+      // LAC histograms are created in current directory
+      lacHistFile->cd();
+      lacAlg.reset(new LACHistAlg(FaceNum(cfg.lacFace.getVal()),
+                                  peds,
+                                  adc2nrg,
+                                  cfg.threshEvents.getVal()));
+      digiLoop.addConsumer(*lacAlg);
+    }
+
+    //-- ULD THRESHOLD --//
+    const string uldHistPath(cfg.outputBasename.getVal() + ".uld_hist.root");
+    auto_ptr<TFile> uldHistFile;
+    auto_ptr<ULDHistAlg> uldAlg;
+    if (doULD) {
+      LogStrm::get() << __FILE__ << ": opening output histogram file: "
+                     << uldHistPath << endl;
+      uldHistFile.reset(new TFile(uldHistPath.c_str(), "RECREATE"));
+
+      // ULD histograms are created in current directory
+      uldHistFile->cd();
+      uldAlg.reset(new ULDHistAlg(cfg.threshEvents.getVal()));
+      digiLoop.addConsumer(*uldAlg);
+    }
+
+    //-- CHANNEL ALIVE --//
+    const string aliveHistPath(cfg.outputBasename.getVal() + ".Alive.root");
+    auto_ptr<TFile> aliveHistFile;
+    auto_ptr<AliveHistAlg> aliveAlg;
+    if (doAlive) {
+      LogStrm::get() << __FILE__ << ": opening output histogram file: "
+                     << aliveHistPath << endl;
+      aliveHistFile.reset(new TFile(aliveHistPath.c_str(),
+                                    "RECREATE",
+                                    "Alive_hists"));
+      aliveAlg.reset(new AliveHistAlg(peds,
+                                      aliveHistFile.get(),
+                                      cfg.trigEntriesPerHist.getVal()));
+      digiLoop.addConsumer(*aliveAlg);
+    }
+
+    //-- FLE TRIGGER --//
+    const string fleHistPath(cfg.outputBasename.getVal()
+                             + ".FLE"
+                             + "." + cfg.fleFace.getVal()
+                             + "." + trigPatternStr
+                             + ".root");
+    auto_ptr<TFile> fleHistFile;
+    auto_ptr<TrigHists> fleTrigHists;
+    auto_ptr<TrigHists> fleSpecHists;
+    auto_ptr<LPAFleAlg> fleAlg;
+    if (doFLE) {
+      LogStrm::get() << __FILE__ << ": opening output histogram file: "
+                     << fleHistPath << endl;
+      fleHistFile.reset(new TFile(fleHistPath.c_str(),
+                                  "RECREATE",
+                                  ("FLE_" + trigPatternStr + "_hists").c_str()));
+      fleTrigHists.reset(new TrigHists("trigHist",
+                                       fleHistFile.get(), 0,
+                                       100, 0, 300));
+      fleSpecHists.reset(new TrigHists("specHist",
+                                       fleHistFile.get(), 0,
+                                       100, 0, 300));
+      fleAlg.reset(new LPAFleAlg(FaceNum(cfg.fleFace.getVal()),
+                                 trigPatternMap[trigPatternStr],
+                                 peds,
+                                 adc2nrg,
+                                 *fleSpecHists,
+                                 *fleTrigHists,
+                                 cfg.fleThresh.getVal()));
+      fleAlg->initConsumer(cfg.trigEntriesPerHist.getVal());
+      digiLoop.addConsumer(*fleAlg);
+    }
+
+    //-- FHE TRIGGER --//
+    const string fheHistPath(cfg.outputBasename.getVal()
+                             + ".FHE"
+                             + "." + trigPatternStr
+                             + ".root");
+    auto_ptr<TFile> fheHistFile;
+    auto_ptr<TrigHists> fheTrigHists;
+    auto_ptr<TrigHists> fheSpecHists;
+    auto_ptr<LPAFheAlg> fheAlg;
+    if (doFHE) {
+      LogStrm::get() << __FILE__ << ": opening output histogram file: "
+                     << fheHistPath << endl;
+      fheHistFile.reset(new TFile(fheHistPath.c_str(),
+                                  "RECREATE",
+                                  ("FHE_" + trigPatternStr + "_hists").c_str()));
+      fheTrigHists.reset(new TrigHists("trigHist",
+                                       fheHistFile.get(), 0,
+                                       100, 0, 3000));
+      fheSpecHists.reset(new TrigHists("specHist",
+                                       fheHistFile.get(), 0,
+                                       100, 0, 3000));
+      fheAlg.reset(new LPAFheAlg(trigPatternMap[trigPatternStr],
+                                 peds,
+                                 adc2nrg,
+                                 *fheSpecHists,
+                                 *fheTrigHists,
+                                 cfg.fheThresh.getVal()));
+      fheAlg->initConsumer(cfg.trigEntriesPerHist.getVal());
+      digiLoop.addConsumer(*fheAlg);
+    }
+
+    //-- SINGLE READ OF ALL INPUT EVENTS --//
+    LogStrm::get() << __FILE__ << ": reading root event file(s) starting w/ "
+                   << digiFileList[0] << endl;
+    digiLoop.run();
+
+    const unsigned nFitWorkers = cfg.nFitWorkers.getVal();
+
+    if (singlePassPed) {
+      LogStrm::get() << __FILE__ << ": writing rough pedestals: "
+                     << pedBasename << ".roughPeds.txt" << endl;
+      roughPeds.writeTXT(pedBasename + ".roughPeds.txt");
+      roughPedHistFile->Write();
+      roughPedHistFile->Close();
+    }
+
+    if (doPed) {
+      pedHistFile->cd();
+      pedHists->trimHists();
+
+      CalPed calPed;
+      LogStrm::get() << __FILE__ << ": fitting pedestal histograms." << endl;
+      pedHists->fitHists(calPed, nFitWorkers);
+
+      LogStrm::get() << __FILE__ << ": writing pedestals: " << pedBasename << ".txt" << endl;
+      calPed.writeTXT(pedBasename + ".txt");
+      pedHistFile->Write();
+      pedHistFile->Close();
+    }
+
+    if (doAsym) {
+      asymHistFile->cd();
+      asymAlg->summarizeAlg(LogStrm::get());
+      asymHists->trimHists();
+      asymHists->summarizeHists(LogStrm::get());
+
+      CalAsym calAsym;
+      LogStrm::get() << __FILE__ << ": fitting light asymmmetry histograms." << endl;
+      asymHists->fitHists(calAsym, nFitWorkers);
+
+      LogStrm::get() << __FILE__ << ": writing light asymmetry: " << asymBasename << ".txt" << endl;
+      calAsym.writeTXT(asymBasename + ".txt");
+      asymHistFile->Write();
+      asymHistFile->Close();
+    }
+
+    if (doMPD) {
+      mpdHistFile->cd();
+      mpdHists->trimHists();
+
+      CalMPD calMPD;
+      LogStrm::get() << __FILE__ << ": fitting muon mpd histograms." << endl;
+      mpdHists->fitHists(calMPD, nFitWorkers);
+
+      LogStrm::get() << __FILE__ << ": writing muon mpd: " << mpdBasename << ".txt" << endl;
+      calMPD.writeTXT(mpdBasename + ".txt");
+      mpdHistFile->Write();
+      mpdHistFile->Close();
+    }
+
+    if (doLAC) {
+      lacHistFile->Write();
+      lacHistFile->Close();
+    }
+
+    if (doULD) {
+      uldHistFile->Write();
+      uldHistFile->Close();
+    }
+
+    if (doAlive) {
+      aliveHistFile->cd();
+      aliveAlg->fillSummaryHists();
+      aliveHistFile->Write();
+      aliveHistFile->Close();
+    }
+
+    if (doFLE) {
+      fleHistFile->Write();
+      fleHistFile->Close();
+    }
+
+    if (doFHE) {
+      fheHistFile->Write();
+      fheHistFile->Close();
+    }
+
+    LogStrm::get() << __FILE__ << ": Successfully completed." << endl;
+  } catch (exception &e) {
+    cout << __FILE__ << ": exception thrown: " << e.what() << endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+// $Header: $
+
+/** @file
+    Extract Cal readouts (+ GEM condition word, delta event time & 4-range
+    flag) from digi ROOT files into compact columnar skim file.
+
+    skim file can be read by CalDigiSkimReader w/out any ROOT I/O.
+*/
+
+// LOCAL INCLUDES
+#include "src/lib/Util/CfgMgr.h"
+#include "src/lib/Util/InputReadCfg.h"
+#include "src/lib/Util/RootFileAnalysis.h"
+#include "src/lib/Util/CalSkimCache.h"
+#include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/string_util.h"
+#include "src/lib/Util/stl_util.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <iostream>
+#include <fstream>
+
+using namespace std;
+using namespace CfgMgr;
+using namespace calibGenCAL;
+
+/// Manage application configuraiton parameters
+class AppCfg {
+public:
+  AppCfg(const int argc,
+         const char **argv) :
+    cmdParser(path_remove_ext(__FILE__)),
+    digiFilenames("digiFilenames",
+                  "text file w/ newline delimited list of input digi ROOT files",
+                  ""),
+    outputPath("outputPath",
+               "output Cal skim file",
+               ""),
+    nEvts("numEvents",
+          'n',
+          "number of events to process",
+          0xffffffff),
+    help("help",
+         'h',
+         "print usage info")
+  {
+    cmdParser.registerArg(digiFilenames);
+    cmdParser.registerArg(outputPath);
+    cmdParser.registerVar(nEvts);
+    inputRead.registerVars(cmdParser);
+    cmdParser.registerSwitch(help);
+
+    try {
+      cmdParser.parseCmdLine(argc, argv);
+    } catch (exception &e) {
+      // ignore invalid commandline if user asked for help.
+      if (!help.getVal())
+        cout << e.what() << endl;
+      cmdParser.printUsage();
+      exit(-1);
+    }
+  }
+
+  /// construct new parser
+  CmdLineParser cmdParser;
+
+  CmdArg<string> digiFilenames;
+  CmdArg<string> outputPath;
+
+  CmdOptVar<unsigned> nEvts;
+
+  /// read ahead & TTreeCache options
+  InputReadCfg inputRead;
+
+  /// print usage string
+  CmdSwitch help;
+};
+
+int main(const int argc, const char **argv) {
+  // libCalibGenCAL will throw runtime_error
+  try {
+    AppCfg cfg(argc,argv);
+
+    // read ahead & TTreeCache settings for all event loops
+    cfg.inputRead.applyDefaults();
+
+    //-- SETUP LOG FILE --//
+    /// multiplexing output streams
+    /// simultaneously to cout and to logfile
+    LogStrm::addStream(cout);
+
+    // generate logfile name
+    const string logfile(cfg.outputPath.getVal() + ".log.txt");
+    ofstream tmpStrm(logfile.c_str());
+    LogStrm::addStream(tmpStrm);
+
+    // open input files
+    vector<string> digiFileList(getLinesFromFile(cfg.digiFilenames.getVal().c_str()));
+    if (digiFileList.size() < 1) {
+      cout << __FILE__ << ": No input files specified" << endl;
+      return -1;
+    }
+
+    writeCalSkim(digiFileList, cfg.outputPath.getVal(), cfg.nEvts.getVal());
+
+    LogStrm::get() << __FILE__ << ": Successfully completed." << endl;
+  } catch (exception &e) {
+    cout << __FILE__ << ": exception thrown: " << e.what() << endl;
+    return -1;
+  }
+
+  return 0;
+}
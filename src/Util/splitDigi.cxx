@@ -2,6 +2,10 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <stdexcept>
+#include <sstream>
+#include <memory>
 #include "TChain.h"
 #include "TFile.h"
 #include "TTree.h"
@@ -16,29 +20,122 @@
 
 #include "src/lib/Util/RootFileAnalysis.h"
 #include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/ProcessUtil.h"
 
 using namespace std;
 using namespace CalUtil;
 using namespace calibGenCAL;
 
+namespace {
+  /// copy single entry range of input digi file into its own output file.
+  ///
+  /// ROOT I/O is not thread safe, so each part runs in its own fork()ed
+  /// process w/ private input chain & output file (see runProcessTasks()).
+  class SplitTask : public ProcessTask {
+  public:
+    SplitTask(const string &inpFname,
+              const string &outFname,
+              const RootFileAnalysis::EntryRange &range) :
+      eventFirst(0),
+      eventLast(0),
+      m_inpFname(inpFname),
+      m_outFname(outFname),
+      m_range(range)
+    {}
+
+    /// result is 1st & last event id
+    void run(string &result) {
+      TChain chain("Digi");
+      if (chain.AddFile(m_inpFname.c_str()) == 0)
+        throw runtime_error("Error opening file: " + m_inpFname);
+
+      DigiEvent *digiEvent = 0;
+      chain.SetBranchStatus("*", 1);      // enable all branches in original tree
+      chain.SetBranchAddress("DigiEvent", &digiEvent);
+
+      // output file is closed before input chain is destroyed
+      auto_ptr<TFile> outFile(new TFile(m_outFname.c_str(), "RECREATE"));
+      if (outFile->IsZombie())
+        throw runtime_error("Error creating file: " + m_outFname);
+
+      // clone original tree into output file, but do not copy any
+      // events yet. owned by output file
+      TTree *const outTree = chain.CloneTree(0);
+
+      unsigned first = 0;
+      unsigned last = 0;
+      for (UInt_t j = m_range.begin; j < m_range.end; j++) {
+        if (chain.GetEntry(j) <= 0 || digiEvent == 0) {
+          ostringstream tmp;
+          tmp << "Unable to read event: " << j;
+          throw runtime_error(tmp.str());
+        }
+
+        // event range is recorded here so output never has to be re-read
+        const unsigned eventn = digiEvent->getEventId();
+        if (j == m_range.begin)
+          first = eventn;
+        last = eventn;
+
+        outTree->Fill();
+      }
+
+      // tree may have switched to new file if it exceeded max tree
+      // size, in which case TTree::ChangeFile() already closed &
+      // deleted original output file
+      TFile *const curFile = outTree->GetCurrentFile();
+      curFile->Write();
+      curFile->Close();
+      if (curFile != outFile.get()) {
+        outFile.release();
+        delete curFile;
+      }
+
+      ostringstream tmp;
+      tmp << first << " " << last;
+      result = tmp.str();
+    }
+
+    void setResult(const string &result) {
+      istringstream tmp(result);
+      tmp >> eventFirst >> eventLast;
+    }
+
+    /// 1st & last event id written to this part
+    unsigned eventFirst;
+    unsigned eventLast;
+
+  private:
+    const string m_inpFname;
+    const string m_outFname;
+
+    const RootFileAnalysis::EntryRange m_range;
+  };
+}
+
 int main(const int argc, const char **argv)
 {
-  if(argc!= 4)
+  if(argc!= 4 && argc!= 5)
     {
-      cout << "Usage: splitDigi.exe <input filename> <base output filename> <number of even parts>" << endl;
+      cout << "Usage: splitDigi.exe <input filename> <base output filename> <number of parts> [number of processes]" << endl;
       cout << "       for 2nd argument type something like 'inl_calibElement'. Part number and" << endl;
       cout << "       file's extension will be added" << endl;
+      cout << "       parts differ in size by at most 1 event, all parts are written" << endl;
+      cout << "       concurrently unless number of processes is given" << endl;
       exit(0);
     }
 
   const string inpFname= argv[1];
   const string outFname= argv[2];
   const unsigned  nParts= atoi(argv[3]);
+  const unsigned  nProcs= (argc== 5) ? atoi(argv[4]) : nParts;
 
+  if (nParts < 1 || nProcs < 1) {
+    cout << __FILE__ ": number of parts & processes must be positive" << endl;
+    return -1;
+  }
 
-
-  long N_totl, N_part;
-  unsigned  i, j, j0, j1;
+  unsigned  i;
 
   char buffer[3];
   vector<string> element(nParts);
@@ -66,72 +163,39 @@ int main(const int argc, const char **argv)
            << codeDigiEventVer << endl;
   }
       
-  inp0.SetBranchStatus("*", 1);      // enable all branches in original tree
-  N_totl= inp0.GetEntries();         // total number of events in original file
-  N_part= (int)(N_totl/nParts);
-
-  if(N_totl%nParts!= 0) { cout << "given number of parts cannot split the file evenly..\a" << endl; exit(0); }
+  const UInt_t N_totl= inp0.GetEntries();         // total number of events in original file
+  if(N_totl%nParts!= 0) cout << "given number of parts cannot split the file evenly, parts differ by 1 event" << endl;
 
-  j0= 0; j1= N_part;
+  const vector<RootFileAnalysis::EntryRange> ranges(RootFileAnalysis::partitionEntries(N_totl, nParts));
 
   // generate element output filenames
   vector<string> elementFilenames(nParts);
   for(i= 0; i < nParts; i++)
     elementFilenames[i] = outFname+"."+element[i]+".root";
 
+  vector<SplitTask*> parts;
   for(i= 0; i < nParts; i++)
     {
       cout << "creating file " << elementFilenames[i] << endl;
-
-      TFile out0(elementFilenames[i].c_str(), "RECREATE");
-
-      TTree* t1= inp0.CloneTree(0);  // clone original tree, but
-      // do not copy any events yet
-      for(j= j0; j < j1; j++)
-        {
-          if (j % 1000 == 0)
-            cout << "Processing event: " << j << endl;
-          inp0.GetEntry(j);
-          t1->Fill();
-        }
-
-      t1->Write();
-      out0.Close();
-
-      j0+= N_part;
-      j1+= N_part;
+      parts.push_back(new SplitTask(inpFname, elementFilenames[i], ranges[i]));
     }
 
-  //----- check events ranges
+  try {
+    runProcessTasks(vector<ProcessTask*>(parts.begin(), parts.end()), nProcs);
+  } catch (exception &e) {
+    cout << __FILE__ ": exception thrown: " << e.what() << endl;
+    for(i= 0; i < parts.size(); i++)
+      delete parts[i];
+    return -1;
+  }
 
-  vector<string> rootFileList;
+  //----- check events ranges
 
   cout << "-------- check events ranges --------" << endl;
   for(i= 0; i < nParts; i++)
     {
-      rootFileList.clear();
-      rootFileList.push_back(elementFilenames[i].c_str());
-      RootFileAnalysis rootFile(0, &rootFileList, 0);
-
-      //----- enable only needed branches
-
-      rootFile.getDigiChain()->SetBranchStatus("*", 0);
-      rootFile.getDigiChain()->SetBranchStatus("m_eventId");
-
-      unsigned eventFirst=0, eventLast=0;
-      unsigned eventn, nEvents= rootFile.getDigiChain()->GetEntries();
-
-      for(j= 0; j < nEvents; j++)
-        {
-          if(!rootFile.getEvent(j)) { cout << "!cannot! read event:     " << j << endl; continue; }
-
-          const DigiEvent *digiEvent= rootFile.getDigiEvent();
-          if(!digiEvent)            { cout << "!cannot! read DigiEvent: " << j  << endl; continue; }
-
-          eventn= digiEvent->getEventId();
-          if(j== 0)         eventFirst= eventn;
-          if(j== nEvents-1) eventLast=  eventn;
-        }
-      cout << elementFilenames[i] << " " << nEvents<< " events, " << eventFirst << " - " << eventLast << endl;
+      cout << elementFilenames[i] << " " << ranges[i].size() << " events, "
+           << parts[i]->eventFirst << " - " << parts[i]->eventLast << endl;
+      delete parts[i];
     }
 }
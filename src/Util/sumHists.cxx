@@ -10,76 +10,124 @@
 
     @input: list of digi root files on commandline
     @output: single digi root file with all histograms from input files, histograms w/ same name & path are summed.
+
+    '-j nProcs' selects in memory merge mode: inputs are read by nProcs
+    concurrent worker processes (ROOT I/O is not thread safe), each
+    worker sums a contiguous block of inputs in memory into a temporary
+    partial sum file, partial sums are combined by pairwise tree
+    reduction (also in worker processes) & each merged histogram is
+    written to output exactly once.
+
+    default mode streams one histogram at a time from each input file
+    into output, so memory use is bounded by largest single histogram.
 */
 
+// LOCAL INCLUDES
+#include "src/lib/Util/ProcessUtil.h"
+
 
 // EXTLIB INCLUDES
 #include "TFile.h"
 #include "TIterator.h"
 #include "TClass.h"
 #include "TH1.h"
+#include "TKey.h"
 #include "TROOT.h"
 
 // STD INCLUDES
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
 #include <iostream>
+#include <stdexcept>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
 
 
 using namespace std;
+using namespace calibGenCAL;
 
 namespace {
 
 
-  ///   Recursively add all histograms and directories in inputDir to outputDir.
-  //    Any histograms with same name & path will be summed within outputDir
+  /// read single histogram from key, detached from any directory
+  /// \return NULL (w/ warning) if object can not be read
+  TH1 *readHist(TKey &key) {
+    TH1 *const hist = (TH1*)key.ReadObj();
+    if (hist == 0) {
+      cout << "WARNING: unable to read histogram, skipping: "
+           << key.GetName() << ";" << key.GetCycle() << endl;
+      return 0;
+    }
+
+    hist->SetDirectory(0);
+    return hist;
+  }
+
+  /// recursively sum all histograms in inputDir into outputDir
+  ///
+  /// walks input one TKey at a time, so only the current output
+  /// histogram & one input histogram are resident at once.  both are
+  /// deleted as soon as the sum has been written.
+  /// \note only highest cycle of each key is used
   void sumDir(TDirectory &outputDir,
               TDirectory &inputDir) {
+    TIter nextKey(inputDir.GetListOfKeys());
+    set<string> seen;
+    TKey *key;
+    while ((key = (TKey*)nextKey()) != 0) {
+      const string name(key->GetName());
+      // keys are sorted by decreasing cycle
+      if (!seen.insert(name).second)
+        continue;
 
-    /// don't know if inputDir is TFile or TDirectory, simplest is to
-    /// treat all as if TDirectory, if I want to do this, I need to read
-    /// all objs into memory (otherwise I would have to use
-    /// GetListOfKeys() instead of GetList())
-    ///
-    /// if you know a better way, don't be shy!
-    inputDir.ReadAll();
-
-    TIterator *it = inputDir.GetList()->MakeIterator();
-    TObject *obj;
-    while ((obj = (TObject*)it->Next()) != 0) {
-      TClass *cls = gROOT->GetClass(obj->ClassName());
+      TClass *const cls = TClass::GetClass(key->GetClassName());
+      if (cls == 0)
+        continue;
 
       /// CASE 1: Obj is histogram
-      if (cls->InheritsFrom("TH1")) {
-        TH1 *hnew = (TH1*)obj;
-        TH1 *hout = 0;
-        const string hname(obj->GetName());
+      if (cls->InheritsFrom(TH1::Class())) {
+        TH1 *const hnew = readHist(*key);
+        if (hnew == 0)
+          continue;
+
+        TKey *const outKey = outputDir.GetKey(name.c_str());
+
+        outputDir.cd();
         /// CASE 1A: histogram already exist
-        if ((hout = (TH1*)outputDir.Get(hname.c_str())) != 0) {
-          cout << "Summing to existing histogram: " << inputDir.GetPathStatic() << "/" << hname << endl;
+        if (outKey != 0) {
+          cout << "Summing to existing histogram: " << inputDir.GetPathStatic() << "/" << name << endl;
+          TH1 *const hout = readHist(*outKey);
+          if (hout == 0) {
+            delete hnew;
+            continue;
+          }
           hout->Add(hnew);
-          outputDir.cd();
-          hout->Write(0,TObject::kOverwrite);
+          hout->Write(name.c_str(), TObject::kOverwrite);
+          delete hout;
         }
         
         /// CASE 1B: histogram does not already exit
         else {
-          cout << "Adding new histogram: " << inputDir.GetPathStatic() << "/" << hname << endl;
-          outputDir.Add(hnew);
-          outputDir.cd();
-          hnew->Write();
+          cout << "Adding new histogram: " << inputDir.GetPathStatic() << "/" << name << endl;
+          hnew->Write(name.c_str());
         }
+
+        delete hnew;
       }
 
       /// CASE 2: Obj is directory
-      else if (cls->InheritsFrom("TDirectory")) {
-        TDirectory *const dnew = (TDirectory*)obj;
-        char const*const dname = dnew->GetName();
+      else if (cls->InheritsFrom(TDirectory::Class())) {
+        TDirectory *const dnew = inputDir.GetDirectory(name.c_str());
+        if (dnew == 0)
+          continue;
 
         /// make subdir if it doesn't already exit
-        TDirectory * dout = outputDir.GetDirectory(dname);
+        TDirectory * dout = outputDir.GetDirectory(name.c_str());
         if (dout == 0)
-          dout = outputDir.mkdir(dname);
+          dout = outputDir.mkdir(name.c_str());
 
         /// recursively process subdirs
         sumDir(*dout, *dnew);
@@ -87,9 +135,287 @@ namespace {
     }
   }
 
+  /// histograms & directories summed over 1 or more input files, kept
+  /// in memory in order of first appearance
+  class HistTree {
+  public:
+    HistTree() {}
+
+    ~HistTree() {
+      for (unsigned i = 0; i < m_entries.size(); i++)
+        delete m_entries[i].hist;
+    }
+
+    /// recursively add all histograms & directories in inputDir, where
+    /// inputDir is at dirPath relative to top level of file.
+    /// histograms w/ same path are summed.
+    /// \note only highest cycle of each key is used
+    void addDir(TDirectory &inputDir,
+                const string &dirPath) {
+      TIter nextKey(inputDir.GetListOfKeys());
+      set<string> seen;
+      TKey *key;
+      while ((key = (TKey*)nextKey()) != 0) {
+        const string name(key->GetName());
+        // keys are sorted by decreasing cycle
+        if (!seen.insert(name).second)
+          continue;
+
+        TClass *const cls = TClass::GetClass(key->GetClassName());
+        if (cls == 0)
+          continue;
+
+        /// CASE 1: Obj is histogram
+        if (cls->InheritsFrom(TH1::Class())) {
+          TH1 *const hist = readHist(*key);
+          if (hist != 0)
+            addHist(dirPath, name, hist);
+        }
+
+        /// CASE 2: Obj is directory
+        else if (cls->InheritsFrom(TDirectory::Class())) {
+          TDirectory *const subDir = inputDir.GetDirectory(name.c_str());
+          if (subDir == 0)
+            continue;
+
+          const string path(joinPath(dirPath, name));
+          addEntry(path, dirPath, name, 0);
+          addDir(*subDir, path);
+        }
+      }
+    }
+
+    /// write all directories & histograms to outputDir
+    void write(TDirectory &outputDir) const {
+      map<string, TDirectory*> dirs;
+      dirs[""] = &outputDir;
+
+      for (unsigned i = 0; i < m_entries.size(); i++) {
+        const Entry &entry = m_entries[i];
+        // parent always precedes its contents
+        TDirectory *const parent = dirs[entry.dirPath];
+
+        if (entry.hist == 0) {
+          TDirectory *dout = parent->GetDirectory(entry.name.c_str());
+          if (dout == 0)
+            dout = parent->mkdir(entry.name.c_str());
+          dirs[joinPath(entry.dirPath, entry.name)] = dout;
+        } else {
+          parent->cd();
+          entry.hist->Write(entry.name.c_str());
+        }
+      }
+    }
+
+    unsigned getNHists() const {
+      unsigned nHists = 0;
+      for (unsigned i = 0; i < m_entries.size(); i++)
+        if (m_entries[i].hist != 0)
+          nHists++;
+      return nHists;
+    }
+
+  private:
+    /// single directory (hist == 0) or histogram
+    struct Entry {
+      string dirPath;
+      string name;
+      TH1 *hist;
+    };
+
+    static string joinPath(const string &dirPath,
+                           const string &name) {
+      return dirPath.empty() ? name : dirPath + "/" + name;
+    }
+
+    /// append new entry
+    /// \return false if path is already present
+    bool addEntry(const string &path,
+                  const string &dirPath,
+                  const string &name,
+                  TH1 *const hist) {
+      if (m_index.find(path) != m_index.end())
+        return false;
+
+      m_index[path] = m_entries.size();
+      m_entries.push_back(Entry());
+      m_entries.back().dirPath = dirPath;
+      m_entries.back().name    = name;
+      m_entries.back().hist    = hist;
+      return true;
+    }
+
+    /// sum hist into existing histogram w/ same path, or take ownership
+    /// of hist if it is new.
+    void addHist(const string &dirPath,
+                 const string &name,
+                 TH1 *const hist) {
+      const string path(joinPath(dirPath, name));
+      if (addEntry(path, dirPath, name, hist))
+        return;
+
+      TH1 *const hout = m_entries[m_index[path]].hist;
+      if (hout != 0)
+        hout->Add(hist);
+      delete hist;
+    }
+
+    vector<Entry> m_entries;
+
+    /// index into m_entries for each path
+    map<string, unsigned> m_index;
+
+    /// disabled
+    HistTree(const HistTree &);
+    /// disabled
+    HistTree &operator=(const HistTree &);
+  };
+
+  /// temporary partial sum file for given block
+  string partPath(const string &outputPath,
+                  const unsigned block) {
+    ostringstream tmp;
+    tmp << outputPath << ".part" << block << ".root";
+    return tmp.str();
+  }
+
+  /// write tree to new ROOT file at path
+  void writeTree(const HistTree &tree,
+                 const string &path) {
+    TFile fout(path.c_str(), "RECREATE");
+    if (fout.IsZombie())
+      throw runtime_error("Unable to create file: " + path);
+
+    tree.write(fout);
+    fout.Close();
+  }
+
+  /// add all histograms in ROOT file at path to tree
+  void readTree(HistTree &tree,
+                const string &path) {
+    TFile fin(path.c_str(), "READ");
+    if (fin.IsZombie())
+      throw runtime_error("Unable to open input file: " + path);
+
+    tree.addDir(fin, "");
+  }
+
+  /// sum contiguous block of input files into temporary file
+  class ReadTask : public ProcessTask {
+  public:
+    ReadTask(const vector<string> &inputPaths,
+             const unsigned begin,
+             const unsigned end,
+             const string &outPath) :
+      m_inputPaths(inputPaths.begin() + begin,
+                   inputPaths.begin() + end),
+      m_outPath(outPath)
+    {}
+
+    void run(string &) {
+      HistTree tree;
+      for (unsigned nFile = 0; nFile < m_inputPaths.size(); nFile++)
+        readTree(tree, m_inputPaths[nFile]);
+
+      writeTree(tree, m_outPath);
+    }
+
+  private:
+    const vector<string> m_inputPaths;
+
+    const string m_outPath;
+  };
+
+  /// sum 2nd temporary file into 1st
+  class MergeTask : public ProcessTask {
+  public:
+    MergeTask(const string &destPath,
+              const string &srcPath) :
+      m_destPath(destPath),
+      m_srcPath(srcPath)
+    {}
+
+    void run(string &) {
+      HistTree tree;
+      readTree(tree, m_destPath);
+      readTree(tree, m_srcPath);
+      writeTree(tree, m_destPath);
+    }
+
+  private:
+    const string m_destPath;
+    const string m_srcPath;
+  };
+
+  /// run all tasks & delete them
+  void runTasks(const vector<ProcessTask*> &tasks,
+                const unsigned nProcs) {
+    try {
+      runProcessTasks(tasks, nProcs);
+    } catch (...) {
+      for (unsigned i = 0; i < tasks.size(); i++)
+        delete tasks[i];
+      throw;
+    }
+
+    for (unsigned i = 0; i < tasks.size(); i++)
+      delete tasks[i];
+  }
+
+  /// in memory merge mode, see file description
+  void treeSum(TDirectory &outputDir,
+               const string &outputPath,
+               const vector<string> &inputPaths,
+               const unsigned nProcs) {
+    const unsigned nInputs = inputPaths.size();
+    const unsigned nBlocks = min(nProcs, nInputs);
+
+    vector<string> partPaths;
+    for (unsigned i = 0; i < nBlocks; i++)
+      partPaths.push_back(partPath(outputPath, i));
+
+    try {
+      vector<ProcessTask*> readTasks;
+      for (unsigned i = 0; i < nBlocks; i++)
+        readTasks.push_back(new ReadTask(inputPaths,
+                                         i*nInputs/nBlocks,
+                                         (i+1)*nInputs/nBlocks,
+                                         partPaths[i]));
+
+      cout << "Reading " << nInputs << " input files w/ "
+           << nBlocks << " processes" << endl;
+      runTasks(readTasks, nProcs);
+
+      // pairwise tree reduction, result ends up in 1st block
+      for (unsigned step = 1; step < nBlocks; step *= 2) {
+        vector<ProcessTask*> mergeTasks;
+        for (unsigned i = 0; i + step < nBlocks; i += 2*step)
+          mergeTasks.push_back(new MergeTask(partPaths[i],
+                                             partPaths[i + step]));
+
+        runTasks(mergeTasks, nProcs);
+      }
+
+      HistTree tree;
+      readTree(tree, partPaths[0]);
+
+      cout << "Writing " << tree.getNHists()
+           << " summed histograms" << endl;
+      tree.write(outputDir);
+    } catch (...) {
+      for (unsigned i = 0; i < partPaths.size(); i++)
+        remove(partPaths[i].c_str());
+      throw;
+    }
+
+    for (unsigned i = 0; i < partPaths.size(); i++)
+      remove(partPaths[i].c_str());
+  }
+
   const string usage_str = 
-  "sumHists.cxx outputPath.root [inputPath.root]+\n"
+  "sumHists.cxx [-j nProcs] outputPath.root [inputPath.root]+\n"
   "where: \n"
+  " nProcs          = (optional) sum inputs in memory w/ n concurrent processes, write output once\n"
   " outputPath.root = output ROOT file\n"
   " inputPath.root  = list of 1 or more input ROOT files";
   
@@ -111,22 +437,50 @@ namespace {
 }
 
 int main(const int argc, char const*const*const argv) {
+  /// optional process count selects in memory merge mode
+  int firstArg = 1;
+  unsigned nProcs = 0;
+  if (argc > 2 && string(argv[1]) == "-j") {
+    nProcs = atoi(argv[2]);
+    firstArg = 3;
+    if (nProcs < 1) {
+      cout << "Invalid process count: " << argv[2] << endl;
+      cout << usage_str << endl;
+      return -1;
+    }
+  }
+
   /// check commandline
-  if (argc < 3) {
+  if (argc - firstArg < 2) {
     cout << "Not enough paramters: " << endl;
     cout << usage_str << endl;
     return -1;
   }
 
   /// retrieve commandline args
-  const string outputPath(argv[1]);
+  const string outputPath(argv[firstArg]);
   vector<string> inputPaths;
   /// get input files from commandline
-  inputPaths.insert(inputPaths.end(), &argv[2], &argv[argc]);
+  inputPaths.insert(inputPaths.end(), &argv[firstArg+1], &argv[argc]);
   
   cout << "Opening output file: " << outputPath << endl;
   TFile outputFile(outputPath.c_str(), "RECREATE");
 
+  if (nProcs > 0) {
+    // histograms are owned by HistTree, not by any input file
+    TH1::AddDirectory(kFALSE);
+
+    try {
+      treeSum(outputFile, outputPath, inputPaths, nProcs);
+    } catch (exception &e) {
+      cout << "sumHists: exception thrown: " << e.what() << endl;
+      return -1;
+    }
+
+    outputFile.Close();
+    return 0;
+  }
+
   /// loop through each input
   for (unsigned nFile = 0; nFile < inputPaths.size(); nFile++) {
     const string inputPath = inputPaths[nFile];
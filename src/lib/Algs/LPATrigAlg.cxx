@@ -5,7 +5,6 @@
 */
 
 // LOCAL INCLUDES
-#include "src/lib/Util/RootFileAnalysis.h"
 #include "LPATrigAlg.h"
 #include "src/lib/Util/ROOTUtil.h"
 #include "src/lib/Util/CGCUtil.h"
@@ -34,11 +33,37 @@ namespace calibGenCAL {
   using namespace CalUtil;
   using namespace std;
 
-  void LPATrigAlg::cfgBranches(RootFileAnalysis &rootFile) {
-    // enable only needed branches in root file
-    rootFile.getDigiChain()->SetBranchStatus("*", 0);
-    rootFile.getDigiChain()->SetBranchStatus("m_calDigiCloneCol");                                                  
-    rootFile.getDigiChain()->SetBranchStatus("m_calDiagnosticCloneCol");
+  void LPATrigAlg::fillHists(const unsigned nEntries,
+                             const std::vector<std::string> &digiFileList) {
+    initConsumer(nEntries);
+
+    FusedDigiLoop digiLoop(digiFileList);
+    digiLoop.addConsumer(*this);
+    digiLoop.run();
+  }
+
+  void LPATrigAlg::getDigiBranches(vector<string> &branches) const {
+    branches.push_back("m_calDigiCloneCol");
+    branches.push_back("m_calDiagnosticCloneCol");
+  }
+
+  void LPATrigAlg::initConsumer(const unsigned nEntries) {
+    m_trigEntries.reset();
+    m_trigEntries.setTarget(nEntries);
+    eventData.init();
+  }
+
+  bool LPATrigAlg::consumeEvent(const unsigned eventNum,
+                                const DigiEvent &digiEvent) {
+    // quit if we have enough entries in each histogram
+    if (m_trigEntries.targetReached())
+      return false;
+
+    eventData.clear();
+    eventData.m_eventNum = eventNum;
+
+    processEvent(digiEvent);
+    return !m_trigEntries.targetReached();
   }
 
   /// fill eventData.m_diagTrigBits with diagnostic data from given event
@@ -9,6 +9,8 @@
 // LOCAL INCLUDES
 #include "src/lib/Util/CalSignalArray.h"
 #include "src/lib/Hists/TrigHists.h"
+#include "src/lib/Hists/MinEntriesTracker.h"
+#include "src/lib/Util/FusedDigiLoop.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
@@ -29,12 +31,11 @@ namespace CalUtil {
 };
 
 namespace calibGenCAL {
-  class RootFileAnalysis;
 
   /** \brief Abstract algorithm class fill & fit Trigger threshold histograms.
       @author Zachary Fewtrell
   */
-  class LPATrigAlg {
+  class LPATrigAlg : public DigiEventConsumer {
   public:
 
     /// Specify which trigger channels have been enabled.
@@ -71,12 +72,22 @@ namespace calibGenCAL {
     /// Fill histograms w/ nEvt event data
     /// @param nEntrries minimum number of entries in each histogram before quitting
     /// @param digiFileList list of digi files to process
-    virtual void fillHists(const unsigned nEntries,
-                           const std::vector<std::string> &digiFileList) = 0;
+    void fillHists(const unsigned nEntries,
+                   const std::vector<std::string> &digiFileList);
+
+    /// prepare for consumeEvent() calls from external FusedDigiLoop
+    /// @param nEntrries minimum number of entries in each histogram before quitting
+    void initConsumer(const unsigned nEntries);
+
+    /// DigiEventConsumer interface
+    void getDigiBranches(std::vector<std::string> &branches) const;
+
+    /// DigiEventConsumer interface
+    /// \pre initConsumer() has been called
+    bool consumeEvent(const unsigned eventNum,
+                      const DigiEvent &digiEvent);
 
   protected:
-    /// setup needed branches for input ROOT files
-    virtual void cfgBranches(RootFileAnalysis &rootFile);
 
     /// check that channel is enabled for given LAT configuration
     virtual bool channelEnabled(const CalUtil::FaceIdx faceIdx);
@@ -114,6 +125,9 @@ namespace calibGenCAL {
 
     /// output histograms
     TrigHists &m_trigHists;
+
+    /// fills per m_trigHists channel (early stop check)
+    MinEntriesTracker<CalUtil::FaceIdx> m_trigEntries;
     
     /// store cfg & status data pertinent to current algorithm run
     struct EventData {
@@ -6,6 +6,9 @@
 
 // LOCAL INCLUDES
 #include "src/lib/Util/RootFileAnalysis.h"
+#include "src/lib/Util/ShardedEventLoop.h"
+#include "src/lib/Util/CalSkimCache.h"
+#include "src/lib/Util/ProcessUtil.h"
 #include "MuonPedAlg.h"
 #include "src/lib/Util/ROOTUtil.h"
 #include "src/lib/Util/CGCUtil.h"
@@ -25,23 +28,241 @@
 // STD INCLUDES
 #include <sstream>
 #include <cmath>
+#include <memory>
 
 namespace calibGenCAL {
 
   using namespace CalUtil;
   using namespace std;
 
+  /// process one contiguous slice of event files into private histogram shard
+  class MuonPedAlg::RangeShard : public EventShard {
+  public:
+    RangeShard(const MuonPedAlg &parent,
+               const unsigned nEntries) :
+      m_pedShard(parent.algData.pedHists->newShard()),
+      m_nEntries(nEntries),
+      m_stopEvt(0),
+      m_stopPrev4Range(true)
+    {
+      m_alg.algData.roughPeds = parent.algData.roughPeds;
+      m_alg.algData.trigCut   = parent.algData.trigCut;
+      m_alg.algData.pedShard  = m_pedShard.get();
+      m_alg.algData.logStrm   = &m_log;
+    }
+
+    void cfgBranches(RootFileAnalysis &rootFile) {
+      m_alg.cfgBranches(rootFile);
+    }
+
+    void processRange(RootFileAnalysis &rootFile,
+                      const RootFileAnalysis::EntryRange &range) {
+      m_alg.seedReadoutMode(rootFile, range.begin);
+      m_stopEvt = m_alg.processRange(rootFile, range.begin, range.end, m_nEntries);
+      m_stopPrev4Range = m_alg.eventData.prev4Range;
+    }
+
+    void packResult(string &result) const {
+      packString(result, m_log.str());
+      packVal(result, m_stopEvt);
+      packVal(result, m_stopPrev4Range);
+      m_pedShard->pack(result);
+    }
+
+    void unpackResult(const string &result) {
+      ResultReader reader(result);
+
+      string log;
+      reader.readString(log);
+      m_log.str(log);
+
+      reader.read(m_stopEvt);
+      reader.read(m_stopPrev4Range);
+      m_pedShard->unpack(reader);
+
+      if (!reader.atEnd())
+        throw runtime_error("MuonPedAlg: invalid output from event shard");
+    }
+
+    const PedHists::shard_type &getShard() const {
+      return *m_pedShard;
+    }
+
+    /// 1st event not processed
+    unsigned getStopEvt() const {
+      return m_stopEvt;
+    }
+
+    /// readout mode of event before getStopEvt()
+    bool getStopPrev4Range() const {
+      return m_stopPrev4Range;
+    }
+
+    /// buffered diagnostic output
+    std::string getLog() const {
+      return m_log.str();
+    }
+
+  private:
+    MuonPedAlg m_alg;
+
+    auto_ptr<PedHists::shard_type> m_pedShard;
+
+    /// per shard entry target
+    const unsigned m_nEntries;
+
+    unsigned m_stopEvt;
+
+    bool m_stopPrev4Range;
+
+    ostringstream m_log;
+  };
+
+  class MuonPedAlg::SinglePassData {
+  public:
+    /// \param rootFileList NULL for FusedDigiLoop consumer mode
+    explicit SinglePassData(const vector<string> *rootFileList) :
+      rootFile((rootFileList) ? new RootFileAnalysis(0, rootFileList, 0) : 0),
+      nEvents(0),
+      endEvt(0),
+      buffering(true),
+      nEntries(0),
+      nFitWorkers(1),
+      roughPeds(0),
+      pedHists(0)
+    {}
+
+    /// single crystal hit which passed LEX8 check in rough pass
+    struct BufferedHit {
+      unsigned       eventNum;
+      XtalIdx        xtalIdx;
+      unsigned char  range[CalSkimBlock::READOUTS_PER_HIT];
+      unsigned short adc[CalSkimBlock::READOUTS_PER_HIT];
+    };
+
+    void addHit(const unsigned eventNum,
+                const XtalIdx xtalIdx,
+                const unsigned char *range,
+                const unsigned short *adc) {
+      hits.push_back(BufferedHit());
+      BufferedHit &hit = hits.back();
+      hit.eventNum = eventNum;
+      hit.xtalIdx  = xtalIdx;
+      copy(range, range + CalSkimBlock::READOUTS_PER_HIT, hit.range);
+      copy(adc, adc + CalSkimBlock::READOUTS_PER_HIT, hit.adc);
+    }
+
+    /// NULL in FusedDigiLoop consumer mode
+    auto_ptr<RootFileAnalysis> rootFile;
+
+    /// total # of input events
+    unsigned nEvents;
+
+    /// 1st event not read in rough pass
+    unsigned endEvt;
+
+    /// true while rough pass is running
+    bool buffering;
+
+    /// hits in event order
+    vector<BufferedHit> hits;
+
+    // consumer mode only (see initSinglePassConsumer())
+    unsigned nEntries;
+    unsigned nFitWorkers;
+    CalPed   *roughPeds;
+    PedHists *pedHists;
+  };
+
+  MuonPedAlg::~MuonPedAlg() {
+    delete m_singlePass;
+  }
+
   void MuonPedAlg::fillHists(const unsigned nEntries,
                              const vector<string> &rootFileList,
                              const CalUtil::CalPed *roughPeds,
                              PedHists &pedHists,
-                             const TRIGGER_CUT trigCut) {
+                             const TRIGGER_CUT trigCut,
+                             const unsigned nThreads) {
     /////////////////////////////////////////
     /// Initialize Object Data //////////////
     /////////////////////////////////////////
     algData.roughPeds = roughPeds;
     algData.trigCut   = trigCut;
     algData.pedHists = &pedHists;
+    algData.logStrm  = &LogStrm::get();
+    algData.pedEntries.reset();
+
+    if (nThreads > 1) {
+      /////////////////////////////////////////
+      /// Sharded Event Loop //////////////////
+      /////////////////////////////////////////
+      // each shard stops at ceil(nEntries/nThreads) entries per histogram,
+      // so the sum over all shards reaches >= nEntries for each channel
+      // which reached its target.
+      const unsigned shardEntries = (nEntries + nThreads - 1) / nThreads;
+
+      vector<RangeShard*> shards;
+      for (unsigned i = 0; i < nThreads; i++)
+        shards.push_back(new RangeShard(*this, shardEntries));
+
+      try {
+        ShardedEventLoop eventLoop(0, &rootFileList);
+        const vector<RootFileAnalysis::EntryRange> ranges(eventLoop.run(vector<EventShard*>(shards.begin(),
+                                                                                              shards.end())));
+
+        // merge in shard (event) order
+        for (unsigned i = 0; i < shards.size(); i++) {
+          LogStrm::get() << shards[i]->getLog();
+
+          const PedHists::shard_type &pedShard = shards[i]->getShard();
+          pedHists.mergeShard(pedShard);
+
+          const vector<RngIdx> &filled = pedShard.getFilledIdx();
+          for (unsigned n = 0; n < filled.size(); n++)
+            algData.pedEntries.add(filled[n], pedShard.getEntries(filled[n]));
+        }
+
+        /////////////////////////////////////////
+        /// Top up from unread events ///////////
+        /////////////////////////////////////////
+        // a channel which is rare in some ranges may still be short of
+        // nEntries after the merge, continue w/ events left unread by
+        // shards which stopped early, in range order.
+        algData.pedEntries.setTarget(nEntries);
+        auto_ptr<RootFileAnalysis> rootFile;
+        for (unsigned i = 0; i < shards.size() && !algData.pedEntries.targetReached(); i++) {
+          const unsigned stopEvt = shards[i]->getStopEvt();
+          if (stopEvt >= ranges[i].end)
+            continue;
+
+          if (!rootFile.get()) {
+            rootFile.reset(eventLoop.newReader());
+            cfgBranches(*rootFile);
+          }
+
+          LogStrm::get() << __FILE__ << ": min entries per histogram: "
+                         << algData.pedEntries.getMinEntries()
+                         << ", continuing w/ events " << stopEvt << "-" << ranges[i].end
+                         << endl;
+
+          eventData = EventData();
+          eventData.prev4Range = shards[i]->getStopPrev4Range();
+          processRange(*rootFile, stopEvt, ranges[i].end, nEntries);
+        }
+      } catch (...) {
+        for (unsigned i = 0; i < shards.size(); i++) {
+          LogStrm::get() << shards[i]->getLog();
+          delete shards[i];
+        }
+        throw;
+      }
+
+      for (unsigned i = 0; i < shards.size(); i++)
+        delete shards[i];
+
+      return;
+    }
 
     /////////////////////////////////////////
     /// Open ROOT Event File  ///////////////
@@ -50,92 +271,392 @@ namespace calibGenCAL {
                               &rootFileList,
                               0);
 
-    // enable only needed branches in root file
-    rootFile.getDigiChain()->SetBranchStatus("*", 0);
-    rootFile.getDigiChain()->SetBranchStatus("m_calDigiCloneCol");
-    if (algData.trigCut == PERIODIC_TRIGGER)
-      rootFile.getDigiChain()->SetBranchStatus("m_summary");
-    if (algData.trigCut == PERIODIC_TRIGGER || algData.trigCut == EXTERNAL_TRIGGER)
-      rootFile.getDigiChain()->SetBranchStatus("m_gem");
+    cfgBranches(rootFile);
 
     const unsigned nEvents = rootFile.getEntries();
     LogStrm::get() << __FILE__ << ": Processing: " << nEvents << " events." << endl;
 
+    processRange(rootFile, 0, nEvents, nEntries);
+  }
+
+  void MuonPedAlg::fillRoughHists(const unsigned nEntries,
+                                  const vector<string> &rootFileList,
+                                  PedHists &roughPedHists,
+                                  const TRIGGER_CUT trigCut) {
+    algData.roughPeds = 0;
+    algData.trigCut   = trigCut;
+    algData.pedHists  = &roughPedHists;
+    algData.logStrm   = &LogStrm::get();
+    algData.pedEntries.reset();
+
+    delete m_singlePass;
+    m_singlePass = new SinglePassData(&rootFileList);
+    RootFileAnalysis &rootFile = *m_singlePass->rootFile;
+
+    cfgBranches(rootFile);
+
+    m_singlePass->nEvents = rootFile.getEntries();
+    LogStrm::get() << __FILE__ << ": Processing: " << m_singlePass->nEvents << " events." << endl;
+
+    m_singlePass->endEvt = processRange(rootFile, 0, m_singlePass->nEvents, nEntries);
+    m_singlePass->buffering = false;
+
+    // reader stays open for fillCutHists(), but caller fits rough
+    // peds in fork()ed workers before then: no threads may be running.
+    rootFile.disableReadAhead();
+
+    LogStrm::get() << __FILE__ << ": Buffered " << m_singlePass->hits.size()
+                   << " hits from " << m_singlePass->endEvt << " events." << endl;
+  }
+
+  void MuonPedAlg::fillCutHists(const unsigned nEntries,
+                                const CalUtil::CalPed &roughPeds,
+                                PedHists &pedHists) {
+    if (!m_singlePass || !m_singlePass->rootFile.get())
+      throw runtime_error("MuonPedAlg::fillCutHists() called w/out prior fillRoughHists()");
+
+    algData.roughPeds = &roughPeds;
+    algData.pedHists  = &pedHists;
+    algData.pedEntries.reset();
+    algData.pedEntries.setTarget(nEntries);
+
+    /////////////////////////////////////////
+    /// Continue w/ unread events ///////////
+    /////////////////////////////////////////
+    // trigger cut state (previous event readout mode) carries over from
+    // rough pass, which stopped just before endEvt.
+    if (!replayHits())
+      processRange(*m_singlePass->rootFile,
+                   m_singlePass->endEvt,
+                   m_singlePass->nEvents,
+                   nEntries);
+
+    delete m_singlePass;
+    m_singlePass = 0;
+  }
+
+  bool MuonPedAlg::replayHits() {
+    ostream &logStrm = *algData.logStrm;
+    const vector<SinglePassData::BufferedHit> &hits = m_singlePass->hits;
+
+    // entry count is checked at each event boundary, as in processRange(),
+    // so that we stop on the same event as a 2nd pass over the input would.
+    unsigned nextLogEvt = 0;
+    for (unsigned nHit = 0; nHit < hits.size(); nHit++) {
+      const unsigned eventNum = hits[nHit].eventNum;
+      if (nHit == 0 || eventNum != hits[nHit-1].eventNum) {
+        if (algData.pedEntries.targetReached())
+          return true;
+
+        if (eventNum >= nextLogEvt) {
+          logStrm << "Event: " << eventNum
+                  << " min entries per histogram: " << algData.pedEntries.getMinEntries()
+                  << endl;
+          logStrm.flush();
+          nextLogEvt = eventNum - eventNum % 2000 + 2000;
+        }
+      }
+
+      eventData.eventNum = eventNum;
+      processHit(hits[nHit].xtalIdx,
+                 CalSkimBlock::MAX_READOUTS,
+                 hits[nHit].range,
+                 hits[nHit].adc);
+    }
+
+    return algData.pedEntries.targetReached();
+  }
+
+  void MuonPedAlg::getDigiBranches(vector<string> &branches) const {
+    branches.push_back("m_calDigiCloneCol");
+    if (algData.trigCut == PERIODIC_TRIGGER)
+      branches.push_back("m_summary");
+    if (algData.trigCut == PERIODIC_TRIGGER || algData.trigCut == EXTERNAL_TRIGGER)
+      branches.push_back("m_gem");
+  }
+
+  void MuonPedAlg::cfgBranches(RootFileAnalysis &rootFile) const {
+    // enable only needed branches in root file
+    rootFile.getDigiChain()->SetBranchStatus("*", 0);
+
+    vector<string> branches;
+    getDigiBranches(branches);
+    for (unsigned i = 0; i < branches.size(); i++)
+      rootFile.getDigiChain()->SetBranchStatus(branches[i].c_str());
+
+    // event loop only fills PedHists (HistVec) or shard, fits run w/
+    // read ahead stopped (see fillRoughHists())
+    rootFile.useDefaultReadAhead();
+  }
+
+  void MuonPedAlg::initConsumer(const unsigned nEntries,
+                                const CalUtil::CalPed *roughPeds,
+                                PedHists &pedHists,
+                                const TRIGGER_CUT trigCut) {
+    algData.roughPeds = roughPeds;
+    algData.trigCut   = trigCut;
+    algData.pedHists  = &pedHists;
+    algData.logStrm   = &LogStrm::get();
+    algData.pedEntries.reset();
+    algData.pedEntries.setTarget(nEntries);
+
+    eventData = EventData();
+
+    delete m_singlePass;
+    m_singlePass = 0;
+  }
+
+  void MuonPedAlg::initSinglePassConsumer(const unsigned nEntries,
+                                          PedHists &roughPedHists,
+                                          CalUtil::CalPed &roughPeds,
+                                          PedHists &pedHists,
+                                          const TRIGGER_CUT trigCut,
+                                          const unsigned nFitWorkers) {
+    initConsumer(nEntries, 0, roughPedHists, trigCut);
+
+    m_singlePass = new SinglePassData(0);
+    m_singlePass->nEntries    = nEntries;
+    m_singlePass->nFitWorkers = nFitWorkers;
+    m_singlePass->roughPeds   = &roughPeds;
+    m_singlePass->pedHists    = &pedHists;
+  }
+
+  bool MuonPedAlg::consumeEvent(const unsigned eventNum,
+                                const DigiEvent &digiEvent) {
+    // step over unread events, as processRange() does, so that
+    // previous event readout mode state is unchanged.
+    while (eventData.eventNum < eventNum)
+      eventData.next();
+
+    if (algData.pedEntries.targetReached())
+      return false;
+
+    processEvent(digiEvent);
+
+    // rough pass complete, runIdleWork() switches to cut pass before
+    // next event
+    return !algData.pedEntries.targetReached() || hasIdleWork();
+  }
+
+  bool MuonPedAlg::hasIdleWork() const {
+    return m_singlePass && m_singlePass->buffering &&
+      algData.pedEntries.targetReached();
+  }
+
+  void MuonPedAlg::runIdleWork() {
+    if (hasIdleWork())
+      endRoughPass();
+  }
+
+  void MuonPedAlg::finishConsumer() {
+    // input ended before rough histograms were full
+    if (m_singlePass && m_singlePass->buffering)
+      endRoughPass();
+
+    delete m_singlePass;
+    m_singlePass = 0;
+  }
+
+  void MuonPedAlg::endRoughPass() {
+    SinglePassData &singlePass = *m_singlePass;
+    singlePass.buffering = false;
+
+    ostream &logStrm = *algData.logStrm;
+    logStrm << __FILE__ << ": Buffered " << singlePass.hits.size()
+            << " hits from rough pass, fitting rough pedestals." << endl;
+
+    PedHists &roughPedHists = *algData.pedHists;
+    roughPedHists.trimHists();
+    roughPedHists.fitHists(*singlePass.roughPeds, singlePass.nFitWorkers);
+
+    algData.roughPeds = singlePass.roughPeds;
+    algData.pedHists  = singlePass.pedHists;
+    algData.pedEntries.reset();
+    algData.pedEntries.setTarget(singlePass.nEntries);
+
+    // replay changes event # only, readout mode state carries over to
+    // next event as in fillCutHists()
+    const unsigned eventNum = eventData.eventNum;
+    logStrm << __FILE__ << ": replaying buffered rough pass hits" << endl;
+    replayHits();
+    eventData.eventNum = eventNum;
+
+    // release buffer
+    vector<SinglePassData::BufferedHit>().swap(singlePass.hits);
+  }
+
+  unsigned MuonPedAlg::processRange(RootFileAnalysis &rootFile,
+                                    const unsigned beginEvt,
+                                    const unsigned endEvt,
+                                    const unsigned nEntries) {
+    ostream &logStrm = *algData.logStrm;
+    algData.pedEntries.setTarget(nEntries);
+
     /////////////////////////////////////////
     /// Event Loop //////////////////////////
     /////////////////////////////////////////
     // in periodic trigger mode we will skip these events
-    for (eventData.eventNum = 0; eventData.eventNum < nEvents; eventData.next()) {
+    for (eventData.eventNum = beginEvt; eventData.eventNum < endEvt; eventData.next()) {
       /////////////////////////////////////////
       /// Load new event //////////////////////
       /////////////////////////////////////////
-      if (eventData.eventNum % 2000 == 0) {
-        // quit if we have enough entries in each histogram
-        const unsigned currentMin = algData.pedHists->getMinEntries();
-        if (currentMin >= nEntries) break;
-        LogStrm::get() << "Event: " << eventData.eventNum
-                         << " min entries per histogram: " << currentMin
-                         << endl;
-        LogStrm::get().flush();
+      // quit if we have enough entries in each histogram
+      if (algData.pedEntries.targetReached())
+        break;
+
+      if ((eventData.eventNum - beginEvt) % 2000 == 0) {
+        logStrm << "Event: " << eventData.eventNum
+                << " min entries per histogram: " << algData.pedEntries.getMinEntries()
+                << endl;
+        logStrm.flush();
       }
 
       if (!rootFile.getEvent(eventData.eventNum)) {
-        LogStrm::get() << "Warning, event " << eventData.eventNum << " not read." << endl;
+        logStrm << "Warning, event " << eventData.eventNum << " not read." << endl;
         continue;
       }
 
       DigiEvent const*const digiEvent = rootFile.getDigiEvent();
       if (!digiEvent) {
-        LogStrm::get() << __FILE__ << ": Unable to read DigiEvent: " << eventData.eventNum  << endl;
+        logStrm << __FILE__ << ": Unable to read DigiEvent: " << eventData.eventNum  << endl;
         continue;
       }
 
       processEvent(*digiEvent);
     }
+
+    return eventData.eventNum;
   }
 
-  void MuonPedAlg::processEvent(const DigiEvent &digiEvent) {
+  void MuonPedAlg::seedReadoutMode(RootFileAnalysis &rootFile,
+                                    const unsigned beginEvt) {
+    eventData = EventData();
+    if (beginEvt == 0 || algData.trigCut != PERIODIC_TRIGGER)
+      return;
+
+    // same as passTrigCut() for event beginEvt-1, mode is unknown (4
+    // range) if event or summary is missing.
+    bool fourRange = true;
+    if (rootFile.getEvent(beginEvt - 1)) {
+      DigiEvent const*const digiEvent = rootFile.getDigiEvent();
+      if (digiEvent) {
+        const EventSummaryData &summary = digiEvent->getEventSummaryData();
+        if (&summary != 0)
+          fourRange = const_cast<EventSummaryData&>(summary).readout4();
+      }
+    }
+
+    eventData.prev4Range = fourRange;
+  }
+
+  void MuonPedAlg::fillHistsFromSkim(const unsigned nEntries,
+                                     const string &skimPath,
+                                     const CalUtil::CalPed *roughPeds,
+                                     PedHists &pedHists,
+                                     const TRIGGER_CUT trigCut) {
+    algData.roughPeds = roughPeds;
+    algData.trigCut   = trigCut;
+    algData.pedHists = &pedHists;
+    algData.logStrm  = &LogStrm::get();
+    algData.pedEntries.reset();
+    algData.pedEntries.setTarget(nEntries);
+
+    ostream &logStrm = *algData.logStrm;
+
+    MappedCalSkim skim(skimPath);
+    logStrm << __FILE__ << ": Processing: " << skim.getNEvents() << " skimmed events." << endl;
+
     /////////////////////////////////////////
-    /// Event/Trigger level cuts ////////////
+    /// Event Loop //////////////////////////
     /////////////////////////////////////////
+    // same bookkeeping as processRange(), so that event selection
+    // (incl 4-range state of previous event) is unchanged.
+    eventData.eventNum = 0;
+    while (skim.nextBlock()) {
+      const CalSkimBlock &block = skim.getBlock();
 
-    //-- retrieve trigger data
-    const Gem *gem = 0;
-    unsigned   gemConditionsWord = 0;
+      for (unsigned evt = 0; evt < block.nEvents; evt++, eventData.next()) {
+        // quit if we have enough entries in each histogram
+        if (algData.pedEntries.targetReached())
+          return;
+
+        if (eventData.eventNum % 2000 == 0) {
+          logStrm << "Event: " << eventData.eventNum
+                  << " min entries per histogram: " << algData.pedEntries.getMinEntries()
+                  << endl;
+          logStrm.flush();
+        }
 
+        if (!(block.flags[evt] & CalSkimBlock::EVT_VALID)) {
+          logStrm << __FILE__ << ": Unable to read DigiEvent: " << eventData.eventNum  << endl;
+          continue;
+        }
 
-    if (algData.trigCut == PERIODIC_TRIGGER ||
-        algData.trigCut == EXTERNAL_TRIGGER) {
-      gem = &(digiEvent.getGem());
-      gemConditionsWord = gem->getConditionSummary();
+        processEvent(block, evt);
+      }
     }
+  }
 
+  bool MuonPedAlg::passTrigCut(const unsigned gemConditionsWord,
+                               const bool haveSummary,
+                               const bool fourRange,
+                               const unsigned gemDeltaEventTime) {
     //-- PERIODIC_TRIGGER CUT
     if (algData.trigCut == PERIODIC_TRIGGER) {
       // quick check if we are in 4-range mode
-      const EventSummaryData &summary = digiEvent.getEventSummaryData();
-      if (&summary == 0) {
-        LogStrm::get() << "Warning, eventSummary data not found for event: "
+      if (!haveSummary) {
+        *algData.logStrm << "Warning, eventSummary data not found for event: "
                          << eventData.eventNum << endl;
-        return;
+        return false;
       }
-      eventData.fourRange = const_cast<EventSummaryData&>(summary).readout4();
+      eventData.fourRange = fourRange;
 
-      const float gemDeltaEventTime = gem->getDeltaEventTime()*0.05;
+      const float gemDeltaEventTimeUS = gemDeltaEventTime*0.05;
       if (gemConditionsWord != enums::PERIODIC ||     // skip unless we are periodic trigger only
           eventData.prev4Range      ||   // avoid bias from 4 range readout in prev event
-          gemDeltaEventTime < 100)      // avoid bias from shaped readout noise from adjacent event
-        return;
+          gemDeltaEventTimeUS < 100)      // avoid bias from shaped readout noise from adjacent event
+        return false;
     }
 
     //-- EXTERNAL_TRIGGER CUT
     if (algData.trigCut == EXTERNAL_TRIGGER) // cut on external trigger only
       if (gemConditionsWord != enums::EXTERNAL)
-        return;
+        return false;
+
+    return true;
+  }
+
+  void MuonPedAlg::processEvent(const DigiEvent &digiEvent) {
+    /////////////////////////////////////////
+    /// Event/Trigger level cuts ////////////
+    /////////////////////////////////////////
+
+    //-- retrieve trigger data
+    unsigned   gemConditionsWord = 0;
+    unsigned   gemDeltaEventTime = 0;
+    bool       haveSummary = true;
+    bool       fourRange   = true;
+
+    if (algData.trigCut == PERIODIC_TRIGGER ||
+        algData.trigCut == EXTERNAL_TRIGGER) {
+      const Gem &gem = digiEvent.getGem();
+      gemConditionsWord = gem.getConditionSummary();
+      gemDeltaEventTime = gem.getDeltaEventTime();
+    }
+
+    if (algData.trigCut == PERIODIC_TRIGGER) {
+      const EventSummaryData &summary = digiEvent.getEventSummaryData();
+      haveSummary = (&summary != 0);
+      if (haveSummary)
+        fourRange = const_cast<EventSummaryData&>(summary).readout4();
+    }
+
+    if (!passTrigCut(gemConditionsWord, haveSummary, fourRange, gemDeltaEventTime))
+      return;
 
     const TClonesArray *calDigiCol = digiEvent.getCalDigiCol();
     if (!calDigiCol) {
-      LogStrm::get() << "no calDigiCol found for event#" << eventData.eventNum << endl;
+      *algData.logStrm << "no calDigiCol found for event#" << eventData.eventNum << endl;
       return;
     }
 
@@ -150,15 +671,55 @@ namespace calibGenCAL {
       processHit(*pCalDigi);
   }
 
+  void MuonPedAlg::processEvent(const CalSkimBlock &block,
+                                const unsigned evt) {
+    const uint8_t flags = block.flags[evt];
+
+    if (!passTrigCut(block.gemConditionsWord[evt],
+                     flags & CalSkimBlock::EVT_SUMMARY,
+                     flags & CalSkimBlock::EVT_4RANGE,
+                     block.gemDeltaEventTime[evt]))
+      return;
+
+    if (!(flags & CalSkimBlock::EVT_CALDIGI)) {
+      *algData.logStrm << "no calDigiCol found for event#" << eventData.eventNum << endl;
+      return;
+    }
+
+    for (unsigned hit = block.hitBegin(evt); hit < block.hitEnd[evt]; hit++) {
+      const unsigned ro = CalSkimBlock::roIdx(hit, 0, FaceNum(NEG_FACE));
+      processHit(XtalIdx(idents::CalXtalId(block.xtalId[hit])),
+                 block.nReadouts[hit],
+                 block.range + ro,
+                 block.adc + ro);
+    }
+  }
+
   void MuonPedAlg::processHit(const CalDigi &calDigi) {
     //-- XtalId --//
     const idents::CalXtalId id(calDigi.getPackedId());  // get interaction information
 
-    // skip hits not for current tower.
-    const XtalIdx xtalIdx(id);
-
     const unsigned nRO = calDigi.getNumReadouts();
 
+    // unpack readouts into flat arrays
+    unsigned char  range[CalSkimBlock::READOUTS_PER_HIT];
+    unsigned short adc[CalSkimBlock::READOUTS_PER_HIT];
+    for (unsigned short n = 0; n < min<unsigned>(nRO, CalSkimBlock::MAX_READOUTS); n++) {
+      const CalXtalReadout &readout = *calDigi.getXtalReadout(n);
+
+      for (FaceNum face; face.isValid(); face++) {
+        range[n*FaceNum::N_VALS + face.val()] = readout.getRange((CalXtalId::XtalFace)face.val());
+        adc[n*FaceNum::N_VALS + face.val()] = readout.getAdc((CalXtalId::XtalFace)face.val());
+      }
+    }
+
+    processHit(XtalIdx(id), nRO, range, adc);
+  }
+
+  void MuonPedAlg::processHit(const XtalIdx xtalIdx,
+                              const unsigned nRO,
+                              const unsigned char *range,
+                              const unsigned short *adc) {
     if (nRO != 4) {
       ostringstream tmp;
       tmp << __FILE__  << ":"     << __LINE__ << " "
@@ -169,10 +730,16 @@ namespace calibGenCAL {
     // 1st look at LEX8 vals
     CalVec<FaceNum, float> adcL8;
     for (FaceNum face; face.isValid(); face++) {
-      adcL8[face] = calDigi.getAdcSelectedRange(LEX8.val(), (CalXtalId::XtalFace)face.val());
+      adcL8[face] = -1;
+      for (unsigned short n = 0; n < nRO; n++)
+        if (range[n*FaceNum::N_VALS + face.val()] == LEX8.val()) {
+          adcL8[face] = adc[n*FaceNum::N_VALS + face.val()];
+          break;
+        }
+
       // check for missing readout
       if (adcL8[face] < 0) {
-        LogStrm::get() << "Couldn't get LEX8 readout for event=" << eventData.eventNum << endl;
+        *algData.logStrm << "Couldn't get LEX8 readout for event=" << eventData.eventNum << endl;
         return;
       }
     }
@@ -180,15 +747,19 @@ namespace calibGenCAL {
     /////////////////////////////////////////
     /// 'Rough' pedestal mode (fist pass) ///
     /////////////////////////////////////////
-    if (!algData.roughPeds)
+    if (!algData.roughPeds) {
       for (FaceNum face; face.isValid(); face++) {
         const RngIdx rngIdx(xtalIdx,
                       face,
                       LEX8);
 
-        algData.pedHists->produceHist(rngIdx).Fill(adcL8[face]);
+        fillPed(rngIdx, adcL8[face]);
       }
-    else  {
+
+      // keep hit for replay in fillCutHists()
+      if (m_singlePass && m_singlePass->buffering)
+        m_singlePass->addHit(eventData.eventNum, xtalIdx, range, adc);
+    } else  {
       /////////////////////////////////////////
       /// Cut outliers (2nd pass) /////////////
       /////////////////////////////////////////
@@ -201,20 +772,16 @@ namespace calibGenCAL {
         return;
 
       //-- Fill histograms for all 4 ranges
-      for (unsigned short n = 0; n < nRO; n++) {
-        const CalXtalReadout &readout = *calDigi.getXtalReadout(n);
-
+      for (unsigned short n = 0; n < nRO; n++)
         for (FaceNum face; face.isValid(); face++) {
           // check that we are in the expected readout mode
-          const RngNum rng(readout.getRange((CalXtalId::XtalFace)face.val()));
-          const unsigned short adc(readout.getAdc((CalXtalId::XtalFace)face.val()));
+          const RngNum rng(range[n*FaceNum::N_VALS + face.val()]);
           const RngIdx rngIdx(xtalIdx,
                         face,
                         rng);
 
-          algData.pedHists->produceHist(rngIdx).Fill(adc);
+          fillPed(rngIdx, adc[n*FaceNum::N_VALS + face.val()]);
         }
-      }
     }
   }
 
@@ -12,6 +12,8 @@
 #include "CalUtil/CalDefs.h"
 #include "CalUtil/CalVec.h"
 #include "src/lib/Hists/PedHists.h"
+#include "src/lib/Hists/MinEntriesTracker.h"
+#include "src/lib/Util/FusedDigiLoop.h"
 
 
 // EXTLIB INCLUDES
@@ -19,6 +21,7 @@
 // STD INCLUDES
 #include <vector>
 #include <string>
+#include <ostream>
 
 class TH1S;
 class DigiEvent;
@@ -30,6 +33,9 @@ namespace CalUtil {
 }
 
 namespace calibGenCAL {
+  class RootFileAnalysis;
+  class CalSkimBlock;
+
   /** \brief Algorithm class populates CalPed calibration object
       by analyzing digi ROOT event files.
 
@@ -41,9 +47,13 @@ namespace calibGenCAL {
 
       @author Zachary Fewtrell
   */
-  class MuonPedAlg {
+  class MuonPedAlg : public DigiEventConsumer {
   public:
-    MuonPedAlg() {}
+    MuonPedAlg() :
+      m_singlePass(0)
+    {}
+
+    ~MuonPedAlg();
 
     /// which type of events should be filtered for
     /// pedestal processing?
@@ -56,19 +66,159 @@ namespace calibGenCAL {
     /// Fill MuonPedAlghist histograms w/ nEvt event data
     /// \param rootFilename.  input digi event file
     /// \param histFilename.  output root file for histograms.
+    /// \param nThreads if > 1, split input events into nThreads contiguous
+    /// ranges, each processed in its own worker process into private
+    /// histogram shard (see HistShard.h) which are merged into pedHists
+    /// in range order. channels still short of nEntries are then topped
+    /// up from events left unread by each range.
     void fillHists(const unsigned nEntries,
                    const std::vector<std::string> &rootFileList,
                    const CalUtil::CalPed *roughPeds,
                    PedHists &pedHists,
-                   const TRIGGER_CUT trigCut);
+                   const TRIGGER_CUT trigCut,
+                   const unsigned nThreads = 1);
+
+    /// Fill histograms from Cal skim file (see CalDigiSkim.h) instead of
+    /// digi ROOT files. event selection & output are identical to fillHists()
+    /// \param skimPath Cal skim file, e.g. from getCalSkimCache()
+    void fillHistsFromSkim(const unsigned nEntries,
+                           const std::string &skimPath,
+                           const CalUtil::CalPed *roughPeds,
+                           PedHists &pedHists,
+                           const TRIGGER_CUT trigCut);
+
+    /// prepare for event loop driven by FusedDigiLoop in place of
+    /// fillHists(). arguments as for fillHists()
+    void initConsumer(const unsigned nEntries,
+                      const CalUtil::CalPed *roughPeds,
+                      PedHists &pedHists,
+                      const TRIGGER_CUT trigCut);
+
+    /// single pass FusedDigiLoop consumer mode, rough pedestals are
+    /// generated from same read: events fill roughPedHists (and are
+    /// buffered) as in fillRoughHists() until each has nEntries, then
+    /// roughPeds are fit (as idle work, see DigiEventConsumer) &
+    /// buffered hits are replayed into pedHists as in fillCutHists(),
+    /// which later events fill directly.
+    /// \param nFitWorkers see PedHists::fitHists()
+    /// \note pedHists are trimmed & fit by caller, as w/ initConsumer()
+    void initSinglePassConsumer(const unsigned nEntries,
+                                PedHists &roughPedHists,
+                                CalUtil::CalPed &roughPeds,
+                                PedHists &pedHists,
+                                const TRIGGER_CUT trigCut,
+                                const unsigned nFitWorkers = 1);
+
+    /// DigiEventConsumer interface
+    void getDigiBranches(std::vector<std::string> &branches) const;
+
+    /// DigiEventConsumer interface
+    /// \pre initConsumer() or initSinglePassConsumer() has been called
+    bool consumeEvent(const unsigned eventNum,
+                      const DigiEvent &digiEvent);
+
+    /// DigiEventConsumer interface, true when rough pass of single pass
+    /// consumer is complete
+    bool hasIdleWork() const;
+
+    /// DigiEventConsumer interface, fit rough peds & switch to cut pass
+    void runIdleWork();
+
+    /// DigiEventConsumer interface, completes rough pass of single
+    /// pass consumer if input ended first
+    void finishConsumer();
+
+    /// 1st half of single pass mode: fill rough (LEX8 only) histograms
+    /// exactly as fillHists() w/ roughPeds == NULL.  all hits which
+    /// enter rough histograms are also buffered in memory and input
+    /// files are kept open for fillCutHists().
+    void fillRoughHists(const unsigned nEntries,
+                        const std::vector<std::string> &rootFileList,
+                        PedHists &roughPedHists,
+                        const TRIGGER_CUT trigCut);
+
+    /// 2nd half of single pass mode: fill all range histograms w/
+    /// outlier cut from roughPeds.  buffered hits are replayed first,
+    /// then input is read onward from where fillRoughHists() stopped,
+    /// so each event is read only once.  output is identical to
+    /// fillHists() w/ roughPeds.
+    /// \pre fillRoughHists() was called on this object
+    void fillCutHists(const unsigned nEntries,
+                      const CalUtil::CalPed &roughPeds,
+                      PedHists &pedHists);
     
   private:
+    /// disabled
+    MuonPedAlg(const MuonPedAlg &);
+    MuonPedAlg &operator=(const MuonPedAlg &);
+
+    /// input state kept between fillRoughHists() & fillCutHists()
+    class SinglePassData;
+
+    /// non-NULL between fillRoughHists() & fillCutHists() and in
+    /// single pass consumer mode
+    SinglePassData *m_singlePass;
+
+    /// replay hits buffered in rough pass w/ current (cut pass) settings
+    /// \return true if entries target was reached
+    bool     replayHits();
+
+    /// single pass consumer mode: fit rough peds & switch to cut pass
+    void     endRoughPass();
+
+    /// process event range in worker process (see ShardedEventLoop)
+    class RangeShard;
+
+    /// enable only needed branches in digi chain & opt in to default read ahead
+    void     cfgBranches(RootFileAnalysis &rootFile) const;
+
+    /// fill histograms from given event range until each histogram has
+    /// nEntries or range is exhausted
+    /// \return # of 1st event not processed
+    unsigned processRange(RootFileAnalysis &rootFile,
+                          const unsigned beginEvt,
+                          const unsigned endEvt,
+                          const unsigned nEntries);
+
+    /// set previous event readout mode state as processRange() would
+    /// have left it after event beginEvt-1 (for ranges not starting at 0)
+    void     seedReadoutMode(RootFileAnalysis &rootFile,
+                             const unsigned beginEvt);
+
     /// process single crystal hit for pedestal data
     void     processHit(const CalDigi &calDigi);
 
+    /// fill pedestal histogram (or worker shard) for single channel
+    void     fillPed(const CalUtil::RngIdx rngIdx,
+                     const float adc) {
+      if (algData.pedShard)
+        algData.pedShard->fill(rngIdx, adc);
+      else
+        algData.pedHists->fill(rngIdx, adc);
+      algData.pedEntries.count(rngIdx);
+    }
+
+    /// process single crystal hit for pedestal data
+    /// \param range, adc readout n, face f is at index n*FaceNum::N_VALS + f
+    void     processHit(const CalUtil::XtalIdx xtalIdx,
+                        const unsigned nRO,
+                        const unsigned char *range,
+                        const unsigned short *adc);
+
     /// process single digi event for pedestal data
     void     processEvent(const DigiEvent &digiEvt);
 
+    /// process single skimmed event for pedestal data
+    void     processEvent(const CalSkimBlock &block,
+                          const unsigned evt);
+
+    /// apply trigger cut for current event & update 4-range readout state
+    /// \return true if event passes
+    bool     passTrigCut(const unsigned gemConditionsWord,
+                         const bool haveSummary,
+                         const bool fourRange,
+                         const unsigned gemDeltaEventTime);
+
 
     /// generate ROOT histogram name string.
     static string genHistName(const CalUtil::RngIdx rngIdx);
@@ -79,6 +229,9 @@ namespace calibGenCAL {
       void init() {
         roughPeds = 0;
         trigCut   = PERIODIC_TRIGGER;
+        pedHists  = 0;
+        pedShard  = 0;
+        logStrm   = 0;
       }
 
     public:
@@ -91,6 +244,15 @@ namespace calibGenCAL {
       TRIGGER_CUT   trigCut;
       
       PedHists *pedHists;
+
+      /// if set, fills go here instead of pedHists (RangeShard)
+      PedHists::shard_type *pedShard;
+
+      /// fills per pedHists channel in current pass (early stop check)
+      MinEntriesTracker<CalUtil::RngIdx> pedEntries;
+
+      /// all diagnostic output goes here
+      std::ostream *logStrm;
     } algData;
 
     /// store data pertinent to current event
@@ -0,0 +1,54 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "CIDAC2ADCTable.h"
+
+// GLAST INCLUDES
+#include "CalUtil/SimpleCalCalib/CIDAC2ADC.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+
+namespace calibGenCAL {
+
+  using namespace std;
+  using namespace CalUtil;
+
+  CIDAC2ADCTable::CIDAC2ADCTable(const CIDAC2ADC &cidac2adc,
+                                 const unsigned rngMask) :
+    m_cidac2adc(cidac2adc)
+  {
+    static const unsigned nPts = MAX_ADC + 1;
+
+    // find tabulated channels first so table is allocated only once.
+    unsigned nChannels = 0;
+    for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
+      m_offset[rngIdx] = -1;
+      if ((rngMask & rngBit(rngIdx.getRng())) == 0)
+        continue;
+
+      m_offset[rngIdx] = nChannels*nPts;
+      nChannels++;
+    }
+
+    m_table.resize(nChannels*nPts);
+    for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
+      const int offset = m_offset[rngIdx];
+      if (offset < 0)
+        continue;
+
+      for (unsigned adc = 0; adc < nPts; adc++)
+        m_table[offset + adc] = cidac2adc.adc2dac(rngIdx, adc);
+    }
+  }
+
+  float CIDAC2ADCTable::adc2dacSlow(const RngIdx rngIdx,
+                                    const float adcPed) const {
+    return m_cidac2adc.adc2dac(rngIdx, adcPed);
+  }
+
+}; // namespace calibGenCAL
@@ -0,0 +1,88 @@
+#ifndef CIDAC2ADCTable_h
+#define CIDAC2ADCTable_h
+
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+#include "CalUtil/CalDefs.h"
+#include "CalUtil/CalVec.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <vector>
+
+namespace CalUtil {
+  class CIDAC2ADC;
+}
+
+namespace calibGenCAL {
+
+  /** \brief tabulated CIDAC2ADC::adc2dac() for per event conversion loops
+
+  evaluates adc2dac() spline once for every integer pedestal subtracted
+  adc value in [0, MAX_ADC] for each channel in selected adc ranges &
+  stores results in single contiguous table.  adc2dac() is then one
+  indexed load plus linear interpolation between neighbouring integer
+  adc values.
+
+  values outside table domain (negative adc, NaN) & channels outside
+  selected ranges are passed on to original CIDAC2ADC object.
+
+  \note table uses (MAX_ADC+1)*4 bytes per channel, i.e. ~50Mb for each
+  adc range.
+  */
+  class CIDAC2ADCTable {
+  public:
+    /// \param rngMask bitwise OR of rngBit() for each adc range to tabulate
+    CIDAC2ADCTable(const CalUtil::CIDAC2ADC &cidac2adc,
+                   const unsigned rngMask);
+
+    /// bit for given adc range in rngMask ctor argument
+    static unsigned rngBit(const CalUtil::RngNum rng) {
+      return 1 << rng.val();
+    }
+
+    /// same as CIDAC2ADC::adc2dac()
+    float adc2dac(const CalUtil::RngIdx rngIdx,
+                  const float adcPed) const {
+      const int offset = m_offset[rngIdx];
+      if (offset < 0 || !(adcPed >= 0) || !(adcPed < MAX_ADC))
+        return adc2dacSlow(rngIdx, adcPed);
+
+      const unsigned bin   = (unsigned)adcPed;
+      const float    frac  = adcPed - bin;
+      const float   *const pts = &m_table[offset + bin];
+      return pts[0] + frac*(pts[1] - pts[0]);
+    }
+
+    /// original (untabulated) calibration
+    const CalUtil::CIDAC2ADC &getCIDAC2ADC() const {
+      return m_cidac2adc;
+    }
+
+    /// upper end of tabulated adc domain
+    static const unsigned MAX_ADC = 4096;
+
+  private:
+    /// call through to m_cidac2adc
+    float adc2dacSlow(const CalUtil::RngIdx rngIdx,
+                      const float adcPed) const;
+
+    const CalUtil::CIDAC2ADC &m_cidac2adc;
+
+    /// start of channel's table in m_table, -1 if not tabulated
+    CalUtil::CalVec<CalUtil::RngIdx, int> m_offset;
+
+    /// MAX_ADC+1 cidac values for each tabulated channel
+    std::vector<float> m_table;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
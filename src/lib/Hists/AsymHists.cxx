@@ -8,6 +8,7 @@
 #include "AsymHists.h"
 #include "src/lib/Util/ROOTUtil.h"
 #include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/ChannelFitExecutor.h"
 #include "src/lib/Specs/CalGeom.h"
 
 // GLAST INCLUDES
@@ -16,10 +17,12 @@
 #include "TH2S.h"
 #include "TStyle.h"
 #include "TDirectory.h"
+#include "TF1.h"
 
 // STD INCLUDES
 #include <sstream>
 #include <string>
+#include <vector>
 
 using namespace CalUtil;
 using namespace std;
@@ -31,7 +34,8 @@ namespace calibGenCAL {
                        const unsigned short nSlicesPerXtal,
                        const unsigned short nSlicesPerHist,
                        TDirectory *const writeDir,
-                       TDirectory *const readDir) 
+                       TDirectory *const readDir,
+                       const bool lazyLoad) 
     :
     m_nSlicesPerXtal(nSlicesPerXtal),
     m_nSlicesPerHist(nSlicesPerHist),
@@ -41,7 +45,7 @@ namespace calibGenCAL {
     m_calGain(calGain)
   {
     if (readDir != 0)
-      loadHists(*readDir);
+      loadHists(*readDir, lazyLoad);
     else
       initHists();
     
@@ -76,89 +80,155 @@ namespace calibGenCAL {
     }
   }
 
-  void AsymHists::loadHists(TDirectory &readDir) {
+  void AsymHists::loadHists(TDirectory &readDir,
+                            const bool lazyLoad) {
     m_asymHists.reset(new AsymHistCol("asym",
                                       m_writeDir,
-                                      &readDir,
+                                      (lazyLoad) ? 0 : &readDir,
                                       m_nSlicesPerHist,
                                       -1*(CalGeom::CsILength/2-m_mmIgnoredOnXtalEnd),
                                       CalGeom::CsILength/2-m_mmIgnoredOnXtalEnd));
 
+    if (lazyLoad)
+      m_asymHists->loadHistsLazy(readDir);
   }
 
-  void AsymHists::fitHists(CalAsym &calAsym) {
-    for (AsymHistId histId; histId.isValid(); histId++) {
-      TH2S *const hist = m_asymHists->getHist(histId);
-      // skip non existant hists
-      if (hist == 0)
-        continue;
+  /// gaussian fit of each x slice of each non-empty asymmetry histogram
+  /// results: asymmetry mean, sigma
+  ///
+  /// histograms are only read (see HistVec::loadHistsLazy()) when
+  /// their first slice is fitted & released after their last slice
+  /// is stored.
+  class AsymHists::SliceFitter : public ChannelFitter {
+  public:
+    SliceFitter(AsymHists &asymHists,
+                CalAsym &calAsym) :
+      m_asymHists(asymHists),
+      m_calAsym(calAsym)
+    {
+      for (AsymHistId histId; histId.isValid(); histId++)
+        // skip non existant hists
+        if (asymHists.m_asymHists->hasHist(histId))
+          m_histId.push_back(histId);
+    }
 
-      // loop through all nSlicesPerXtal bins in asymmetry profile
+    /// all slices of each histogram are consecutive channels
+    unsigned nChannels() const {
+      return m_histId.size()*m_asymHists.m_nSlicesPerHist;
+    }
+
+    bool fitChannel(const unsigned channel,
+                    vector<double> &results) {
+      const AsymHistId &histId = m_histId[channel/m_asymHists.m_nSlicesPerHist];
+      TH2S *const hist = m_asymHists.m_asymHists->getHist(histId);
+      if (hist == 0)
+        return false;
 
       // skip empty histograms
-      TH2S &h = *hist;
-      if (h.GetEntries() == 0)
-        continue;
+      if (hist->GetEntries() == 0) {
+        if (isLastSlice(channel))
+          m_asymHists.m_asymHists->releaseHist(histId);
+        return false;
+      }
 
+      TH2S &h = *hist;
       const AsymType asymType(histId.getAsymType());
 
-      for (unsigned short i = 0; i < m_nSlicesPerHist; i++) {
-        // get slice of 2D histogram for each X bin
-        const unsigned short binNum = i+1;
-        // HISTOGRAM BINS START AT 1 NOT ZERO! (hence 'i+1')
-        TH1D &slice = *(h.ProjectionY("slice", binNum, binNum));
-
-        // rebin HE histograms to binWidth>=.02 in log(asym) scale
-        if (asymType != ASYM_LL) {
-          float binWidth = slice.GetBinWidth(1);
-          if (binWidth < .02)
-            slice.Rebin((int)(.02/binWidth));
-        }
-
-        // point local references to output values
-        float av;
-        float rms;
-
-        // trim outliers - 3 times cut out anything outside 3 sigma
-        for (unsigned short iter = 0; iter < 3; iter++) {
-          // get current mean & RMS
-          av  = slice.GetMean();
-          rms = slice.GetRMS();
-
-          // trim new histogram limits
-          slice.SetAxisRange(av - 3*rms, av + 3*rms);
-        }
-
-        // update new mean & sigma
-        //av = slice.GetMean(); rms = slice.GetRMS();
-        // fit w/ gaussian to avoid bias from outliers
-        slice.Fit("gaus","Q","", av - 3*rms, av+3*rms);
-        av = ((TF1&)*slice.GetFunction("gaus")).GetParameter(1);
-        rms = ((TF1&)*slice.GetFunction("gaus")).GetParameter(2);
-
-        // add nominal asymmetry slope back in
-        av += nominalAsymSlope()*h.GetBinCenter(binNum);
-        
-        // add average asymmetry back in
-        av += nominalAsymCtr(asymType, m_calGain);
-
-        const AsymType asymType(histId.getAsymType());
-        const XtalIdx xtalIdx(histId.getXtalIdx());
-
-        LogStrm::get() << histId.toStr() << " "
-                       << i   << " "
-                       << av  << " "
-                       << rms << " "
-                       << endl;
-
-        calAsym.getPtsAsym(xtalIdx,asymType).push_back(av);
-        calAsym.getPtsErr(xtalIdx,asymType).push_back(rms);
-
-        // evidently ROOT doesn't like reusing the slice
-        // histograms as much as they claim they do.
-        slice.Delete();
+      // get slice of 2D histogram for each X bin
+      const unsigned short binNum = channel%m_asymHists.m_nSlicesPerHist + 1;
+      // HISTOGRAM BINS START AT 1 NOT ZERO! (hence 'i+1')
+      TH1D &slice = *(h.ProjectionY("slice", binNum, binNum));
+
+      // rebin HE histograms to binWidth>=.02 in log(asym) scale
+      if (asymType != ASYM_LL) {
+        float binWidth = slice.GetBinWidth(1);
+        if (binWidth < .02)
+          slice.Rebin((int)(.02/binWidth));
       }
+
+      // point local references to output values
+      float av;
+      float rms;
+
+      // trim outliers - 3 times cut out anything outside 3 sigma
+      for (unsigned short iter = 0; iter < 3; iter++) {
+        // get current mean & RMS
+        av  = slice.GetMean();
+        rms = slice.GetRMS();
+
+        // trim new histogram limits
+        slice.SetAxisRange(av - 3*rms, av + 3*rms);
+      }
+
+      // update new mean & sigma
+      //av = slice.GetMean(); rms = slice.GetRMS();
+      // fit w/ gaussian to avoid bias from outliers
+      slice.Fit("gaus","Q","", av - 3*rms, av+3*rms);
+      av = ((TF1&)*slice.GetFunction("gaus")).GetParameter(1);
+      rms = ((TF1&)*slice.GetFunction("gaus")).GetParameter(2);
+
+      results.push_back(av);
+      results.push_back(rms);
+
+      // evidently ROOT doesn't like reusing the slice
+      // histograms as much as they claim they do.
+      slice.Delete();
+
+      return true;
     }
+
+    void storeResults(const unsigned channel,
+                      const vector<double> &results) {
+      const AsymHistId &histId = m_histId[channel/m_asymHists.m_nSlicesPerHist];
+      const TH2S &h = *m_asymHists.m_asymHists->getHist(histId);
+      const unsigned short i = channel%m_asymHists.m_nSlicesPerHist;
+      const unsigned short binNum = i+1;
+
+      const AsymType asymType(histId.getAsymType());
+      const XtalIdx xtalIdx(histId.getXtalIdx());
+
+      float av = results[0];
+      const float rms = results[1];
+
+      // add nominal asymmetry slope back in
+      av += nominalAsymSlope()*h.GetBinCenter(binNum);
+
+      // add average asymmetry back in
+      av += nominalAsymCtr(asymType, m_asymHists.m_calGain);
+
+      LogStrm::get() << histId.toStr() << " "
+                     << i   << " "
+                     << av  << " "
+                     << rms << " "
+                     << endl;
+
+      m_calAsym.getPtsAsym(xtalIdx,asymType).push_back(av);
+      m_calAsym.getPtsErr(xtalIdx,asymType).push_back(rms);
+
+      if (isLastSlice(channel))
+        m_asymHists.m_asymHists->releaseHist(histId);
+    }
+
+  private:
+    bool isLastSlice(const unsigned channel) const {
+      return channel%m_asymHists.m_nSlicesPerHist == m_asymHists.m_nSlicesPerHist - 1u;
+    }
+
+    AsymHists &m_asymHists;
+    CalAsym &m_calAsym;
+
+    vector<AsymHistId> m_histId;
+  };
+
+  void AsymHists::fitHists(CalAsym &calAsym,
+                           const unsigned nWorkers) {
+    // fork()ed workers would share input file offset w/ each other,
+    // so read everything up front
+    if (nWorkers > 1)
+      m_asymHists->readAllHists();
+
+    SliceFitter fitter(*this, calAsym);
+    ChannelFitExecutor(nWorkers).run(fitter, fitter.nChannels());
   }
 
   void AsymHists::fill(const CalUtil::AsymType asymType,
@@ -178,5 +248,6 @@ namespace calibGenCAL {
     TH2S &hist = m_asymHists->produceHist(histId);
 
     hist.Fill(mmFromCtrLong, asym);
+    m_entries.count(histId);
   }
 }; // namespace calibGenCAL
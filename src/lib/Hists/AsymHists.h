@@ -9,6 +9,7 @@
 
 // LOCAL INCLUDES
 #include "src/lib/Hists/HistVec.h"
+#include "src/lib/Hists/MinEntriesTracker.h"
 #include "src/lib/Specs/CalResponse.h"
 
 // GLAST INCLUDES
@@ -103,19 +104,26 @@ namespace calibGenCAL {
     /// \param nSlicesPerXtal number of slices along entire crystal length
     /// \param nSlicesPerHist only the middle 'n' slices will actually be measued as outer most slices have very high error
     /// \param calGain instrument gain setting is needed to determine histogram limits for mixed-diode asymmetry
+    /// \param lazyLoad see loadHists()
     AsymHists(const CalResponse::CAL_GAIN_INTENT calGain=CalResponse::FLIGHT_GAIN,
               const unsigned short nSlicesPerXtal=12,
               const unsigned short nSlicesPerHist=10,
               TDirectory *const writeDir=0,
-              TDirectory *const readDir=0);
+              TDirectory *const readDir=0,
+              const bool lazyLoad=false);
 
     /// load histograms from ROOT output of previous run
-    void        loadHists(TDirectory &readDir);
+    /// \param lazyLoad only index histograms, each one is read when
+    /// first needed (readDir must stay open)
+    void        loadHists(TDirectory &readDir,
+                          const bool lazyLoad=false);
 
     /// print histogram summary info to output stream
     void        summarizeHists(std::ostream &ostrm) const;
 
-    void        fitHists(CalUtil::CalAsym &calAsym);
+    /// \param nWorkers fit slices in n parallel worker processes (see ChannelFitExecutor)
+    void        fitHists(CalUtil::CalAsym &calAsym,
+                         const unsigned nWorkers = 1);
 
     /// return pointer to histogram for given index, return 0 if it doesn't exist
     const TH2S *getHist(const CalUtil::AsymType asymType,
@@ -141,7 +149,21 @@ namespace calibGenCAL {
       return m_asymHists->getMinEntries();
     }
 
+    /// set # of entries per histogram required by entriesTargetReached()
+    void setEntriesTarget(const unsigned nEntries) {
+      m_entries.setTarget(nEntries);
+    }
+
+    /// O(1) check that each filled histogram has reached entries target
+    /// \note only counts fill() calls on this object
+    bool entriesTargetReached() const {
+      return m_entries.targetReached();
+    }
+
   private:
+    /// ChannelFitter for fitHists()
+    class SliceFitter;
+
     /// allocate & create asymmetry histograms & pointer arrays
     void        initHists();
 
@@ -154,6 +176,9 @@ namespace calibGenCAL {
 
     std::auto_ptr<AsymHistCol> m_asymHists;
 
+    /// fill() count per histogram
+    MinEntriesTracker<AsymHistId> m_entries;
+
     static std::string genHistName(const CalUtil::AsymType asymType,
                                    const CalUtil::XtalIdx xtalIdx);
 
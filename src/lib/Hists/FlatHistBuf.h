@@ -0,0 +1,268 @@
+#ifndef FlatHistBuf_h
+#define FlatHistBuf_h
+
+// $Header: $
+
+/** @file
+    @brief fill buffer for all channels of a 1D HistVec collection.
+*/
+
+// LOCAL INCLUDES
+#include "HistShard.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+#include "TH1.h"
+
+// STD INCLUDES
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+
+namespace calibGenCAL {
+
+  /** \brief bin counts for every channel of 1D histogram collection w/
+      fixed binning.
+
+      each channel's counts are allocated (64 byte aligned) on its first
+      fill, so unused channels cost one pointer.
+
+      fill() follows TAxis::FindFixBin() & TH1::Fill(x) (unit weights)
+      exactly, so merged histograms are identical to those filled
+      directly.  ROOT histograms are only needed once buffer is merged.
+
+      \param IdxType channel index type (val() / N_VALS conventions of CalUtil::CalDefs)
+      \param HistType TH1S or TH1I
+  */
+  template <typename IdxType,
+            typename HistType>
+  class FlatHistBuf {
+  public:
+    typedef typename HistShardTraits<HistType>::CellType CellType;
+
+    FlatHistBuf(const unsigned nBins,
+                const double loLimit,
+                const double hiLimit) :
+      m_nBins(nBins),
+      m_loLimit(loLimit),
+      m_hiLimit(hiLimit),
+      m_stride(alignedStride(nBins + 2)),
+      m_chans(IdxType::N_VALS, (Channel*)0),
+      m_pending(false)
+    {
+      if (!(loLimit < hiLimit))
+        throw std::runtime_error("FlatHistBuf: fixed histogram limits required");
+    }
+
+    ~FlatHistBuf() {
+      for (unsigned i = 0; i < m_allocated.size(); i++)
+        freeChannel(m_chans[m_allocated[i]]);
+    }
+
+    /// equivalent to histogram(idx).Fill(x)
+    void fill(const IdxType &idx,
+              const double x) {
+      // same arithmetic as TAxis::FindFixBin()
+      int bin;
+      if (x < m_loLimit)
+        bin = 0;
+      else if (!(x < m_hiLimit))
+        bin = m_nBins + 1;
+      else
+        bin = 1 + int(m_nBins*(x - m_loLimit)/(m_hiLimit - m_loLimit));
+
+      Channel &chan = produceChannel(idx.val());
+      CellType &cell = chan.cells[bin];
+      if (cell != std::numeric_limits<CellType>::max())
+        cell++;
+
+      ChanStats &stats = chan.stats;
+      stats.entries++;
+      m_pending = true;
+
+      if ((bin == 0 || bin > (int)m_nBins) && !TH1::GetStatOverflows())
+        return;
+
+      stats.sumw++;
+      stats.sumx  += x;
+      stats.sumx2 += x*x;
+    }
+
+    /// # of fills for given channel
+    unsigned getEntries(const IdxType &idx) const {
+      const Channel *const chan = m_chans[idx.val()];
+      return (chan == 0) ? 0 : chan->stats.entries;
+    }
+
+    /// true if any channel has been filled since last reset()
+    /// \note stays true after resetChannel()
+    bool isPending() const {
+      return m_pending;
+    }
+
+    /// # of channels w/ allocated counts
+    unsigned getNAllocated() const {
+      return m_allocated.size();
+    }
+
+    /// add contents of other buffer w/ same binning
+    void add(const FlatHistBuf &other) {
+      if (other.m_nBins != m_nBins ||
+          other.m_loLimit != m_loLimit ||
+          other.m_hiLimit != m_hiLimit)
+        throw std::runtime_error("FlatHistBuf: binning mismatch");
+
+      if (!other.m_pending)
+        return;
+
+      const CellType maxCell = std::numeric_limits<CellType>::max();
+      for (unsigned i = 0; i < other.m_allocated.size(); i++) {
+        const unsigned chanIdx = other.m_allocated[i];
+        const Channel &src = *other.m_chans[chanIdx];
+        if (src.stats.entries == 0)
+          continue;
+
+        Channel &dest = produceChannel(chanIdx);
+        for (unsigned bin = 0; bin < m_stride; bin++)
+          dest.cells[bin] = std::min<double>((double)dest.cells[bin] + src.cells[bin], maxCell);
+
+        dest.stats.entries += src.stats.entries;
+        dest.stats.sumw    += src.stats.sumw;
+        dest.stats.sumx    += src.stats.sumx;
+        dest.stats.sumx2   += src.stats.sumx2;
+      }
+
+      m_pending = true;
+    }
+
+    /// add buffered contents for given channel to histogram
+    void mergeInto(const IdxType &idx,
+                   HistType &hist) const {
+      const TAxis &axis = *hist.GetXaxis();
+      if (axis.GetNbins() != (int)m_nBins ||
+          axis.GetXmin() != m_loLimit ||
+          axis.GetXmax() != m_hiLimit)
+        throw std::runtime_error(std::string("FlatHistBuf: binning mismatch for histogram: ") +
+                                 hist.GetName());
+
+      const Channel *const chan = m_chans[idx.val()];
+      if (chan == 0)
+        return;
+
+      double stats[TH1::kNstat];
+      std::fill(stats, stats + TH1::kNstat, 0);
+      stats[0] = chan->stats.sumw;
+      stats[1] = chan->stats.sumw;
+      stats[2] = chan->stats.sumx;
+      stats[3] = chan->stats.sumx2;
+
+      mergeBinCounts(hist,
+                     chan->cells,
+                     m_nBins + 2,
+                     chan->stats.entries,
+                     stats);
+    }
+
+    /// zero all channels (allocated channels are kept for reuse)
+    void reset() {
+      for (unsigned i = 0; i < m_allocated.size(); i++) {
+        Channel &chan = *m_chans[m_allocated[i]];
+        memset(chan.cells, 0, m_stride*sizeof(CellType));
+        chan.stats = ChanStats();
+      }
+
+      m_pending = false;
+    }
+
+    /// zero single channel (e.g. after merging it alone)
+    void resetChannel(const IdxType &idx) {
+      Channel *const chan = m_chans[idx.val()];
+      if (chan == 0)
+        return;
+
+      memset(chan->cells, 0, m_stride*sizeof(CellType));
+      chan->stats = ChanStats();
+    }
+
+  private:
+    /// disabled
+    FlatHistBuf(const FlatHistBuf &);
+    FlatHistBuf &operator=(const FlatHistBuf &);
+
+    static const unsigned CACHE_LINE = 64;
+
+    /// round # of cells up to whole cache lines so each channel starts on new line
+    static unsigned alignedStride(const unsigned nCells) {
+      const unsigned cellsPerLine = CACHE_LINE/sizeof(CellType);
+      return (nCells + cellsPerLine - 1)/cellsPerLine*cellsPerLine;
+    }
+
+    /// running statistics for single channel (TH1::GetStats() w/ unit weights)
+    struct ChanStats {
+      ChanStats() :
+        entries(0),
+        sumw(0),
+        sumx(0),
+        sumx2(0)
+      {}
+
+      unsigned entries;
+      double sumw;
+      double sumx;
+      double sumx2;
+    };
+
+    /// counts & statistics for single channel
+    struct Channel {
+      ChanStats stats;
+
+      /// m_stride bin counts (nBins + under/overflow, padded)
+      CellType *cells;
+    };
+
+    /// retrieve channel, allocate zeroed counts on 1st use
+    Channel &produceChannel(const unsigned chanIdx) {
+      Channel *&chan = m_chans[chanIdx];
+      if (chan != 0)
+        return *chan;
+
+      void *mem = 0;
+      if (posix_memalign(&mem, CACHE_LINE, m_stride*sizeof(CellType)) != 0)
+        throw std::runtime_error("FlatHistBuf: unable to allocate bin array");
+      memset(mem, 0, m_stride*sizeof(CellType));
+
+      chan = new Channel;
+      chan->cells = static_cast<CellType*>(mem);
+      m_allocated.push_back(chanIdx);
+
+      return *chan;
+    }
+
+    static void freeChannel(Channel *chan) {
+      free(chan->cells);
+      delete chan;
+    }
+
+    const unsigned m_nBins;
+    const double m_loLimit;
+    const double m_hiLimit;
+
+    /// # of cells per channel (nBins + under/overflow, padded)
+    const unsigned m_stride;
+
+    /// one entry per channel (NULL until 1st fill)
+    std::vector<Channel*> m_chans;
+
+    /// indices of allocated channels, in order of allocation
+    std::vector<unsigned> m_allocated;
+
+    bool m_pending;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
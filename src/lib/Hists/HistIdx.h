@@ -6,6 +6,7 @@
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
+#include "CalUtil/CalVec.h"
 
 
 // EXTLIB INCLUDES
@@ -13,6 +14,7 @@
 // STD INCLUDES
 #include <string>
 #include <sstream>
+#include <map>
 
 /** @file CalUtil::CalDefs inspired classes for indexing calibGenCAL histograms
 
@@ -68,6 +70,81 @@ namespace calibGenCAL {
       toPath(rngIdx.getRng());
   }
 
+  /** \brief idx.toStr() & toPath(idx) for every value of dense index
+      type, formatted once per process.
+
+      \param IdxType index type following conventions of CalUtil::CalDefs
+  */
+  template <typename IdxType>
+  class IdxStrTable {
+  public:
+    /// shared table for IdxType (built on 1st call)
+    static const IdxStrTable &get() {
+      static const IdxStrTable table;
+      return table;
+    }
+
+    const std::string &getStr(const IdxType &idx) const {
+      return m_str[idx];
+    }
+
+    const std::string &getPath(const IdxType &idx) const {
+      return m_path[idx];
+    }
+
+  private:
+    IdxStrTable() {
+      for (IdxType idx; idx.isValid(); idx++) {
+        m_str[idx]  = idx.toStr();
+        m_path[idx] = toPath(idx);
+      }
+    }
+
+    CalUtil::CalVec<IdxType, std::string> m_str;
+    CalUtil::CalVec<IdxType, std::string> m_path;
+  };
+
+  /** \brief idx.toStr() & toPath(idx) for sparse index types (see
+      HistMap), each value formatted on 1st use & cached.
+
+      \note not shared, one table per collection
+      \param IdxType index type w/ toStr(), toPath() & operator<()
+  */
+  template <typename IdxType>
+  class SparseIdxStrTable {
+  public:
+    const std::string &getStr(const IdxType &idx) const {
+      return getEntry(idx).str;
+    }
+
+    const std::string &getPath(const IdxType &idx) const {
+      return getEntry(idx).path;
+    }
+
+  private:
+    struct Entry {
+      std::string str;
+      std::string path;
+    };
+
+    typedef std::map<IdxType, Entry> EntryMap;
+
+    /// retrieve entry for idx, format it if needed
+    const Entry &getEntry(const IdxType &idx) const {
+      typename EntryMap::iterator it(m_entries.lower_bound(idx));
+      if (it == m_entries.end() || m_entries.key_comp()(idx, it->first)) {
+        Entry entry;
+        entry.str  = idx.toStr();
+        entry.path = toPath(idx);
+        it = m_entries.insert(it, typename EntryMap::value_type(idx, entry));
+      }
+
+      return it->second;
+    }
+
+    mutable EntryMap m_entries;
+  };
+
 
 }
 
@@ -9,11 +9,15 @@
 
 // LOCAL INCLUDES
 #include "src/lib/Util/ROOTUtil.h"
+#include "src/lib/Util/ThreadUtil.h"
+#include "HistIdx.h"
+#include "HistShard.h"
 
 // GLAST INCLUDES
 
 // EXTLIB INCLUDES
 #include "TDirectory.h"
+#include "TKey.h"
 
 // STD INCLUDES
 #include <map>
@@ -34,6 +38,10 @@
     \note IdxType needs a unsigned IdxType::val() method like the CalUtil::CalDefs idx classes.
     \note IdxType must support a constructor from 'unsigned'
 
+    \note loadHistsLazy() indexes histograms in an input directory
+    w/out reading them, each histogram is read on first access.
+    begin(), readAllHists() & detachHists() read all pending histograms.
+
 */
 
 namespace calibGenCAL {
@@ -60,10 +68,13 @@ namespace calibGenCAL {
             const double hiLimit=0
             ) :
       m_histBasename(histBasename),
+      m_namePrefix(histBasename + "_"),
       m_nBins(nBins),
       m_loLimit(loLimit),
       m_hiLimit(hiLimit),
-      m_writeDir(writeDir)
+      m_writeDir(writeDir),
+      m_detached(false),
+      m_dirCache(writeDir)
     {
       /// load data from file
       if (readDir != 0)
@@ -80,40 +91,130 @@ namespace calibGenCAL {
       typename MapType::iterator it(m_map.lower_bound(idx));
 
       /// this means that idx has not yet been inserted into the map
-      if (it == m_map.end() || it->first != idx)       
+      if (it == m_map.end() || it->first != idx) {
+        HistType *const hist_ptr = readHist(idx);
+        if (hist_ptr != 0)
+          return *hist_ptr;
+
         it = m_map.insert(it,ValType(idx, genHist(idx)));
+      }
       return *(it->second);
     }
 
+    /// return pointer to histogram for given index, return 0 if it doesn't exist
+    HistType *getHist(const IdxType &idx) {
+      const typename MapType::const_iterator it(m_map.find(idx));
+      if (it != m_map.end())
+        return it->second;
+
+      return readHist(idx);
+    }
+
+    /// index all associated histograms in readDir w/out reading them.
+    /// each histogram is read on first getHist() / produceHist() call
+    /// for its index.
+    /// \note readDir must stay open for lifetime of collection
+    void loadHistsLazy(TDirectory &readDir) {
+      typedef std::map<std::string, TKey*> KeyIndex;
+      KeyIndex keyIndex;
+      indexROOTKeys(readDir, m_histBasename, keyIndex);
+
+      for (typename KeyIndex::const_iterator it = keyIndex.begin();
+           it != keyIndex.end();
+           it++) {
+        try {
+          m_keys[name2Idx(it->first)] = it->second;
+        } catch (InvalidHistName &e) {
+          /// case where histogram name does not match, skip it
+          continue;
+        }
+      }
+    }
+
+    /// read all histograms still pending in lazy index
+    void readAllHists() const {
+      for (typename KeyMap::const_iterator it = m_keys.begin();
+           it != m_keys.end();
+           it++)
+        if (m_map.find(it->first) == m_map.end())
+          readHist(it->first);
+    }
+
+    /// delete histogram read from lazy index, it will be read again
+    /// on next access.
+    /// \note intended for unmodified input histograms, does nothing
+    /// if collection has write directory or histogram did not come
+    /// from lazy index.
+    void releaseHist(const IdxType &idx) {
+      if (m_keys.find(idx) == m_keys.end() || m_writeDir != 0)
+        return;
+
+      const typename MapType::iterator it(m_map.find(idx));
+      if (it == m_map.end())
+        return;
+
+      delete it->second;
+      m_map.erase(it);
+    }
+
     /// set directory for all contained histograms
+    /// \note histograms still pending in lazy index are moved to dir
+    /// as they are read
+    /// \note dir == 0 leaves contained histograms where they are
     void setDirectory(TDirectory *const dir) {
+      m_writeDir = dir;
+      m_dirCache.reset(dir);
+
+      if (dir == 0)
+        return;
+
       for (typename MapType::iterator it(m_map.begin());
            it != m_map.end();
-           it++) {
-        IdxType idx(it->first);
-        HistType *const hist_ptr(it->second);
+           it++)
+        attachHist(*(it->second), it->first);
+    }
 
-        // construct histogram (relative) path
-        const std::string subdir(genHistPath(idx));
+    /// remove all contained & future histograms from any ROOT directory.
+    /// \note intended for worker private collections which are later
+    /// merged into a directory bound collection
+    void detachHists() {
+      readAllHists();
 
-        /// retrieve proper directory for hist (create if needed)
-        TDirectory *const histdir = deliverROOTDir(dir, subdir);
-        if (histdir == 0)
-          throw std::runtime_error(std::string("Unable to create directory: ") +
-                                   dir->GetPath() + "/" + subdir);
+      for (typename MapType::iterator it(m_map.begin());
+           it != m_map.end();
+           it++)
+        it->second->SetDirectory(0);
 
-        hist_ptr->SetDirectory(histdir);
-        
-      }
+      m_writeDir = 0;
+      m_dirCache.reset(0);
+      m_detached = true;
+    }
 
-      m_writeDir = dir;
+    /// per worker fill buffer for this collection
+    typedef HistShard<IdxType, HistType, std::map<IdxType, BinShard*> > shard_type;
+
+    /// create empty fill buffer w/ same binning as this collection
+    /// \note caller owns returned object
+    shard_type *newShard() const {
+      return new shard_type(m_nBins,
+                            m_loLimit,
+                            m_hiLimit);
+    }
+
+    /// add contents of fill buffer to this collection (create histograms as needed)
+    /// \note call from single thread, once per shard in shard order
+    void mergeShard(const shard_type &shard) {
+      const std::vector<IdxType> &filled = shard.getFilledIdx();
+      for (unsigned i = 0; i < filled.size(); i++)
+        shard.mergeInto(filled[i], produceHist(filled[i]));
     }
 
     typedef typename MapType::iterator iterator;
     typedef typename MapType::const_iterator const_iterator;
     
-    iterator begin() {return m_map.begin();}
-    const_iterator begin() const {return m_map.begin();}
+    /// \note reads all histograms pending in lazy index
+    iterator begin() {readAllHists(); return m_map.begin();}
+    const_iterator begin() const {readAllHists(); return m_map.begin();}
 
     iterator end() {return m_map.end();}
     const_iterator end() const {return m_map.end();}
@@ -146,9 +247,8 @@ namespace calibGenCAL {
         insertHist(*it);
     }
 
-    std::string genHistName(const IdxType &idx) {
-      static std::string prefix(m_histBasename + "_");
-      return m_histBasename + "_" + idx.toStr();
+    std::string genHistName(const IdxType &idx) const {
+      return m_namePrefix + m_idxStrs.getStr(idx);
     }
 
     class InvalidHistName : public std::runtime_error {
@@ -159,35 +259,65 @@ namespace calibGenCAL {
     };
 
     /// convert histogram name back to index obj
-    IdxType name2Idx(const std::string &name) {
-      static std::string prefix(m_histBasename + "_");
-
+    IdxType name2Idx(const std::string &name) const {
       // first check that histogram name matches pattern
-      if (name.find(prefix) != 0)
+      if (name.compare(0, m_namePrefix.size(), m_namePrefix) != 0)
         throw InvalidHistName(std::string("Histogram : ") + name + " does not belong to collection: " + m_histBasename);
 
       // trim collection string from histogram name
-      return IdxType(name.substr(prefix.size()));
+      return IdxType(name.substr(m_namePrefix.size()));
     }
 
     /// create new histogram & register it w/ output directory
     HistType *genHist(const IdxType &idx) {
-      if (m_writeDir == 0)
+      if (m_writeDir == 0 && !m_detached)
         throw std::runtime_error("HistMap::genHist() : Write directory not set for HistMap class");
 
       const std::string histname(genHistName(idx));
 
-      const std::string subdir(genHistPath(idx));
+      // TH1 ctor & SetDirectory() use gDirectory
+      ROOTIOLock ioLock;
 
       HistType *hist=constructHist(idx);
       hist->SetNameTitle(histname.c_str(), histname.c_str());
 
-      TDirectory *const histdir(deliverROOTDir(m_writeDir, subdir));
-      hist->SetDirectory(histdir);
+      if (m_detached)
+        hist->SetDirectory(0);
+      else
+        attachHist(*hist, idx);
 
       return hist;
     }
 
+    /// move hist to proper subdirectory of m_writeDir (create if needed)
+    void attachHist(HistType &hist,
+                    const IdxType &idx) const {
+      hist.SetDirectory(&m_dirCache.produceDir(genHistPath(idx)));
+    }
+
+    /// read histogram for given index from lazy index & insert it in map
+    /// \return 0 if index has no pending key
+    HistType *readHist(const IdxType &idx) const {
+      const typename KeyMap::const_iterator keyIt(m_keys.find(idx));
+      if (keyIt == m_keys.end())
+        return 0;
+
+      ROOTIOLock ioLock;
+      HistType *const hist_ptr = dynamic_cast<HistType*>(keyIt->second->ReadObj());
+      /// skip if obj is wrong type
+      if (hist_ptr == 0)
+        return 0;
+
+      /// follow setDirectory() / detachHists() for eagerly read histograms
+      if (m_detached)
+        hist_ptr->SetDirectory(0);
+      else if (m_writeDir != 0)
+        attachHist(*hist_ptr, idx);
+
+      m_map[idx] = hist_ptr;
+      return hist_ptr;
+    }
+
     virtual HistType *constructHist(const IdxType &) {
       return new HistType("","",
                           m_nBins,
@@ -196,18 +326,23 @@ namespace calibGenCAL {
                           
     }
 
-    MapType m_map;
+    /// \note mutable so that const accessors can read pending histograms
+    mutable MapType m_map;
+
+    /// input keys indexed by loadHistsLazy()
+    typedef std::map<IdxType, TKey*> KeyMap;
+    KeyMap m_keys;
     
     /// generate appropriate subdirectory for histogram
-    std::string genHistPath(const IdxType &idx) {
-      std::ostringstream tmp;
-      tmp << m_histBasename << "/"
-          << toPath(idx);
-      return tmp.str();
+    std::string genHistPath(const IdxType &idx) const {
+      return m_histBasename + "/" + m_idxStrs.getPath(idx);
     }
 
     const std::string m_histBasename;
 
+    /// histogram name = m_namePrefix + idx.toStr()
+    const std::string m_namePrefix;
+
     /// option for creating new histogram
     const size_t m_nBins;
     /// option for creating new histogram
@@ -218,6 +353,15 @@ namespace calibGenCAL {
     /// all new (& modified) histograms written to this directory
     TDirectory * m_writeDir;
 
+    /// if true, new histograms are not attached to any directory
+    bool m_detached;
+
+    /// subdirectories of m_writeDir
+    mutable ROOTDirCache m_dirCache;
+
+    /// cached idx.toStr() & toPath(idx) strings
+    SparseIdxStrTable<IdxType> m_idxStrs;
+
   };
 }; // namespace calibGenCAL
 #endif
@@ -0,0 +1,497 @@
+#ifndef HistShard_h
+#define HistShard_h
+
+// $Header: $
+
+/** @file
+    @brief lightweight per worker fill buffers for HistVec / HistMap
+    histogram collections.
+
+    each worker fills its own HistShard (plain bin arrays, no ROOT
+    objects, no locking), shards are then merged into the ROOT histograms
+    of the parent collection from a single thread, in shard order.
+
+    merged bin contents, entries & Sumw2 are bit-identical to filling the
+    ROOT histograms serially.  merged statistics (mean, rms) and profile
+    bin sums are bit-identical whenever the fill values are integers
+    (e.g. adc values), otherwise they may differ in the last bits due to
+    summation order.
+
+    shards filled in fork()ed worker processes are sent back to the
+    calling process w/ pack() & unpack() (see ProcessUtil.h).
+*/
+
+// LOCAL INCLUDES
+#include "src/lib/Util/ProcessUtil.h"
+
+// GLAST INCLUDES
+#include "CalUtil/CalVec.h"
+
+// EXTLIB INCLUDES
+#include "TAxis.h"
+#include "TH1.h"
+#include "TH1S.h"
+#include "TH1I.h"
+#include "TH2S.h"
+#include "TProfile.h"
+
+// STD INCLUDES
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <limits.h>
+
+namespace calibGenCAL {
+
+  /// histogram class specific details needed to fill & merge shards
+  template <typename HistType> struct HistShardTraits;
+
+  template <> struct HistShardTraits<TH1S> {
+    typedef TArrayS ArrayType;
+    /// fill counter type, wider than bin contents so that merged Sumw2
+    /// keeps counting past maxContent() like TH1::Fill()
+    typedef UInt_t CellType;
+    static const bool PROFILE = false;
+    /// TH1S::AddBinContent() saturates here
+    static double maxContent() {return SHRT_MAX;}
+  };
+
+  template <> struct HistShardTraits<TH1I> {
+    typedef TArrayI ArrayType;
+    typedef UInt_t CellType;
+    static const bool PROFILE = false;
+    static double maxContent() {return INT_MAX;}
+  };
+
+  template <> struct HistShardTraits<TH2S> {
+    typedef TArrayS ArrayType;
+    typedef UInt_t CellType;
+    static const bool PROFILE = false;
+    static double maxContent() {return SHRT_MAX;}
+  };
+
+  template <> struct HistShardTraits<TProfile> {
+    typedef TArrayD ArrayType;
+    typedef UInt_t CellType;
+    static const bool PROFILE = true;
+    static double maxContent() {return 0;}
+  };
+
+  /** \brief add buffered fill counts & statistics to (non-profile) histogram
+
+  \param counts fills per bin (under/overflow incl), same layout as histogram bin array
+  \param stats same layout as TH1::GetStats()
+  */
+  template <typename HistType, typename CountType>
+  inline void mergeBinCounts(HistType &hist,
+                             const CountType *counts,
+                             const unsigned nCells,
+                             const double entries,
+                             const double *stats) {
+    typedef HistShardTraits<HistType> Traits;
+
+    // must be read before contents are modified
+    Double_t histStats[TH1::kNstat];
+    std::fill(histStats, histStats + TH1::kNstat, 0);
+    hist.GetStats(histStats);
+    const Double_t histEntries = hist.GetEntries() + entries;
+
+    typename Traits::ArrayType &contents = hist;
+    TArrayD &sumw2 = *hist.GetSumw2();
+    for (unsigned bin = 0; bin < nCells; bin++) {
+      if (counts[bin] == 0)
+        continue;
+
+      const double newVal = std::min<double>(contents.fArray[bin] + (double)counts[bin],
+                                             Traits::maxContent());
+      contents.fArray[bin] = newVal;
+
+      if (sumw2.fN)
+        sumw2.fArray[bin] += counts[bin];
+    }
+
+    for (unsigned i = 0; i < TH1::kNstat; i++)
+      histStats[i] += stats[i];
+    hist.PutStats(histStats);
+    hist.SetEntries(histEntries);
+  }
+
+  /// fixed width binning shared by all histograms in one shard
+  class HistShardAxes {
+  public:
+    /// \param nYBins 0 for 1D histograms
+    HistShardAxes(const unsigned nXBins,
+                  const double loXLimit,
+                  const double hiXLimit,
+                  const unsigned nYBins,
+                  const double loYLimit,
+                  const double hiYLimit) :
+      xAxis(nXBins, loXLimit, hiXLimit),
+      yAxis(nYBins ? nYBins : 1, loYLimit, hiYLimit),
+      is2D(nYBins != 0)
+    {
+      if (!(loXLimit < hiXLimit) || (is2D && !(loYLimit < hiYLimit)))
+        throw std::runtime_error("HistShard: fixed histogram limits required");
+    }
+
+    /// total # of bins incl under/overflow
+    unsigned nCells() const {
+      return (xAxis.GetNbins() + 2)*(is2D ? yAxis.GetNbins() + 2 : 1);
+    }
+
+    /// throw if histogram binning differs from shard binning
+    void checkBinning(const TH1 &hist) const {
+      if (!sameAxis(*hist.GetXaxis(), xAxis) ||
+          (is2D && !sameAxis(*hist.GetYaxis(), yAxis)))
+        throw std::runtime_error(std::string("HistShard: binning mismatch for histogram: ") +
+                                 hist.GetName());
+    }
+
+    TAxis xAxis;
+    TAxis yAxis;
+    const bool is2D;
+
+  private:
+    static bool sameAxis(const TAxis &a, const TAxis &b) {
+      return a.GetNbins() == b.GetNbins() &&
+        a.GetXmin() == b.GetXmin() &&
+        a.GetXmax() == b.GetXmax();
+    }
+  };
+
+  /** \brief bin arrays & running statistics for single histogram
+
+  fill methods follow TH1::Fill(x), TH2::Fill(x,y) & TProfile::Fill(x,y)
+  step by step (unit weights, fixed binning).
+  */
+  class BinShard {
+  public:
+    BinShard(const HistShardAxes &axes,
+             const bool profile) :
+      m_axes(axes),
+      m_counts(axes.nCells(), 0),
+      m_sumY(profile ? axes.nCells() : 0, 0),
+      m_sumY2(profile ? axes.nCells() : 0, 0),
+      m_entries(0)
+    {
+      std::fill(m_stats, m_stats + TH1::kNstat, 0);
+    }
+
+    /// 1D fill
+    void fill(const double x) {
+      m_entries++;
+      const int bin = m_axes.xAxis.FindFixBin(x);
+      countBin(bin);
+
+      if (!inRange(bin, m_axes.xAxis) && !TH1::GetStatOverflows())
+        return;
+
+      m_stats[0]++;
+      m_stats[1]++;
+      m_stats[2] += x;
+      m_stats[3] += x*x;
+    }
+
+    /// 2D fill
+    void fill2D(const double x,
+                const double y) {
+      m_entries++;
+      const int binx = m_axes.xAxis.FindFixBin(x);
+      const int biny = m_axes.yAxis.FindFixBin(y);
+      countBin(biny*(m_axes.xAxis.GetNbins() + 2) + binx);
+
+      if ((!inRange(binx, m_axes.xAxis) || !inRange(biny, m_axes.yAxis)) &&
+          !TH1::GetStatOverflows())
+        return;
+
+      m_stats[0]++;
+      m_stats[1]++;
+      m_stats[2] += x;
+      m_stats[3] += x*x;
+      m_stats[4] += y;
+      m_stats[5] += y*y;
+      m_stats[6] += x*y;
+    }
+
+    /// profile fill
+    void fillProfile(const double x,
+                     const double y) {
+      m_entries++;
+      const int bin = m_axes.xAxis.FindFixBin(x);
+      m_sumY[bin]  += y;
+      m_sumY2[bin] += y*y;
+      countBin(bin);
+
+      if (!inRange(bin, m_axes.xAxis) && !TH1::GetStatOverflows())
+        return;
+
+      m_stats[0]++;
+      m_stats[1]++;
+      m_stats[2] += x;
+      m_stats[3] += x*x;
+      m_stats[4] += y;
+      m_stats[5] += y*y;
+    }
+
+    double getEntries() const {
+      return m_entries;
+    }
+
+    /// add shard contents to (non-profile) histogram
+    template <typename HistType>
+    void mergeInto(HistType &hist) const {
+      m_axes.checkBinning(hist);
+      mergeBinCounts(hist, &m_counts[0], m_counts.size(), m_entries, m_stats);
+    }
+
+    /// add shard contents to profile histogram
+    void mergeInto(TProfile &prof) const {
+      m_axes.checkBinning(prof);
+
+      Double_t stats[TH1::kNstat];
+      std::fill(stats, stats + TH1::kNstat, 0);
+      prof.GetStats(stats);
+      const Double_t entries = prof.GetEntries() + m_entries;
+
+      TArrayD &sumY = prof;
+      TArrayD &sumY2 = *prof.GetSumw2();
+      for (unsigned bin = 0; bin < m_counts.size(); bin++) {
+        if (m_counts[bin] == 0)
+          continue;
+
+        sumY.fArray[bin]  += m_sumY[bin];
+        sumY2.fArray[bin] += m_sumY2[bin];
+        prof.SetBinEntries(bin, prof.GetBinEntries(bin) + m_counts[bin]);
+      }
+
+      for (unsigned i = 0; i < TH1::kNstat; i++)
+        stats[i] += m_stats[i];
+      prof.PutStats(stats);
+      prof.SetEntries(entries);
+    }
+
+    /// append contents to process task result (filled bins only)
+    void pack(std::string &buf) const {
+      packVal(buf, m_entries);
+      packArray(buf, m_stats, TH1::kNstat);
+
+      const unsigned nFilled = m_counts.size() -
+        std::count(m_counts.begin(), m_counts.end(), 0U);
+      packVal(buf, nFilled);
+      for (unsigned bin = 0; bin < m_counts.size(); bin++) {
+        if (m_counts[bin] == 0)
+          continue;
+
+        packVal(buf, bin);
+        packVal(buf, m_counts[bin]);
+        if (!m_sumY.empty()) {
+          packVal(buf, m_sumY[bin]);
+          packVal(buf, m_sumY2[bin]);
+        }
+      }
+    }
+
+    /// read contents written by pack() into empty BinShard w/ same binning
+    void unpack(ResultReader &reader) {
+      reader.read(m_entries);
+      reader.readArray(m_stats, TH1::kNstat);
+
+      unsigned nFilled = 0;
+      reader.read(nFilled);
+      for (unsigned i = 0; i < nFilled; i++) {
+        unsigned bin = 0;
+        reader.read(bin);
+        if (bin >= m_counts.size())
+          throw std::runtime_error("BinShard::unpack(): invalid bin");
+
+        reader.read(m_counts[bin]);
+        if (!m_sumY.empty()) {
+          reader.read(m_sumY[bin]);
+          reader.read(m_sumY2[bin]);
+        }
+      }
+    }
+
+  private:
+    /// disabled
+    BinShard(const BinShard &);
+    BinShard &operator=(const BinShard &);
+
+    static bool inRange(const int bin,
+                        const TAxis &axis) {
+      return bin > 0 && bin <= axis.GetNbins();
+    }
+
+    /// count single fill, saturate instead of wrapping
+    void countBin(const int bin) {
+      UInt_t &count = m_counts[bin];
+      if (count != UINT_MAX)
+        count++;
+    }
+
+    const HistShardAxes &m_axes;
+
+    /// fills per bin (under/overflow incl)
+    std::vector<UInt_t> m_counts;
+
+    /// profile only: sum of y, y^2 per bin
+    std::vector<double> m_sumY;
+    std::vector<double> m_sumY2;
+
+    double m_entries;
+
+    /// same layout as TH1::GetStats()
+    double m_stats[TH1::kNstat];
+  };
+
+  /// retrieve BinShard for dense index (NULL if not filled)
+  template <typename IdxType>
+  inline const BinShard *lookupBins(const CalUtil::CalVec<IdxType, BinShard*> &bins,
+                                    const IdxType &idx) {
+    return bins[idx];
+  }
+
+  /// retrieve BinShard for sparse index (NULL if not filled)
+  template <typename IdxType>
+  inline const BinShard *lookupBins(const std::map<IdxType, BinShard*> &bins,
+                                    const IdxType &idx) {
+    const typename std::map<IdxType, BinShard*>::const_iterator it(bins.find(idx));
+    return (it == bins.end()) ? 0 : it->second;
+  }
+
+  /** \brief per worker fill buffer for one histogram collection
+
+  created by HistVec::newShard() / HistMap::newShard() & merged back w/
+  HistVec::mergeShard() / HistMap::mergeShard().
+
+  \param BinMap maps IdxType -> BinShard* (NULL for unfilled index).
+  CalUtil::CalVec for dense HistVec indices, std::map for sparse HistMap indices.
+  */
+  template <typename IdxType,
+            typename HistType,
+            typename BinMap = CalUtil::CalVec<IdxType, BinShard*> >
+  class HistShard {
+  public:
+    typedef HistShardTraits<HistType> Traits;
+
+    /// binning should match parent histogram collection
+    HistShard(const unsigned nXBins,
+              const double loXLimit,
+              const double hiXLimit,
+              const unsigned nYBins = 0,
+              const double loYLimit = 0,
+              const double hiYLimit = 0) :
+      m_axes(nXBins, loXLimit, hiXLimit,
+             nYBins, loYLimit, hiYLimit)
+    {}
+
+    ~HistShard() {
+      for (unsigned i = 0; i < m_filled.size(); i++)
+        delete m_bins[m_filled[i]];
+    }
+
+    /// equivalent to produceHist(idx).Fill(x)
+    void fill(const IdxType &idx,
+              const double x) {
+      produceBins(idx).fill(x);
+    }
+
+    /// equivalent to produceHist(idx).Fill(x,y) for TH2 or TProfile
+    void fill(const IdxType &idx,
+              const double x,
+              const double y) {
+      if (Traits::PROFILE)
+        produceBins(idx).fillProfile(x, y);
+      else
+        produceBins(idx).fill2D(x, y);
+    }
+
+    /// # of fills for given index
+    unsigned getEntries(const IdxType &idx) const {
+      const BinShard *const bins = lookupBins(m_bins, idx);
+      return (bins == 0) ? 0 : (unsigned)bins->getEntries();
+    }
+
+    /// same as HistVec::getMinEntries() for histograms filled in this shard
+    unsigned getMinEntries() const {
+      unsigned retVal = UINT_MAX;
+      for (unsigned i = 0; i < m_filled.size(); i++) {
+        const unsigned nEntries = getEntries(m_filled[i]);
+        if (nEntries != 0)
+          retVal = std::min(retVal, nEntries);
+      }
+
+      return (retVal == UINT_MAX) ? 0 : retVal;
+    }
+
+    /// indices w/ at least one fill, in order of first fill
+    const std::vector<IdxType> &getFilledIdx() const {
+      return m_filled;
+    }
+
+    /// add contents for given index to histogram
+    void mergeInto(const IdxType &idx,
+                   HistType &hist) const {
+      const BinShard *const bins = lookupBins(m_bins, idx);
+      if (bins != 0)
+        bins->mergeInto(hist);
+    }
+
+    /// append all filled histograms to process task result
+    /// \note IdxType is copied as plain data (CalUtil index types)
+    void pack(std::string &buf) const {
+      packVal(buf, (unsigned)m_filled.size());
+      for (unsigned i = 0; i < m_filled.size(); i++) {
+        packVal(buf, m_filled[i]);
+        lookupBins(m_bins, m_filled[i])->pack(buf);
+      }
+    }
+
+    /// read contents written by pack() in worker process into this
+    /// (empty) shard, which must have same binning
+    void unpack(ResultReader &reader) {
+      if (!m_filled.empty())
+        throw std::runtime_error("HistShard::unpack(): shard not empty");
+
+      unsigned nFilled = 0;
+      reader.read(nFilled);
+      for (unsigned i = 0; i < nFilled; i++) {
+        // IdxType need not be default constructible
+        union {
+          char   bytes[sizeof(IdxType)];
+          double align;
+        } raw;
+        reader.readArray(raw.bytes, sizeof(IdxType));
+        const IdxType idx(*reinterpret_cast<const IdxType*>(raw.bytes));
+
+        produceBins(idx).unpack(reader);
+      }
+    }
+
+  private:
+    /// disabled
+    HistShard(const HistShard &);
+    HistShard &operator=(const HistShard &);
+
+    BinShard &produceBins(const IdxType &idx) {
+      BinShard *&bins = m_bins[idx];
+      if (bins == 0) {
+        bins = new BinShard(m_axes, Traits::PROFILE);
+        m_filled.push_back(idx);
+      }
+
+      return *bins;
+    }
+
+    HistShardAxes m_axes;
+
+    BinMap m_bins;
+
+    std::vector<IdxType> m_filled;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
@@ -9,7 +9,10 @@
 
 // LOCAL INCLUDES
 #include "src/lib/Util/ROOTUtil.h"
+#include "src/lib/Util/ThreadUtil.h"
 #include "HistIdx.h"
+#include "HistShard.h"
+#include "FlatHistBuf.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalVec.h"
@@ -71,6 +74,12 @@ namespace calibGenCAL {
        type collection of 1D ROOT histograms
 
        \note histograms are created as needed.
+       \note loadHistsLazy() indexes histograms in an input directory
+       w/out reading them, each histogram is read on first access.
+       begin(), readAllHists(), resetHists(), detachHists(), Write()
+       & addHists() (for other collection) read all pending
+       histograms.  getMinEntries() & trimHists() read each pending
+       histogram at most once to count its entries, but do not keep it.
      
        \param IdxType intended to be index data type following conventions set in CalUtil::CalDefs
        \param HistType expected to be descendent of ROOT TH1 class
@@ -96,13 +105,17 @@ namespace calibGenCAL {
             const float hiYLimit=0
             ) :
       m_writeDir(writeDir),
+      m_detached(false),
+      m_flat(0),
       m_histBasename(histBasename),
       m_nXBins(nXBins),
       m_loXLimit(loXLimit),
       m_hiXLimit(hiXLimit),
       m_nYBins(nYBins),
       m_loYLimit(loYLimit),
-      m_hiYLimit(hiYLimit)
+      m_hiYLimit(hiYLimit),
+      m_idxStrs(IdxStrTable<IdxType>::get()),
+      m_dirCache(writeDir)
     {
       if (readDir != 0)
         loadHists(*readDir);
@@ -112,19 +125,53 @@ namespace calibGenCAL {
     }
 
     /// leave histogram objects under ROOT control
-    virtual ~HistVec() {}
+    /// \note fills still pending in fill() buffer are merged into
+    /// directory bound histograms first, so that they are complete
+    /// when their directory is written.
+    virtual ~HistVec() {
+      if (m_flat != 0 && m_flat->isPending() && m_writeDir != 0)
+        try {
+          flushFills();
+        } catch (...) {
+          // never throw from dtor
+        }
+
+      delete m_flat;
+    }
+
+    /// merge buffered fills & write all histograms to their directories
+    /// (replaces any previous cycle of same histogram)
+    void Write() {
+      flushFills();
+      readAllHists();
 
-    /// delete all histogram objects
+      ROOTIOLock ioLock;
+      for (IdxType idx; idx.isValid(); idx++)
+        if (m_vec[idx] != 0 && m_vec[idx]->GetDirectory() != 0)
+          m_vec[idx]->Write(0, TObject::kOverwrite);
+    }
+
+    /// delete all histogram objects (& any unmerged fills)
     void deleteHists() {
-      for (IdxType idx; idx.isValid(); idx++) 
+      if (m_flat != 0)
+        m_flat->reset();
+
+      for (IdxType idx; idx.isValid(); idx++) {
+        m_keys[idx] = 0;
         if (m_vec[idx] !=0) {
           delete m_vec[idx];
           m_vec[idx] = 0;
         }
+      }
     }
 
     /// call h.reset() for each h in histogram collection
     void resetHists() {
+      if (m_flat != 0)
+        m_flat->reset();
+
+      readAllHists();
+
       for (IdxType idx; idx.isValid(); idx++) 
         if (m_vec[idx] !=0)
           m_vec[idx]->Reset();
@@ -137,20 +184,76 @@ namespace calibGenCAL {
 
     /// return pointer to histogram for given index, return 0 if it doesn't exist
     HistType *getHist(const IdxType &idx) {
-      return m_vec[idx];
+      flushFills(idx);
+      return readHist(idx);
     }
 
     /// retrieve histogram for given index, build it if it doesn't exist.
     HistType &produceHist(const IdxType &idx) {
       // create new hist if needed
-      if (m_vec[idx] == 0)
+      if (readHist(idx) == 0)
         m_vec[idx] = genHist(idx);
 
       return *m_vec[idx];
     }
 
+    /// true if histogram exists for given index (in memory or in
+    /// lazy index), w/out reading it
+    bool hasHist(const IdxType &idx) const {
+      return m_vec[idx] != 0 || m_keys[idx] != 0;
+    }
+
+    /// index all associated histograms in readDir w/out reading them.
+    /// each histogram is read on first getHist() / produceHist() call
+    /// for its index.
+    /// \note readDir must stay open for lifetime of collection
+    void loadHistsLazy(TDirectory &readDir) {
+      TDirectory *const histdir = readDir.GetDirectory(m_histBasename.c_str());
+      //  nothing to do if that directory has not been created.
+      if (histdir == 0)
+        return;
+
+      std::map<std::string, TKey*> keyIndex;
+      indexROOTKeys(*histdir, m_histBasename + "_", keyIndex);
+      if (keyIndex.empty())
+        return;
+
+      for (IdxType idx; idx.isValid(); idx++) {
+        const std::map<std::string, TKey*>::const_iterator it(keyIndex.find(genHistName(idx)));
+        if (it != keyIndex.end()) {
+          m_keys[idx] = it->second;
+          m_keyEntries[idx] = -1;
+        }
+      }
+    }
+
+    /// read all histograms still pending in lazy index
+    void readAllHists() const {
+      for (IdxType idx; idx.isValid(); idx++)
+        readHist(idx);
+    }
+
+    /// delete histogram read from lazy index, it will be read again
+    /// on next access.
+    /// \note intended for unmodified input histograms, does nothing
+    /// if collection has write directory or histogram did not come
+    /// from lazy index.
+    void releaseHist(const IdxType &idx) {
+      if (m_keys[idx] == 0 || m_writeDir != 0 || m_vec[idx] == 0)
+        return;
+
+      m_keyEntries[idx] = (int)m_vec[idx]->GetEntries();
+      delete m_vec[idx];
+      m_vec[idx] = 0;
+    }
+
     /// set directory for all contained & future histograms 
+    /// \note histograms still pending in lazy index are moved to dir
+    /// as they are read
     void setDirectory(TDirectory *const dir) {
+      m_writeDir = dir;
+      m_dirCache.reset(dir);
+
       /// loop through all possible histograms & search for each one in current root dir
       for (IdxType idx;
            idx.isValid();
@@ -159,31 +262,104 @@ namespace calibGenCAL {
         HistType *const hist_ptr = m_vec[idx];
 
         // only update existing directories
-        if (hist_ptr != 0) {
-          // construct histogram (relative) path
-          const std::string subdir(genHistPath(idx));
-
-          /// retrieve proper directory for hist (create if needed)
-          TDirectory *const histdir = deliverROOTDir(dir, subdir);
-          if (histdir == 0)
-            throw std::runtime_error(std::string("Unable to create directory: ") +
-                                     dir->GetPath() + "/" + subdir);
-          
-          hist_ptr->SetDirectory(histdir);
-        }
+        if (hist_ptr != 0)
+          attachHist(*hist_ptr, idx);
       }
+    }
 
-      m_writeDir = dir;
+    /// remove all contained & future histograms from any ROOT directory.
+    /// \note intended for thread private collections which are later
+    /// merged into a directory bound collection w/ addHists()
+    void detachHists() {
+      readAllHists();
+
+      for (IdxType idx; idx.isValid(); idx++)
+        if (m_vec[idx] != 0)
+          m_vec[idx]->SetDirectory(0);
+
+      m_writeDir = 0;
+      m_dirCache.reset(0);
+      m_detached = true;
+    }
+
+    /// add contents of each histogram in other collection to
+    /// matching histogram in this collection (create as needed)
+    void addHists(const HistVec &other) {
+      other.readAllHists();
+
+      if (other.m_flat != 0)
+        produceFlat().add(*other.m_flat);
+
+      for (IdxType idx; idx.isValid(); idx++)
+        if (other.m_vec[idx] != 0)
+          produceHist(idx).Add(other.m_vec[idx]);
+    }
+
+    /// per worker fill buffer for this collection
+    typedef HistShard<IdxType, HistType> shard_type;
+
+    /// create empty fill buffer w/ same binning as this collection
+    /// \note caller owns returned object
+    shard_type *newShard() const {
+      return new shard_type(m_nXBins,
+                            m_loXLimit,
+                            m_hiXLimit,
+                            m_nYBins,
+                            m_loYLimit,
+                            m_hiYLimit);
     }
 
+    /// add contents of fill buffer to this collection (create histograms as needed)
+    /// \note call from single thread, once per shard in shard order
+    void mergeShard(const shard_type &shard) {
+      flushFills();
+
+      const std::vector<IdxType> &filled = shard.getFilledIdx();
+      for (unsigned i = 0; i < filled.size(); i++)
+        shard.mergeInto(filled[i], produceHist(filled[i]));
+    }
+
+    /// equivalent to produceHist(idx).Fill(x) for 1D histograms
+    /// \note fills go to per channel bin buffer, histograms are
+    /// updated by flushFills() (called by getHist() for its own
+    /// channel, trimHists(), Write() & dtor)
+    void fill(const IdxType &idx,
+              const double x) {
+      produceFlat().fill(idx, x);
+    }
+
+    /// merge buffered fill() calls into histograms (create as needed)
+    void flushFills() {
+      if (m_flat == 0 || !m_flat->isPending())
+        return;
+
+      for (IdxType idx; idx.isValid(); idx++)
+        if (m_flat->getEntries(idx) != 0)
+          m_flat->mergeInto(idx, produceHist(idx));
+
+      m_flat->reset();
+    }
+
+    /// merge buffered fill() calls for single channel into its histogram
+    void flushFills(const IdxType &idx) {
+      if (m_flat == 0 || m_flat->getEntries(idx) == 0)
+        return;
+
+      m_flat->mergeInto(idx, produceHist(idx));
+      m_flat->resetChannel(idx);
+    }
+
+    /// min # of entries (incl buffered fills) over all non-empty histograms
+    /// \note histograms pending in lazy index are not kept in memory,
+    /// their entry counts are cached on 1st call.
     unsigned getMinEntries() const {
       unsigned retVal = ULONG_MAX;
 
       for (IdxType idx; idx.isValid(); idx++) {
+        unsigned nEntries = (m_flat == 0) ? 0 : m_flat->getEntries(idx);
+
         /// check for empty histograms
-        if (m_vec[idx] == 0)
-          continue;
-        const unsigned nEntries = (unsigned)m_vec[idx]->GetEntries();
+        nEntries += getEntries(idx);
 
         // only count histograms that have been filled
         // (some histograms will never be filled if we are
@@ -200,47 +376,109 @@ namespace calibGenCAL {
     }
 
     /// delete any empty histograms
+    /// \note non-empty histograms pending in lazy index stay pending
     void trimHists() {
+      flushFills();
+
       for (IdxType idx; idx.isValid(); idx++) 
-        if (m_vec[idx] !=0)
-          if (m_vec[idx]->GetEntries() == 0) {
-            delete m_vec[idx];
-            m_vec[idx] = 0;
-          }
+        if (hasHist(idx) && getEntries(idx) == 0) {
+          delete m_vec[idx];
+          m_vec[idx] = 0;
+          m_keys[idx] = 0;
+        }
     }
 
   protected:
 
     /// create new histogram and register it w/ output directory
     HistType *genHist(const IdxType &idx) {
-      if (m_writeDir == 0)
+      if (m_writeDir == 0 && !m_detached)
         throw std::runtime_error("HistVec::genHist() : Write directory not set for HistVec class");
 
       const std::string histname(genHistName(idx));
-      const std::string subdir(genHistPath(idx));
-      
-      std::ostringstream tmp;
-      tmp <<  m_writeDir->GetPath() << subdir << "/";
-      const std::string fullpath(tmp.str());
 
-      HistType *newHist=constructHist(idx);
-      newHist->SetNameTitle(histname.c_str(), histname.c_str());
+      // TH1 ctor & SetDirectory() use gDirectory
+      ROOTIOLock ioLock;
+
+      if (m_detached) {
+        HistType *const newHist = constructHist(idx);
+        if (newHist == 0)
+          throw std::runtime_error(std::string("Unable to create histogram: ") +
+                                   histname);
+
+        newHist->SetDirectory(0);
+        newHist->SetNameTitle(histname.c_str(), histname.c_str());
+        return newHist;
+      }
 
+      HistType *newHist=constructHist(idx);
       if (newHist == 0) 
         throw std::runtime_error(std::string("Unable to create histogram: ") +
                                  histname);
-      
-      /// retrieve proper directory for hist (create if needed)
-      TDirectory *const histdir = deliverROOTDir(m_writeDir, subdir);
-      if (histdir == 0)
-        throw std::runtime_error(std::string("Unable to create directory: ") +
-                                 fullpath);
 
-      newHist->SetDirectory(histdir);
+      newHist->SetNameTitle(histname.c_str(), histname.c_str());
+      
+      attachHist(*newHist, idx);
 
       return newHist;
     }
 
+    /// move hist to proper subdirectory of m_writeDir (create if needed)
+    void attachHist(HistType &hist,
+                    const IdxType &idx) const {
+      hist.SetDirectory(&m_dirCache.produceDir(genHistPath(idx)));
+    }
+
+    /// return histogram for given index, read it from lazy index if
+    /// it is not yet in memory
+    /// \return 0 if histogram does not exist
+    HistType *readHist(const IdxType &idx) const {
+      TKey *const key = m_keys[idx];
+      if (m_vec[idx] != 0 || key == 0)
+        return m_vec[idx];
+
+      ROOTIOLock ioLock;
+      HistType *const hist_ptr = dynamic_cast<HistType*>(key->ReadObj());
+      /// skip if obj is wrong type
+      if (hist_ptr == 0) {
+        m_keys[idx] = 0;
+        return 0;
+      }
+
+      /// follow setDirectory() / detachHists() for eagerly read histograms
+      if (m_detached)
+        hist_ptr->SetDirectory(0);
+      else if (m_writeDir != 0)
+        attachHist(*hist_ptr, idx);
+
+      m_vec[idx] = hist_ptr;
+      return hist_ptr;
+    }
+
+    /// # of entries in histogram for given index (0 if none), histograms
+    /// pending in lazy index are read & deleted once, then count is cached.
+    unsigned getEntries(const IdxType &idx) const {
+      if (m_vec[idx] != 0)
+        return (unsigned)m_vec[idx]->GetEntries();
+
+      TKey *const key = m_keys[idx];
+      if (key == 0)
+        return 0;
+
+      if (m_keyEntries[idx] < 0) {
+        ROOTIOLock ioLock;
+        TH1 *const hist = dynamic_cast<TH1*>(key->ReadObj());
+        if (hist == 0)
+          return 0;
+
+        hist->SetDirectory(0);
+        m_keyEntries[idx] = (int)hist->GetEntries();
+        delete hist;
+      }
+
+      return m_keyEntries[idx];
+    }
+
     virtual HistType *constructHist(const IdxType &) {
       return __constructHist<HistType>(m_nXBins,
                                        m_loXLimit,
@@ -253,49 +491,56 @@ namespace calibGenCAL {
     /// all new histograms (& modified) written to this directory
     TDirectory * m_writeDir;
 
+    /// if true, new histograms are not attached to any directory
+    bool m_detached;
+
+    typedef FlatHistBuf<IdxType, HistType> FlatBufType;
+
+    /// retrieve fill() buffer, create if needed
+    FlatBufType &produceFlat() {
+      if (m_flat == 0) {
+        if (m_nYBins != 0 || HistShardTraits<HistType>::PROFILE)
+          throw std::runtime_error("HistVec::fill() : 1D histograms only");
+        m_flat = new FlatBufType(m_nXBins, m_loXLimit, m_hiXLimit);
+      }
+
+      return *m_flat;
+    }
+
+    /// buffer for fill() (created on 1st use)
+    FlatBufType *m_flat;
+
     std::string genHistName(const IdxType &idx) const {
-      return m_histBasename + "_" + idx.toStr();
+      return m_histBasename + "_" + m_idxStrs.getStr(idx);
     }
 
   
     /// generate appropriate subdirectory for histogram
     std::string genHistPath(const IdxType &idx) const {
-      ostringstream tmp;
-      tmp << m_histBasename << "/"
-          << toPath(idx);
-      return tmp.str();
+      return m_histBasename + "/" + m_idxStrs.getPath(idx);
     }
 
     /// load all associated histogram from current ROOT directory 
     void loadHists(TDirectory &readDir) {
-      /// loop through all possible histograms & search for each one in current root dir
-      for (IdxType idx;
-           idx.isValid();
-           idx++) {
-        // retrieve histogram name
-        const std::string histname(genHistName(idx));
-        // retrieve histogram (relative) path
-        const std::string subdir(genHistPath(idx));
-                
-        TDirectory *const histdir(readDir.GetDirectory(subdir.c_str()));
-        //  move on if that directory has not been created.
-        if (histdir == 0)
-          continue;
-        
-        /// try to retrieve obj from dir
-        HistType *const hist_ptr = retrieveROOTObj<HistType>(*histdir, 
-                                                             histname.c_str());
-        /// skip if histogram doesn't exit
-        if (hist_ptr == 0)
-          continue;
-
-        m_vec[idx] = hist_ptr;
-      }
+      loadHistsLazy(readDir);
+      readAllHists();
+
+      // eagerly read histograms do not depend on readDir afterwards
+      for (IdxType idx; idx.isValid(); idx++)
+        m_keys[idx] = 0;
     }
 
 
     typedef CalUtil::CalVec<IdxType,HistType*> VecType;
-    VecType m_vec;
+    /// \note mutable so that const accessors can read pending histograms
+    mutable VecType m_vec;
+
+    /// input keys indexed by loadHistsLazy() (0 if none)
+    mutable CalUtil::CalVec<IdxType,TKey*> m_keys;
+
+    /// cached GetEntries() of histograms in m_keys which are not in
+    /// memory (-1 if not yet counted)
+    mutable CalUtil::CalVec<IdxType,int> m_keyEntries;
  
     /// shared histogram name prefix
     const std::string m_histBasename;
@@ -308,9 +553,21 @@ namespace calibGenCAL {
     const float m_loYLimit;
     const float m_hiYLimit;
 
+    /// shared idx.toStr() & toPath(idx) strings
+    const IdxStrTable<IdxType> &m_idxStrs;
+
+    /// subdirectories of m_writeDir
+    mutable ROOTDirCache m_dirCache;
+
+  private:
+    /// disabled
+    HistVec(const HistVec &);
+    HistVec &operator=(const HistVec &);
+
   public:
     typedef typename VecType::const_iterator const_iterator;
-    const_iterator begin() const {return m_vec.begin();}
+    /// \note reads all histograms pending in lazy index
+    const_iterator begin() const {readAllHists(); return m_vec.begin();}
     const_iterator end() const {return m_vec.end();}
 
   };
@@ -9,6 +9,7 @@
 #include "src/lib/Util/LangauFun.h"
 #include "src/lib/Util/CGCUtil.h"
 #include "src/lib/Util/ROOTUtil.h"
+#include "src/lib/Util/ChannelFitExecutor.h"
 #include "src/lib/Specs/CalResponse.h"
 
 // GLAST INCLUDES
@@ -20,6 +21,7 @@
 #include "TF1.h"
 #include "TGraph.h"
 #include "TStyle.h"
+#include "TROOT.h"
 
 // STD INCLUDES
 #include <limits.h>
@@ -27,6 +29,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <map>
+#include <vector>
 
 namespace calibGenCAL {
 
@@ -117,29 +120,133 @@ namespace calibGenCAL {
     }
   }
 
-  void MPDHists::fitHists(CalMPD &calMPD) {
-    TGraph graph;
-
-    //LogStrm::get() << "Muon Peak Fit Results: " << endl;
-    //LogStrm::get() << " SCALE\tXTAL\tMPV\tLanWid\tGauWid\tTotalWid\tBckgnd" << endl;
+  /** \brief fit dacLL, dacL2S & dacL2S_slope histograms for each xtal
+
+  results: fit status, mpv, width, packed dacLL function, # of L2S values,
+  then (if L2S hist is present) L2S axis range & packed gaussian,
+  # of slope points.
+  */
+  class MPDHists::XtalFitter : public ChannelFitter {
+  public:
+    XtalFitter(MPDHists &mpdHists,
+               CalMPD &calMPD) :
+      m_mpdHists(mpdHists),
+      m_calMPD(calMPD),
+      m_fitFunc(*mpdHists.m_fitFunc),
+      m_initPars(m_fitFunc.GetParameters(),
+                 m_fitFunc.GetParameters() + m_fitFunc.GetNpar()),
+      m_gaus(*(TF1*)gROOT->GetFunction("gaus"))
+    {
+      for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++) {
+        //for (XtalIdx xtalIdx; xtalIdx.val() < 10; xtalIdx++) {
+        TH1S *const histLL = mpdHists.m_dacLLHists[xtalIdx];
+        // skip empty histograms
+        if (!histLL || histLL->GetEntries() == 0)
+          continue;
+
+        m_xtalIdx.push_back(xtalIdx);
+      }
+    }
 
-    // PER XTAL LOOP
-    for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++) {
-      //for (XtalIdx xtalIdx; xtalIdx.val() < 10; xtalIdx++) {
-      if (!m_dacLLHists[xtalIdx])
-        continue;
+    unsigned nChannels() const {
+      return m_xtalIdx.size();
+    }
 
-      TH1S & histLL = *m_dacLLHists[xtalIdx];
-      // skip empty histograms
-      if (histLL.GetEntries() == 0)
-        continue;
+    bool fitChannel(const unsigned channel,
+                    vector<double> &results) {
+      const XtalIdx xtalIdx(m_xtalIdx[channel]);
 
       ///////////////////////////////////
       //-- MeV Per Dac (Lrg Diode) --//
       ///////////////////////////////////
 
+      // start each xtal from same initial parameters so that results
+      // do not depend on which xtal was fit previously by this process.
+      m_fitFunc.SetParameters(&m_initPars[0]);
+
+      TH1S & histLL = *m_mpdHists.m_dacLLHists[xtalIdx];
       float mpv, width;
-      fitChannel(histLL, mpv, width);
+      const int fitResult = m_mpdHists.fitChannel(histLL, mpv, width);
+
+      results.push_back(fitResult);
+      results.push_back(mpv);
+      results.push_back(width);
+      ChannelFitExecutor::packFitFunc(m_fitFunc, results);
+
+      // LRG 2 SM Ratio
+      TH1S *histL2S = m_mpdHists.m_dacL2SHists[xtalIdx];
+      // skip if we have no small diode info for this channel
+      if (!histL2S || !histL2S->GetEntries()) {
+        results.push_back(0);
+        return true;
+      }
+      results.push_back(1);
+
+      // trim outliers - 3 times cut out anything outside 3 sigma
+      float lo = 0, hi = 0;
+      for (unsigned short iter = 0; iter < 3; iter++) {
+        // get current mean & RMS
+        const float av  = histL2S->GetMean();
+        const float rms = histL2S->GetRMS();
+
+        // trim new histogram limits
+        lo = av - 3*rms;
+        hi = av + 3*rms;
+        histL2S->SetAxisRange(lo, hi);
+      }
+
+      // fit gaussian to get mean ratio
+      histL2S->Fit("gaus", "Q");
+      results.push_back(lo);
+      results.push_back(hi);
+      ChannelFitExecutor::packFitFunc((TF1&)*histL2S->GetFunction("gaus"), results);
+
+      ////////////////////
+      //-- L2S Slope  --//
+      ////////////////////
+
+      // LRG 2 SM Ratio
+      TProfile & p = *m_mpdHists.m_dacL2SSlopeProfs[xtalIdx];    // get profile
+
+      // Fill scatter graph w/ smDAC vs lrgDAC points
+      unsigned nPts = 0;
+      m_graph.Set(nPts);                              // start w/ empty graph
+      for (unsigned i = 0; i < N_L2S_PTS; i++) {
+        // only insert a bin if it has entries
+        if (!(p.GetBinEntries(i+1) > 0)) continue;    // bins #'d from 1
+        nPts++;
+
+        // retrieve sm & lrg dac vals
+        const float smDAC  = p.GetBinContent(i+1);
+        const float lrgDAC = p.GetBinCenter(i+1);
+
+        // update graphsize & set point
+        m_graph.Set(nPts);
+        m_graph.SetPoint(nPts-1, lrgDAC, smDAC);
+      }
+      results.push_back(nPts);
+
+      // fit straight line to get mean ratio
+      if (nPts >= 2)
+        m_graph.Fit("pol1", "WQN");
+
+      return true;
+    }
+
+    void storeResults(const unsigned channel,
+                      const vector<double> &results) {
+      const XtalIdx xtalIdx(m_xtalIdx[channel]);
+      TH1S & histLL = *m_mpdHists.m_dacLLHists[xtalIdx];
+
+      const int fitResult = (int)results[0];
+      if (fitResult !=0)
+        LogStrm::get() << "MPD ROOT fitting error code: " << fitResult
+                       << " " << histLL.GetName() << endl;
+
+      const float mpv   = results[1];
+      const float width = results[2];
+      unsigned pos = ChannelFitExecutor::attachFitFunc(histLL, m_fitFunc, results, 3);
+
       LogStrm::get() << xtalIdx.val() << " "
                        << mpv << " "
                        << width << " "
@@ -149,40 +256,26 @@ namespace calibGenCAL {
       //createResidHist(histLL);
 
       const float mpdLrg    = CalResponse::CsIMuonPeak/mpv;
-      calMPD.setMPD(xtalIdx, LRG_DIODE, mpdLrg);
+      m_calMPD.setMPD(xtalIdx, LRG_DIODE, mpdLrg);
 
       // keep width proportional to new scale
       const float mpdErrLrg = mpdLrg * width/mpv;
-      calMPD.setMPDErr(xtalIdx, LRG_DIODE, mpdErrLrg);
+      m_calMPD.setMPDErr(xtalIdx, LRG_DIODE, mpdErrLrg);
 
       ////////////////////
       //-- (Sm Diode) --//
       ////////////////////
 
-      // LRG 2 SM Ratio
-      TH1S *histL2S = m_dacL2SHists[xtalIdx];
-      // skip if we have no small diode info for this channel
-      if (!histL2S)
-        continue;
-      if (!histL2S->GetEntries())
-        continue;
-    
-
-      // trim outliers - 3 times cut out anything outside 3 sigma
-      for (unsigned short iter = 0; iter < 3; iter++) {
-        // get current mean & RMS
-        const float av  = histL2S->GetMean();
-        const float rms = histL2S->GetRMS();
+      if (results[pos++] == 0)
+        return;
 
-        // trim new histogram limits
-        histL2S->SetAxisRange(av - 3*rms, av + 3*rms);
-      }
+      TH1S &histL2S = *m_mpdHists.m_dacL2SHists[xtalIdx];
+      histL2S.SetAxisRange(results[pos], results[pos+1]);
+      pos = ChannelFitExecutor::attachFitFunc(histL2S, m_gaus, results, pos+2);
 
-      // fit gaussian to get mean ratio
-      histL2S->Fit("gaus", "Q");
       // mean ratio of smDac/lrgDac
-      float sm2lrg = ((TF1&)*histL2S->GetFunction("gaus")).GetParameter(1);
-      float s2lsig = ((TF1&)*histL2S->GetFunction("gaus")).GetParameter(2);
+      float sm2lrg = ((TF1&)*histL2S.GetFunction("gaus")).GetParameter(1);
+      float s2lsig = ((TF1&)*histL2S.GetFunction("gaus")).GetParameter(2);
 
       //-- NOTES:
       // MPDLrg     = MeV/LrgDAC
@@ -191,7 +284,7 @@ namespace calibGenCAL {
       //              = MPDLrg/sm2lrg
 
       const float mpdSm = mpdLrg/sm2lrg;
-      calMPD.setMPD(xtalIdx, SM_DIODE, mpdSm);
+      m_calMPD.setMPD(xtalIdx, SM_DIODE, mpdSm);
 
       //-- Propogate errors
       // in order to combine slope & MPD error for final error
@@ -202,48 +295,46 @@ namespace calibGenCAL {
       const float mpdErrSm   = mpdSm *
         sqrt(relLineErr *relLineErr + relMPDErr *relMPDErr);
 
-      calMPD.setMPDErr(xtalIdx, SM_DIODE, mpdErrSm);
+      m_calMPD.setMPDErr(xtalIdx, SM_DIODE, mpdErrSm);
 
-      ////////////////////
-      //-- L2S Slope  --//
-      ////////////////////
+      // bail if for some reason we didn't get any points
+      const unsigned nPts = (unsigned)results[pos];
+      if (nPts < 2)
+        LogStrm::get() << __FILE__  << ":"     << __LINE__ << " "
+                         << "Not enough points to find sm diode MPD slope for xtal="
+                         << xtalIdx.val() << endl;
+    }
 
-      // LRG 2 SM Ratio
-      TProfile & p = *m_dacL2SSlopeProfs[xtalIdx];    // get profile
+  private:
+    MPDHists &m_mpdHists;
+    CalMPD &m_calMPD;
 
-      // Fill scatter graph w/ smDAC vs lrgDAC points
-      unsigned nPts = 0;
-      graph.Set(nPts);                                // start w/ empty graph
-      for (unsigned i = 0; i < N_L2S_PTS; i++) {
-        // only insert a bin if it has entries
-        if (!(p.GetBinEntries(i+1) > 0)) continue;    // bins #'d from 1
-        nPts++;
+    /// dacLL fit function
+    TF1 &m_fitFunc;
+    /// dacLL fit function parameters at start of fitHists()
+    const vector<double> m_initPars;
 
-        // retrieve sm & lrg dac vals
-        const float smDAC  = p.GetBinContent(i+1);
-        const float lrgDAC = p.GetBinCenter(i+1);
+    /// prototype for dacL2S fit function
+    const TF1 &m_gaus;
 
-        // update graphsize & set point
-        graph.Set(nPts);
-        graph.SetPoint(nPts-1, lrgDAC, smDAC);
-      }
+    TGraph m_graph;
 
-      // bail if for some reason we didn't get any points
-      if (nPts < 2) {
-        LogStrm::get() << __FILE__  << ":"     << __LINE__ << " "
-                         << "Not enough points to find sm diode MPD slope for xtal="
-                         << xtalIdx.val() << endl;
-        continue;
-      }
+    /// all xtals w/ non-empty dacLL histogram
+    vector<XtalIdx> m_xtalIdx;
+  };
 
-      // fit straight line to get mean ratio
-      graph.Fit("pol1", "WQN");
-    }
+  void MPDHists::fitHists(CalMPD &calMPD,
+                          const unsigned nWorkers) {
+    //LogStrm::get() << "Muon Peak Fit Results: " << endl;
+    //LogStrm::get() << " SCALE\tXTAL\tMPV\tLanWid\tGauWid\tTotalWid\tBckgnd" << endl;
+
+    XtalFitter fitter(*this, calMPD);
+    ChannelFitExecutor(nWorkers).run(fitter, fitter.nChannels());
   }
 
-  void MPDHists::fitChannel(TH1 &hist,
-                            float &mpv,
-                            float &width) {
+  int MPDHists::fitChannel(TH1 &hist,
+                           float &mpv,
+                           float &width) {
 
     /// MPV
     m_fitFunc->SetParameter(1, 30);
@@ -254,9 +345,6 @@ namespace calibGenCAL {
     /// background height 
     m_fitFunc->SetParameter(4, 0.0);
     const int fitResult = hist.Fit(m_fitFunc, "QL");
-    if (fitResult !=0)
-      LogStrm::get() << "MPD ROOT fitting error code: " << fitResult
-                     << " " << hist.GetName() << endl;
     mpv = m_fitFunc->GetParameter(1);
 
     switch (m_fitMethod) {
@@ -275,6 +363,8 @@ namespace calibGenCAL {
     default:
       throw invalid_argument("invalid fit_method");
     }
+
+    return fitResult;
   }
 
   void MPDHists::loadHists(const TDirectory &readDir) {
@@ -313,6 +403,10 @@ namespace calibGenCAL {
 
 
     for (XtalIdx xtalIdx; xtalIdx.isValid(); xtalIdx++) {
+      // histograms may be missing after loadHists() or trimHists()
+      if (m_dacLLHists[xtalIdx] == 0)
+        continue;
+
       const unsigned nEntries = (unsigned)m_dacLLHists[xtalIdx]->GetEntries();
 
       // only count histograms that have been filled
@@ -363,6 +457,7 @@ namespace calibGenCAL {
   void MPDHists::fillDacLL(CalUtil::XtalIdx xtalIdx,
                            float dac) {
     m_dacLLHists[xtalIdx]->Fill(dac);
+    m_dacLLEntries.count(xtalIdx);
     m_dacLLSumHist->Fill(dac);
 
     //-- alg statistics histograms
@@ -8,6 +8,7 @@
 */
 
 // LOCAL INCLUDES
+#include "MinEntriesTracker.h"
 
 // GLAST INCLUDES
 #include "CalUtil/CalDefs.h"
@@ -59,8 +60,9 @@ namespace calibGenCAL {
 
     /// fit histograms & save mean gain values to calMPD
     /// \param calMPD output calibration values
-    /// \param fitMethod should be member of MPDHists::fitMethods
-    void        fitHists(CalUtil::CalMPD &calMPD);
+    /// \param nWorkers fit xtals in n parallel worker processes (see ChannelFitExecutor)
+    void        fitHists(CalUtil::CalMPD &calMPD,
+                         const unsigned nWorkers = 1);
 
     /// delete empty histograms
     /// \note useful for data w/ < 16 Cal modules.
@@ -83,6 +85,17 @@ namespace calibGenCAL {
     /// count min number of entries in all enable histograms
     unsigned    getMinEntries() const;
 
+    /// set # of dacLL entries per xtal required by entriesTargetReached()
+    void        setEntriesTarget(const unsigned nEntries) {
+      m_dacLLEntries.setTarget(nEntries);
+    }
+
+    /// O(1) check that each filled dacLL histogram has reached entries target
+    /// \note only counts fillDacLL() calls on this object
+    bool        entriesTargetReached() const {
+      return m_dacLLEntries.targetReached();
+    }
+
     template <typename T>
     static std::string genHistName(const std::string &type,
                                    const T& idx) {
@@ -108,13 +121,17 @@ namespace calibGenCAL {
     void buildTuple();
 
   private:
+    /// ChannelFitter for fitHists()
+    class XtalFitter;
+
     /// fit single channel w/ specified function & store
     /// mpv and width
     /// \param mpv location to store fitted most-probable-value
     /// \param width location to store fitted peak width
-    void fitChannel(TH1 &hist,
-                    float &mpv,
-                    float &width);
+    /// \return ROOT fit status
+    int fitChannel(TH1 &hist,
+                   float &mpv,
+                   float &width);
 
     /// profile X=bigdiodedac Y=smdiodedac 1 per xtal
     CalUtil::CalVec<CalUtil::XtalIdx, TH1S *>     m_dacL2SHists;
@@ -126,6 +143,9 @@ namespace calibGenCAL {
     /// list of histograms of geometric mean for both ends on each xtal.
     CalUtil::CalVec<CalUtil::XtalIdx, TH1S *>     m_dacLLHists;
 
+    /// fills per m_dacLLHists channel
+    MinEntriesTracker<CalUtil::XtalIdx>           m_dacLLEntries;
+
     /// contains sum of dacLLHists over all xtals
     TH1I                                         *m_dacLLSumHist;
 
@@ -0,0 +1,132 @@
+#ifndef MinEntriesTracker_h
+#define MinEntriesTracker_h
+
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+#include "CalUtil/CalVec.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <algorithm>
+#include <limits.h>
+
+namespace calibGenCAL {
+
+  /** \brief per channel fill counters w/ running count of channels below
+      target # of entries.
+
+      targetReached() is equivalent to getMinEntries() >= target (only
+      channels w/ at least one fill are considered), but costs O(1), so
+      event loops may check it after every event.
+
+      \param IdxType channel index type (conventions of CalUtil::CalDefs)
+  */
+  template <typename IdxType>
+  class MinEntriesTracker {
+  public:
+    explicit MinEntriesTracker(const unsigned target = 0) :
+      m_target(target),
+      m_nFilled(0),
+      m_nBelow(0)
+    {}
+
+    /// set new target # of entries per channel (counts are retained)
+    void setTarget(const unsigned target) {
+      m_target = target;
+      m_nBelow = 0;
+      for (IdxType idx; idx.isValid(); idx++)
+        if (m_entries[idx] != 0 && m_entries[idx] < m_target)
+          m_nBelow++;
+    }
+
+    unsigned getTarget() const {
+      return m_target;
+    }
+
+    /// register single fill for given channel
+    void count(const IdxType &idx) {
+      const unsigned nEntries = ++m_entries[idx];
+
+      if (nEntries == 1) {
+        m_nFilled++;
+        if (nEntries < m_target)
+          m_nBelow++;
+      } else if (nEntries == m_target)
+        m_nBelow--;
+    }
+
+    /// register n fills for given channel (e.g. merged from worker shard)
+    void add(const IdxType &idx,
+             const unsigned n) {
+      if (n == 0)
+        return;
+
+      const unsigned before = m_entries[idx];
+      const unsigned after  = before + n;
+      m_entries[idx] = after;
+
+      if (before == 0)
+        m_nFilled++;
+
+      const bool wasBelow = before != 0 && before < m_target;
+      const bool isBelow  = after < m_target;
+      if (wasBelow && !isBelow)
+        m_nBelow--;
+      else if (!wasBelow && isBelow)
+        m_nBelow++;
+    }
+
+    /// true when every filled channel has >= target entries
+    bool targetReached() const {
+      return m_target == 0 || (m_nFilled != 0 && m_nBelow == 0);
+    }
+
+    unsigned getEntries(const IdxType &idx) const {
+      return m_entries[idx];
+    }
+
+    /// # of channels w/ at least one fill
+    unsigned getNFilled() const {
+      return m_nFilled;
+    }
+
+    /// min # of entries over all filled channels (0 if none)
+    /// \note loops over all channels, intended for status print out
+    unsigned getMinEntries() const {
+      unsigned retVal = UINT_MAX;
+      for (IdxType idx; idx.isValid(); idx++)
+        if (m_entries[idx] != 0)
+          retVal = std::min(retVal, m_entries[idx]);
+
+      return (retVal == UINT_MAX) ? 0 : retVal;
+    }
+
+    /// zero all counters (target is retained)
+    void reset() {
+      std::fill(m_entries.begin(), m_entries.end(), 0);
+      m_nFilled = 0;
+      m_nBelow = 0;
+    }
+
+  private:
+    CalUtil::CalVec<IdxType, unsigned> m_entries;
+
+    unsigned m_target;
+
+    /// # of channels w/ >0 entries
+    unsigned m_nFilled;
+
+    /// # of channels w/ >0 && < m_target entries
+    unsigned m_nBelow;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
@@ -6,50 +6,270 @@
 
 // LOCAL INCLUDES
 #include "PedHists.h"
+#include "src/lib/Util/ChannelFitExecutor.h"
+#include "src/lib/Util/CGCUtil.h"
 
 // GLAST INCLUDES
 #include "CalUtil/SimpleCalCalib/CalPed.h"
 
 // EXTLIB INCLUDES
+#include "TF1.h"
+#include "TROOT.h"
 
 // STD INCLUDES
+#include <vector>
+#include <algorithm>
+#include <cmath>
 
 using namespace CalUtil;
 using namespace std;
 
 namespace calibGenCAL {
-  void PedHists::fitHists(CalPed &calPed) {
-    for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
-      TH1S *const hist = getHist(rngIdx);
-      // skip non existant hists
-      if (hist == 0)
-        continue;
-
-      // loop through all nSlicesPerXtal bins in pedmetry profile
-
-      // skip empty histograms
-      TH1S &h = *hist;
-      if (h.GetEntries() == 0)
-        continue;
-
-      // trim outliers
-      float av = h.GetMean(); float err = h.GetRMS();
-      for ( unsigned short iter = 0; iter < 3; iter++ ) {
-        h.SetAxisRange(av-3*err, av+3*err);
-        av = h.GetMean(); err = h.GetRMS();
+  namespace {
+    /// rms of gaussian truncated at +/- 3 times its own truncated rms,
+    /// relative to sigma (fixed point of 3 pass clipping)
+    const double TRUNC_RMS_RATIO = 0.98485;
+    /// fraction of gaussian inside same window
+    const double TRUNC_FRACTION  = 0.99687;
+
+    /// min entries inside clipping window for closed form estimate
+    const double MIN_FAST_ENTRIES = 100;
+    /// min entries in each of 3 log-parabola bins
+    const double MIN_PARABOLA_ENTRIES = 10;
+    /// max parabola vertex offset from truncated mean (units of sigma)
+    const double MAX_VERTEX_OFFSET = 0.25;
+    /// max relative difference between parabola & truncated moment sigma
+    const double MAX_SIGMA_DIFF = 0.3;
+
+    /// closed form gaussian peak parameters
+    struct GausEstimate {
+      /// mean of clipped distribution (same as Minuit path 'av')
+      double trimMean;
+      double mean;
+      double sigma;
+      /// 'gaus' normalization (peak height in counts per bin)
+      double norm;
+      /// # entries inside clipping window
+      double nEntries;
+      /// clipping window
+      double lo;
+      double hi;
+    };
+
+    /** \brief estimate gaussian peak parameters directly from bin array.
+
+    1) same 3 pass +/- 3 rms clipping as Minuit path (bin centers
+    inside window, same as SetAxisRange(); GetMean(); GetRMS())
+    2) mean & sigma from clipped moments, corrected for truncation
+    3) quality check: parabola through log of 3 adjacent peak bins
+    (grouped to ~sigma width) is exact for gaussian shape, its vertex &
+    curvature must agree w/ moments.
+
+    \return false if estimate fails quality check
+    */
+    bool estimateGaus(const TH1S &h,
+                      GausEstimate &est) {
+      const TAxis &axis = *h.GetXaxis();
+      const int nBins = axis.GetNbins();
+      const double xmin = axis.GetXmin();
+      const double binWidth = (axis.GetXmax() - xmin)/nBins;
+      const Short_t *const cells = h.fArray;
+
+      // truncated moments
+      int first = 1;
+      int last = nBins;
+      double n = 0, av = 0, rms = 0;
+      for (unsigned short iter = 0; iter < 4; iter++) {
+        if (iter > 0) {
+          first = max(1, axis.FindFixBin(av - 3*rms));
+          last  = min(nBins, axis.FindFixBin(av + 3*rms));
+        }
+
+        double sumx = 0, sumx2 = 0;
+        n = 0;
+        for (int bin = first; bin <= last; bin++) {
+          const double w = cells[bin];
+          const double x = xmin + (bin - 0.5)*binWidth;
+          n     += w;
+          sumx  += w*x;
+          sumx2 += w*x*x;
+        }
+        if (n < MIN_FAST_ENTRIES)
+          return false;
+
+        av  = sumx/n;
+        rms = sqrt(max(0.0, sumx2/n - av*av));
       }
 
-      // gaussian fit
-      h.Fit("gaus", "Q", "", av-3*err, av+3*err );
-      h.SetAxisRange(av-150, av+150);
+      // no binning correction: Minuit 'gaus' fit to bin contents also
+      // measures width of binned distribution.
+      if (!(rms > 0))
+        return false;
+      const double sigma = rms/TRUNC_RMS_RATIO;
+
+      // log-parabola on 3 groups of 'g' bins centered on mean bin
+      const int halfGroup = (int)(sigma/binWidth/2);
+      const int groupBins = 2*halfGroup + 1;
+      const int ctrBin = axis.FindFixBin(av);
+      if (ctrBin - 3*halfGroup - 1 < first ||
+          ctrBin + 3*halfGroup + 1 > last)
+        return false;
+
+      double groupSum[3] = {0, 0, 0};
+      for (int i = 0; i < 3; i++) {
+        const int groupCtr = ctrBin + (i - 1)*groupBins;
+        for (int bin = groupCtr - halfGroup; bin <= groupCtr + halfGroup; bin++)
+          groupSum[i] += cells[bin];
+        if (groupSum[i] < MIN_PARABOLA_ENTRIES)
+          return false;
+      }
 
-      // assign values to permanent arrays
-      calPed.setPed(rngIdx,
-                    ((TF1&)*h.GetFunction("gaus")).GetParameter(1));
-      calPed.setPedSig(rngIdx,
-                       ((TF1&)*h.GetFunction("gaus")).GetParameter(2));
+      const double lm = log(groupSum[0]);
+      const double l0 = log(groupSum[1]);
+      const double lp = log(groupSum[2]);
+      const double d2 = lp - 2*l0 + lm;
+      if (!(d2 < 0))
+        return false;
 
+      const double groupWidth = groupBins*binWidth;
+      const double vertex = axis.GetBinCenter(ctrBin) - groupWidth*(lp - lm)/(2*d2);
+      // each group sums binned gaussian over 'groupBins' adjacent bins
+      const double varP = -groupWidth*groupWidth/d2 -
+        (groupBins*groupBins - 1)*binWidth*binWidth/12;
+      if (varP <= 0)
+        return false;
+
+      if (fabs(vertex - av) > MAX_VERTEX_OFFSET*sigma + binWidth/2)
+        return false;
+      if (fabs(sqrt(varP)/sigma - 1) > MAX_SIGMA_DIFF)
+        return false;
+
+      est.trimMean = av;
+      est.mean     = av;
+      est.sigma    = sigma;
+      est.nEntries = n;
+      est.norm     = n/TRUNC_FRACTION*binWidth/(sqrt(2*M_PI)*sigma);
+      est.lo       = av - 3*rms;
+      est.hi       = av + 3*rms;
+
+      return true;
     }
+
+    /// gaussian fit of each non-empty pedestal histogram
+    class PedFitter : public ChannelFitter {
+    public:
+      PedFitter(PedHists &pedHists,
+                CalPed &calPed,
+                const bool fastFit) :
+        m_calPed(calPed),
+        m_gaus(*(TF1*)gROOT->GetFunction("gaus")),
+        m_fastFit(fastFit),
+        m_nMinuitFits(0)
+      {
+        for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
+          TH1S *const hist = pedHists.getHist(rngIdx);
+          // skip empty & non existant histograms
+          if (hist == 0 || hist->GetEntries() == 0)
+            continue;
+
+          m_rngIdx.push_back(rngIdx);
+          m_hists.push_back(hist);
+        }
+      }
+
+      unsigned nChannels() const {
+        return m_hists.size();
+      }
+
+      /// # of channels fit w/ Minuit (all channels unless fastFit)
+      unsigned nMinuitFits() const {
+        return m_nMinuitFits;
+      }
+
+      /// results: trimmed mean, Minuit flag, packed gaussian function
+      bool fitChannel(const unsigned channel,
+                      vector<double> &results) {
+        TH1S &h = *m_hists[channel];
+
+        GausEstimate est;
+        if (m_fastFit && estimateGaus(h, est)) {
+          results.push_back(est.trimMean);
+          results.push_back(0);
+
+          // same layout as ChannelFitExecutor::packFitFunc()
+          results.push_back(3);
+          results.push_back(est.norm);
+          results.push_back(est.mean);
+          results.push_back(est.sigma);
+          results.push_back(est.norm/sqrt(est.nEntries));
+          results.push_back(est.sigma/sqrt(est.nEntries));
+          results.push_back(est.sigma/sqrt(2*est.nEntries));
+          results.push_back(0);  // chi2
+          results.push_back(0);  // ndf
+          results.push_back(est.lo);
+          results.push_back(est.hi);
+          return true;
+        }
+
+        // trim outliers
+        float av = h.GetMean(); float err = h.GetRMS();
+        for ( unsigned short iter = 0; iter < 3; iter++ ) {
+          h.SetAxisRange(av-3*err, av+3*err);
+          av = h.GetMean(); err = h.GetRMS();
+        }
+
+        // gaussian fit
+        h.Fit("gaus", "Q", "", av-3*err, av+3*err );
+
+        results.push_back(av);
+        results.push_back(1);
+        ChannelFitExecutor::packFitFunc((TF1&)*h.GetFunction("gaus"), results);
+        return true;
+      }
+
+      void storeResults(const unsigned channel,
+                        const vector<double> &results) {
+        TH1S &h = *m_hists[channel];
+        const float av = results[0];
+        h.SetAxisRange(av-150, av+150);
+
+        if (results[1] != 0)
+          m_nMinuitFits++;
+
+        ChannelFitExecutor::attachFitFunc(h, m_gaus, results, 2);
+
+        // assign values to permanent arrays
+        const TF1 &gaus = (TF1&)*h.GetFunction("gaus");
+        m_calPed.setPed(m_rngIdx[channel], gaus.GetParameter(1));
+        m_calPed.setPedSig(m_rngIdx[channel], gaus.GetParameter(2));
+      }
+
+    private:
+      CalPed &m_calPed;
+
+      /// prototype for histogram fit function
+      const TF1 &m_gaus;
+
+      /// try closed form estimate before Minuit
+      const bool m_fastFit;
+
+      unsigned m_nMinuitFits;
+
+      vector<RngIdx> m_rngIdx;
+      vector<TH1S *> m_hists;
+    };
+  }
+
+  void PedHists::fitHists(CalPed &calPed,
+                          const unsigned nWorkers,
+                          const bool fastFit) {
+    PedFitter fitter(*this, calPed, fastFit);
+    ChannelFitExecutor(nWorkers).run(fitter, fitter.nChannels());
+
+    if (fastFit)
+      LogStrm::get() << "PedHists: " << fitter.nMinuitFits() << " of "
+                     << fitter.nChannels() << " channels failed closed form"
+                     << " estimate & were fit w/ Minuit" << endl;
   }
 
 }; // namespace calibGenCAL
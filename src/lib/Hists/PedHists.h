@@ -45,7 +45,12 @@ namespace calibGenCAL {
     {}
 
     /// Fit histograms & save results to pedestal collection object
-    void     fitHists(CalUtil::CalPed &peds);
+    /// \param nWorkers fit channels in n parallel worker processes (see ChannelFitExecutor)
+    /// \param fastFit use closed form gaussian estimate from clipped
+    /// moments where it passes quality check, Minuit fit otherwise.
+    void     fitHists(CalUtil::CalPed &peds,
+                      const unsigned nWorkers = 1,
+                      const bool fastFit = false);
 
   };
   
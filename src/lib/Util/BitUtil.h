@@ -0,0 +1,56 @@
+#ifndef BitUtil_h
+#define BitUtil_h
+
+// $Header: $
+
+/** @file
+    @brief 64 bit occupancy mask helpers
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+#include "Rtypes.h"
+
+// STD INCLUDES
+
+namespace calibGenCAL {
+
+  /// single bit mask
+  inline ULong64_t bitMask(const unsigned bit) {
+    return ULong64_t(1) << bit;
+  }
+
+  /// # of set bits in mask
+  inline unsigned popCount(ULong64_t mask) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(mask);
+#else
+    unsigned n = 0;
+    for (; mask != 0; mask &= mask - 1)
+      n++;
+    return n;
+#endif
+  }
+
+  /// index of lowest set bit in mask
+  /// \return noneVal if mask is empty
+  inline unsigned lowestBit(ULong64_t mask,
+                            const unsigned noneVal) {
+    if (mask == 0)
+      return noneVal;
+#if defined(__GNUC__)
+    return __builtin_ctzll(mask);
+#else
+    unsigned n = 0;
+    for (; (mask & 1) == 0; mask >>= 1)
+      n++;
+    return n;
+#endif
+  }
+
+}; // namespace calibGenCAL
+
+#endif
@@ -86,5 +86,11 @@ namespace calibGenCAL {
     _logStrm.getostreams().push_back(&ostrm);
   }
 
+  void LogStrm::flush() {
+    multiplexor_streambuf::streamvector &strms = _logStrm.getostreams();
+    for (unsigned i = 0; i < strms.size(); i++)
+      strms[i]->flush();
+  }
+
 
 }; // namespace calibGenCAL
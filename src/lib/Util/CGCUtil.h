@@ -33,6 +33,8 @@ namespace calibGenCAL {
   public:
     static std::ostream & get();
     static void           addStream(std::ostream &strm);
+    /// flush all registered streams
+    static void           flush();
   };
                      
   /// Output string w/ username, hostname, time, relevant CMT package versions
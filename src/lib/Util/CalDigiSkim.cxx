@@ -0,0 +1,295 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "CalDigiSkim.h"
+
+// GLAST INCLUDES
+#include "digiRootData/DigiEvent.h"
+#include "CalUtil/CalDefs.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <stdexcept>
+#include <cstring>
+
+namespace calibGenCAL {
+
+  using namespace std;
+  using namespace CalUtil;
+
+  namespace {
+    const char SKIM_MAGIC[8] = {'C','G','C','S','K','I','M','\0'};
+    const uint32_t SKIM_BYTE_ORDER = 0x01020304;
+    /// 2: 32 bit xtalId column, EVT_CALDIGI flag, EVT_VALID only set for readable events
+    const uint32_t SKIM_VERSION = 2;
+
+    /// all columns padded to this many bytes
+    const uint64_t COL_ALIGN = 8;
+
+    /// round up to multiple of COL_ALIGN
+    uint64_t padded(const uint64_t nBytes) {
+      return (nBytes + COL_ALIGN - 1)/COL_ALIGN*COL_ALIGN;
+    }
+
+    /// write column contents followed by zero padding
+    template <typename T>
+    void writeColumn(ostream &strm,
+                     const vector<T> &col) {
+      const uint64_t nBytes = col.size()*sizeof(T);
+      if (nBytes)
+        strm.write(reinterpret_cast<const char*>(&col[0]), nBytes);
+
+      static const char zeros[COL_ALIGN] = {0};
+      strm.write(zeros, padded(nBytes) - nBytes);
+    }
+
+    /// point column at current position in block image & advance position
+    /// \return false if image is too short
+    template <typename T>
+    bool takeColumn(const char *&pos,
+                    const char *const end,
+                    const uint64_t nVals,
+                    const T *&col) {
+      const uint64_t nBytes = padded(nVals*sizeof(T));
+      if (pos + nBytes > end)
+        return false;
+
+      col = reinterpret_cast<const T*>(pos);
+      pos += nBytes;
+      return true;
+    }
+
+    /// size of block image w/ given dimensions
+    uint64_t blockBytes(const uint64_t nEvents,
+                        const uint64_t nHits) {
+      const uint64_t nRO = nHits*CalSkimBlock::READOUTS_PER_HIT;
+      return padded(sizeof(CalSkimBlockHeader)) +
+        4*padded(nEvents*sizeof(uint32_t)) +
+        padded(nEvents*sizeof(uint8_t)) +
+        padded(nHits*sizeof(uint32_t)) +
+        padded(nHits*sizeof(uint8_t)) +
+        padded(nRO*sizeof(uint8_t)) +
+        padded(nRO*sizeof(uint16_t));
+    }
+  }
+
+  void checkCalSkimHeader(const CalSkimFileHeader &header,
+                          const string &path) {
+    if (memcmp(header.magic, SKIM_MAGIC, sizeof(SKIM_MAGIC)) != 0)
+      throw runtime_error("Not a Cal skim file: " + path);
+    if (header.byteOrder != SKIM_BYTE_ORDER)
+      throw runtime_error("Cal skim file has wrong byte order: " + path);
+    if (header.version != SKIM_VERSION)
+      throw runtime_error("Unsupported Cal skim file version: " + path);
+  }
+
+  bool mapCalSkimBlock(const char *image,
+                       const uint64_t imageSize,
+                       CalSkimBlock &block) {
+    if (imageSize < sizeof(CalSkimBlockHeader))
+      return false;
+
+    CalSkimBlockHeader header;
+    memcpy(&header, image, sizeof(header));
+    if (header.nBytes > imageSize ||
+        header.nBytes != blockBytes(header.nEvents, header.nHits))
+      return false;
+
+    const char *pos = image + padded(sizeof(CalSkimBlockHeader));
+    const char *const end = image + header.nBytes;
+    const uint64_t nRO = uint64_t(header.nHits)*CalSkimBlock::READOUTS_PER_HIT;
+
+    block.nEvents = header.nEvents;
+    block.nHits   = header.nHits;
+    return takeColumn(pos, end, header.nEvents, block.eventNum) &&
+      takeColumn(pos, end, header.nEvents, block.gemConditionsWord) &&
+      takeColumn(pos, end, header.nEvents, block.gemDeltaEventTime) &&
+      takeColumn(pos, end, header.nEvents, block.hitEnd) &&
+      takeColumn(pos, end, header.nEvents, block.flags) &&
+      takeColumn(pos, end, header.nHits, block.xtalId) &&
+      takeColumn(pos, end, header.nHits, block.nReadouts) &&
+      takeColumn(pos, end, nRO, block.range) &&
+      takeColumn(pos, end, nRO, block.adc);
+  }
+
+  CalDigiSkimWriter::CalDigiSkimWriter(const string &path,
+                                       const unsigned eventsPerBlock) :
+    m_file(path.c_str(), ios::out | ios::binary | ios::trunc),
+    m_eventsPerBlock(max(1U, eventsPerBlock)),
+    m_nEvents(0)
+  {
+    if (!m_file.is_open())
+      throw runtime_error("Unable to open Cal skim file for writing: " + path);
+
+    // header is rewritten w/ final event count on close
+    CalSkimFileHeader header;
+    memset(&header, 0, sizeof(header));
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+
+  CalDigiSkimWriter::~CalDigiSkimWriter() {
+    if (m_file.is_open())
+      try {
+        close();
+      } catch (...) {
+      }
+  }
+
+  void CalDigiSkimWriter::addEvent(const unsigned eventNum,
+                                   const DigiEvent *digiEvent) {
+    const TClonesArray *const calDigiCol = (digiEvent) ? digiEvent->getCalDigiCol() : 0;
+
+    uint8_t flags = 0;
+    uint32_t gemConditionsWord = 0;
+    uint32_t gemDeltaEventTime = 0;
+
+    if (digiEvent) {
+      flags |= CalSkimBlock::EVT_VALID;
+
+      const Gem &gem = digiEvent->getGem();
+      gemConditionsWord = gem.getConditionSummary();
+      gemDeltaEventTime = gem.getDeltaEventTime();
+
+      const EventSummaryData &summary = digiEvent->getEventSummaryData();
+      if (&summary != 0) {
+        flags |= CalSkimBlock::EVT_SUMMARY;
+        if (const_cast<EventSummaryData&>(summary).readout4())
+          flags |= CalSkimBlock::EVT_4RANGE;
+      }
+
+      if (calDigiCol)
+        flags |= CalSkimBlock::EVT_CALDIGI;
+    }
+
+    if (calDigiCol) {
+      TIter calDigiIter(calDigiCol);
+      const CalDigi *pCalDigi = 0;
+      while ((pCalDigi = dynamic_cast<CalDigi *>(calDigiIter.Next()))) {
+        const CalDigi &calDigi = *pCalDigi;
+        const unsigned nRO = min<unsigned>(calDigi.getNumReadouts(),
+                                           CalSkimBlock::MAX_READOUTS);
+
+        m_xtalId.push_back(calDigi.getPackedId());
+        m_nReadouts.push_back(min<unsigned>(calDigi.getNumReadouts(), 0xff));
+
+        for (unsigned n = 0; n < CalSkimBlock::MAX_READOUTS; n++)
+          for (FaceNum face; face.isValid(); face++) {
+            if (n < nRO) {
+              const CalXtalReadout &readout = *calDigi.getXtalReadout(n);
+              m_range.push_back(readout.getRange((CalXtalId::XtalFace)face.val()));
+              m_adc.push_back(readout.getAdc((CalXtalId::XtalFace)face.val()));
+            } else {
+              m_range.push_back(0);
+              m_adc.push_back(0);
+            }
+          }
+      }
+    }
+
+    m_eventNum.push_back(eventNum);
+    m_gemConditionsWord.push_back(gemConditionsWord);
+    m_gemDeltaEventTime.push_back(gemDeltaEventTime);
+    m_flags.push_back(flags);
+    m_hitEnd.push_back(m_xtalId.size());
+
+    m_nEvents++;
+
+    if (m_eventNum.size() >= m_eventsPerBlock)
+      writeBlock();
+  }
+
+  void CalDigiSkimWriter::writeBlock() {
+    if (m_eventNum.empty())
+      return;
+
+    CalSkimBlockHeader header;
+    memset(&header, 0, sizeof(header));
+    header.nEvents = m_eventNum.size();
+    header.nHits   = m_xtalId.size();
+    header.nBytes  = blockBytes(header.nEvents, header.nHits);
+
+    vector<CalSkimBlockHeader> headerCol(1, header);
+    writeColumn(m_file, headerCol);
+    writeColumn(m_file, m_eventNum);
+    writeColumn(m_file, m_gemConditionsWord);
+    writeColumn(m_file, m_gemDeltaEventTime);
+    writeColumn(m_file, m_hitEnd);
+    writeColumn(m_file, m_flags);
+    writeColumn(m_file, m_xtalId);
+    writeColumn(m_file, m_nReadouts);
+    writeColumn(m_file, m_range);
+    writeColumn(m_file, m_adc);
+
+    if (!m_file.good())
+      throw runtime_error("Error writing Cal skim file");
+
+    m_eventNum.clear();
+    m_gemConditionsWord.clear();
+    m_gemDeltaEventTime.clear();
+    m_hitEnd.clear();
+    m_flags.clear();
+    m_xtalId.clear();
+    m_nReadouts.clear();
+    m_range.clear();
+    m_adc.clear();
+  }
+
+  void CalDigiSkimWriter::close() {
+    if (!m_file.is_open())
+      return;
+
+    writeBlock();
+
+    CalSkimFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SKIM_MAGIC, sizeof(SKIM_MAGIC));
+    header.byteOrder = SKIM_BYTE_ORDER;
+    header.version   = SKIM_VERSION;
+    header.nEvents   = m_nEvents;
+
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.close();
+  }
+
+  CalDigiSkimReader::CalDigiSkimReader(const string &path) :
+    m_file(path.c_str(), ios::in | ios::binary)
+  {
+    if (!m_file.is_open())
+      throw runtime_error("Unable to open Cal skim file: " + path);
+
+    m_file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header));
+    if (!m_file.good())
+      throw runtime_error("Unable to read Cal skim file header: " + path);
+
+    checkCalSkimHeader(m_header, path);
+  }
+
+  bool CalDigiSkimReader::nextBlock() {
+    CalSkimBlockHeader header;
+    m_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (m_file.gcount() == 0 && m_file.eof())
+      return false;
+    if (!m_file.good() || header.nBytes < sizeof(header))
+      throw runtime_error("Truncated Cal skim file");
+
+    // keep 8 byte alignment of columns w/in buffer
+    m_buf.resize(header.nBytes + COL_ALIGN);
+    char *const image = &m_buf[0] + (COL_ALIGN - (reinterpret_cast<size_t>(&m_buf[0]) % COL_ALIGN)) % COL_ALIGN;
+
+    memcpy(image, &header, sizeof(header));
+    m_file.read(image + sizeof(header), header.nBytes - sizeof(header));
+    if (!m_file.good())
+      throw runtime_error("Truncated Cal skim file");
+
+    if (!mapCalSkimBlock(image, header.nBytes, m_block))
+      throw runtime_error("Corrupt Cal skim file block");
+
+    return true;
+  }
+
+}; // namespace calibGenCAL
@@ -0,0 +1,216 @@
+#ifndef CalDigiSkim_h
+#define CalDigiSkim_h
+
+// $Header: $
+
+/** @file
+    @brief compact columnar file format for Cal readouts skimmed from digi ROOT files.
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+#include "CalUtil/CalDefs.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+class DigiEvent;
+
+namespace calibGenCAL {
+
+  /** \brief one block of skimmed events stored as flat columns
+
+  file layout:
+  - CalSkimFileHeader
+  - sequence of blocks, each one:
+    - CalSkimBlockHeader
+    - event columns (nEvents entries each): eventNum, gemConditionsWord,
+    gemDeltaEventTime, hitEnd, flags
+    - hit columns (nHits entries each): xtalId, nReadouts
+    - readout columns (nHits*MAX_READOUTS*FaceNum::N_VALS entries each): range, adc
+
+  each column is padded to a multiple of 8 bytes, so all columns are
+  naturally aligned (file may be mmap()-ed directly).
+
+  hits for event i are [hitEnd[i-1], hitEnd[i]) (hitEnd[-1] == 0).
+  readout n, face f of hit h is at index (h*MAX_READOUTS + n)*FaceNum::N_VALS + f
+  */
+  class CalSkimBlock {
+  public:
+    CalSkimBlock() :
+      nEvents(0),
+      nHits(0),
+      eventNum(0),
+      gemConditionsWord(0),
+      gemDeltaEventTime(0),
+      hitEnd(0),
+      flags(0),
+      xtalId(0),
+      nReadouts(0),
+      range(0),
+      adc(0)
+    {}
+
+    /// max readouts stored per hit
+    static const unsigned MAX_READOUTS = 4;
+
+    /// # of (range, adc) pairs stored per hit
+    static const unsigned READOUTS_PER_HIT = MAX_READOUTS*CalUtil::FaceNum::N_VALS;
+
+    /// event flag bits
+    enum {
+      /// digi event read successfully
+      EVT_VALID    = 1,
+      /// EventSummaryData::readout4() set
+      EVT_4RANGE   = 2,
+      /// EventSummaryData present
+      EVT_SUMMARY  = 4,
+      /// Cal digi collection present
+      EVT_CALDIGI  = 8
+    };
+
+    /// index of 1st hit for given event
+    uint32_t hitBegin(const unsigned evt) const {
+      return (evt == 0) ? 0 : hitEnd[evt-1];
+    }
+
+    /// index into range/adc columns
+    static unsigned roIdx(const unsigned hit,
+                          const unsigned readout,
+                          const CalUtil::FaceNum face) {
+      return (hit*MAX_READOUTS + readout)*CalUtil::FaceNum::N_VALS + face.val();
+    }
+
+    uint32_t nEvents;
+    uint32_t nHits;
+
+    /// original chain entry #
+    const uint32_t *eventNum;
+    const uint32_t *gemConditionsWord;
+    /// raw gem delta event time (50ns ticks)
+    const uint32_t *gemDeltaEventTime;
+    /// cumulative hit count after each event
+    const uint32_t *hitEnd;
+    const uint8_t  *flags;
+
+    /// packed idents::CalXtalId
+    const uint32_t *xtalId;
+    /// # of readouts in original digi (only 1st MAX_READOUTS are stored)
+    const uint8_t  *nReadouts;
+    const uint8_t  *range;
+    const uint16_t *adc;
+  };
+
+  /// leading bytes of every skim file
+  struct CalSkimFileHeader {
+    char     magic[8];
+    /// detect mismatched byte order
+    uint32_t byteOrder;
+    uint32_t version;
+    /// total events in file (filled in on close)
+    uint64_t nEvents;
+  };
+
+  /// leading bytes of each block
+  struct CalSkimBlockHeader {
+    uint32_t nEvents;
+    uint32_t nHits;
+    /// total size of block (including this header) in bytes
+    uint64_t nBytes;
+  };
+
+  /// write events to Cal skim file
+  class CalDigiSkimWriter {
+  public:
+    /// \param eventsPerBlock # of events buffered before each block is written
+    explicit CalDigiSkimWriter(const std::string &path,
+                               const unsigned eventsPerBlock = 4096);
+
+    /// close file if still open
+    ~CalDigiSkimWriter();
+
+    /// append single digi event
+    /// \param digiEvent NULL if event could not be read (still recorded, to keep event sequence)
+    void addEvent(const unsigned eventNum,
+                  const DigiEvent *digiEvent);
+
+    /// flush last block & finalize header
+    void close();
+
+    /// # of events written so far
+    uint64_t getNEvents() const {
+      return m_nEvents;
+    }
+
+  private:
+    /// write buffered events as single block
+    void writeBlock();
+
+    std::ofstream m_file;
+
+    const unsigned m_eventsPerBlock;
+
+    uint64_t m_nEvents;
+
+    /// column buffers
+    std::vector<uint32_t> m_eventNum;
+    std::vector<uint32_t> m_gemConditionsWord;
+    std::vector<uint32_t> m_gemDeltaEventTime;
+    std::vector<uint32_t> m_hitEnd;
+    std::vector<uint8_t>  m_flags;
+    std::vector<uint32_t> m_xtalId;
+    std::vector<uint8_t>  m_nReadouts;
+    std::vector<uint8_t>  m_range;
+    std::vector<uint16_t> m_adc;
+  };
+
+  /// read Cal skim file one block at a time
+  class CalDigiSkimReader {
+  public:
+    explicit CalDigiSkimReader(const std::string &path);
+
+    /// total # of events in file
+    uint64_t getNEvents() const {
+      return m_header.nEvents;
+    }
+
+    /// load next block
+    /// \return false at end of file
+    bool nextBlock();
+
+    /// current block, valid until next call to nextBlock()
+    const CalSkimBlock &getBlock() const {
+      return m_block;
+    }
+
+  private:
+    std::ifstream m_file;
+
+    CalSkimFileHeader m_header;
+
+    /// backing store for current block
+    std::vector<char> m_buf;
+
+    CalSkimBlock m_block;
+  };
+
+  /// point block columns into contiguous block image (header + columns)
+  /// \return false if image is truncated
+  bool mapCalSkimBlock(const char *image,
+                       const uint64_t imageSize,
+                       CalSkimBlock &block);
+
+  /// check magic, byte order & version of skim file header
+  /// \throws std::runtime_error on mismatch
+  void checkCalSkimHeader(const CalSkimFileHeader &header,
+                          const std::string &path);
+
+}; // namespace calibGenCAL
+
+#endif
@@ -7,6 +7,8 @@
 // LOCAL INCLUDES
 #include "CalHodoscope.h"
 #include "../Util/stl_util.h"
+#include "BitUtil.h"
+#include "src/lib/CalibDataTypes/CIDAC2ADCTable.h"
 
 // GLAST INCLUDES
 #include "digiRootData/CalDigi.h"
@@ -16,27 +18,49 @@
 // EXTLIB INCLUDES
 
 // STD INCLUDES
-#include <functional>
+#include <algorithm>
 #include <ostream>
 
 namespace calibGenCAL {
 
   using namespace CalUtil;
 
-  void CalHodoscope::clear() {
-    // zero out all vectors
+  void CalHodoscope::clearAll() {
     fill(adc_ped.begin(), adc_ped.end(), CIDAC2ADC::INVALID_ADC());
     fill(dac.begin(), dac.end(), CIDAC2ADC::INVALID_ADC());
-    fill_zero(perLyr);
     fill(bestRng.begin(), bestRng.end(), LEX8);
+    m_dirtyXtals.clear();
+
+    clear();
+  }
 
-    // empty hit lists
-    hitList.clear();
+  void CalHodoscope::clear() {
+    // reset diode & face values only for xtals touched since last clear()
+    for (unsigned i = 0; i < m_dirtyXtals.size(); i++) {
+      const XtalIdx &xtalIdx = m_dirtyXtals[i];
+      for (XtalDiode xDiode; xDiode.isValid(); xDiode++) {
+        const DiodeIdx diodeIdx(xtalIdx, xDiode);
+        adc_ped[diodeIdx] = CIDAC2ADC::INVALID_ADC();
+        dac[diodeIdx]     = CIDAC2ADC::INVALID_ADC();
+      }
+      for (FaceNum face; face.isValid(); face++)
+        bestRng[FaceIdx(xtalIdx, face)] = LEX8;
+    }
+    m_dirtyXtals.clear();
+
+    // layer histogram & hit list are only filled by xtals which pass hit cut
+    if (count) {
+      fill_zero(perLyr);
+
+      // empty hit lists
+      hitList.clear();
+    }
 
     // zero out primitives
     count      = 0;
     nLyrs      = 0;
     maxPerLyr  = 0;
+    lyrMask    = 0;
   }
 
   void CalHodoscope::addHit(const CalDigi &calDigi) {
@@ -48,6 +72,9 @@ namespace calibGenCAL {
 
     XtalIdx xtalIdx(id);
 
+    // any diode value below may be set, even if hit is rejected
+    m_dirtyXtals.push_back(xtalIdx);
+
     // load up all adc values for each xtal diode
     // also ped subtraced adc values.
     for (XtalDiode xDiode; xDiode.isValid(); xDiode++) {
@@ -98,7 +125,9 @@ namespace calibGenCAL {
 
     count++;  // increment total # hits
 
-    perLyr[lyr]++;
+    maxPerLyr = max<unsigned short>(maxPerLyr, ++perLyr[lyr]);
+    lyrMask  |= bitMask(lyr.val());
+    nLyrs     = popCount(lyrMask);
     hitList.push_back(xtalIdx);
   }
 
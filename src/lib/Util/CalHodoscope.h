@@ -14,6 +14,7 @@
 #include "CalUtil/CalVec.h"
 
 // EXTLIB INCLUDES
+#include "Rtypes.h"
 
 // STD INCLUDES
 #include <vector>
@@ -22,12 +23,12 @@ class CalDigi;
 
 namespace CalUtil {
   class CalPed;
-  class CIDAC2ADC;
-
 }
 
 namespace calibGenCAL {
 
+  class CIDAC2ADCTable;
+
 
   /** \brief Accumulate crystal hits in Cal summarize into
       information which can be used for track determination.
@@ -36,14 +37,17 @@ namespace calibGenCAL {
   class CalHodoscope {
   public:
 	  CalHodoscope(const CalUtil::CalPed &ped,
-                 const CalUtil::CIDAC2ADC &cidac2adc) :
+                 const CIDAC2ADCTable &cidac2adc) :
+      count(0),
       m_peds(ped),
       m_cidac2adc(cidac2adc)
     {
-      clear();
+      m_dirtyXtals.reserve(CalUtil::XtalIdx::N_VALS);
+      clearAll();
     }
 
     /// 'zero-out' all members
+    /// \note only visits xtals passed to addHit() since last clear()
     void clear();
 
     /// add new xtal hit to event summary data
@@ -76,15 +80,24 @@ namespace calibGenCAL {
     unsigned short nLyrs;
     /// max # of hits in any layer
     unsigned short maxPerLyr;
+    /// hit layers (bit n set if perLyr[n] > 0)
+    ULong64_t lyrMask;
 
     /// reference to pedestal calibrations needed for some operations
     const CalUtil::CalPed &m_peds;
 
-    /// reference to cidac2adc calibs needed for some ops
-    const CalUtil::CIDAC2ADC &m_cidac2adc;
+    /// reference to (tabulated) cidac2adc calibs needed for some ops
+    const CIDAC2ADCTable &m_cidac2adc;
 
     /// threshold (LEX8 ADCP + ADCN) for couniting a 'hit' xtal
     static const unsigned short hitThresh = 100;
+
+  private:
+    /// reset every channel, regardless of hit history
+    void clearAll();
+
+    /// xtals w/ possibly valid adc_ped / dac / bestRng values
+    std::vector<CalUtil::XtalIdx> m_dirtyXtals;
   };
 
 }; // namespace calibGenCAL
@@ -7,6 +7,7 @@
 // LOCAL INCLUDES
 #include "CalSignalArray.h"
 #include "src/lib/Util/CGCUtil.h"
+#include "src/lib/Util/stl_util.h"
 
 // GLAST INCLUDES
 #include "digiRootData/CalDigi.h"
@@ -17,11 +18,55 @@
 // EXTLIB INCLUDES
 
 // STD INCLUDES
+#include <algorithm>
 
 namespace calibGenCAL {
 
   using namespace CalUtil;
 
+  CalSignalArray::CalSignalArray(const CalPed &ped,
+                                 const ADC2NRG &adc2nrg) :
+    m_calibTable(2*RngIdx::N_VALS)
+  {
+    // pack calibrations into flat table
+    for (RngIdx rngIdx; rngIdx.isValid(); rngIdx++) {
+      m_calibTable[2*rngIdx.val()]     = ped.getPed(rngIdx);
+      m_calibTable[2*rngIdx.val() + 1] = adc2nrg.getADC2NRG(rngIdx);
+    }
+
+    m_hitFace.reserve(FaceIdx::N_VALS);
+    m_hitRng.reserve(FaceIdx::N_VALS);
+    m_hitAdc.reserve(FaceIdx::N_VALS);
+    m_hitPed.reserve(FaceIdx::N_VALS);
+    m_hitGain.reserve(FaceIdx::N_VALS);
+    m_hitAdcPed.reserve(FaceIdx::N_VALS);
+    m_hitSignal.reserve(FaceIdx::N_VALS);
+
+    // full initialization, later clear() calls only reset hit faces
+    fill_zero(m_faceSignal);
+    fill_zero(m_adcPed);
+    fill(m_adcRng.begin(),
+         m_adcRng.end(),
+         LEX8);
+  }
+
+  void CalSignalArray::clear() {
+    for (unsigned i = 0; i < m_hitFace.size(); i++) {
+      const FaceIdx faceIdx(m_hitFace[i]);
+      m_faceSignal[faceIdx] = 0;
+      m_adcPed[faceIdx]     = 0;
+      m_adcRng[faceIdx]     = LEX8;
+    }
+
+    m_hitFace.clear();
+    m_hitRng.clear();
+    m_hitAdc.clear();
+    m_hitPed.clear();
+    m_hitGain.clear();
+    m_hitAdcPed.clear();
+    m_hitSignal.clear();
+  }
+
   void CalSignalArray::addHit(const CalDigi &calDigi) {
     // get interaction information
     const idents::CalXtalId id(calDigi.getPackedId());
@@ -31,21 +76,43 @@ namespace calibGenCAL {
       /// get best range
       const RngNum rng(calDigi.getRange(0, (CalXtalId::XtalFace)face.val()));
       const unsigned short adc(calDigi.getAdc(0, (CalXtalId::XtalFace)face.val()));
-      const RngIdx  rngIdx(xtalIdx, face, rng);
 
-      const float ped(m_peds.getPed(rngIdx));
-      const float adcPed = (float)adc - ped;
-      
-      const float adc2nrg(m_adc2nrg.getADC2NRG(rngIdx));
-      
-      /// mev = adc*(mev/adc)
-      const FaceIdx faceIdx(xtalIdx, face);
-      m_faceSignal[faceIdx] = adcPed*adc2nrg;
-      m_adcPed[faceIdx] = adcPed;
-      m_adcRng[faceIdx] = rng;
+      // gather calibration constants here, so calibrateHits() runs
+      // on contiguous arrays only
+      const float *const calib = &m_calibTable[2*RngIdx(xtalIdx, face, rng).val()];
+
+      m_hitFace.push_back(FaceIdx(xtalIdx, face));
+      m_hitRng.push_back(rng);
+      m_hitAdc.push_back(adc);
+      m_hitPed.push_back(calib[0]);
+      m_hitGain.push_back(calib[1]);
     } // for (face)
   }
 
+  void CalSignalArray::calibrateHits(const unsigned firstHit) {
+    const unsigned nHits = m_hitAdc.size() - firstHit;
+    m_hitAdcPed.resize(m_hitAdc.size());
+    m_hitSignal.resize(m_hitAdc.size());
+    if (nHits == 0)
+      return;
+
+    // unit stride loads & stores only: compiler vectorizes this
+    // loop (w/ runtime overlap check, as pointers come from
+    // separate vectors).
+    const float *const adc  = &m_hitAdc[firstHit];
+    const float *const ped  = &m_hitPed[firstHit];
+    const float *const gain = &m_hitGain[firstHit];
+    float *const adcPed     = &m_hitAdcPed[firstHit];
+    float *const signal     = &m_hitSignal[firstHit];
+
+    for (unsigned i = 0; i < nHits; i++) {
+      const float tmpAdcPed = adc[i] - ped[i];
+      adcPed[i] = tmpAdcPed;
+      /// mev = adc*(mev/adc)
+      signal[i] = tmpAdcPed*gain[i];
+    }
+  }
+
   void CalSignalArray::fillArray(const DigiEvent &digiEvent) {
     //-- loop through each 'hit' in one event --//
     const TClonesArray *calDigiCol = digiEvent.getCalDigiCol();
@@ -58,12 +125,24 @@ namespace calibGenCAL {
 
     const CalDigi      *pCalDigi = 0;
 
+    // faces already filled since last clear() are left as they are
+    const unsigned firstHit = m_hitFace.size();
+
     while ((pCalDigi = dynamic_cast<CalDigi *>(calDigiIter.Next()))) {
       const     CalDigi &calDigi = *pCalDigi;    // use reference to avoid -> syntax
 
       addHit(calDigi);
     }
 
+    calibrateHits(firstHit);
+
+    // scatter calibrated values into per face arrays
+    for (unsigned i = firstHit; i < m_hitFace.size(); i++) {
+      const FaceIdx faceIdx(m_hitFace[i]);
+      m_faceSignal[faceIdx] = m_hitSignal[i];
+      m_adcPed[faceIdx]     = m_hitAdcPed[i];
+      m_adcRng[faceIdx]     = m_hitRng[i];
+    }
   }
 
 }; // namespace calibGenCAL
@@ -16,6 +16,7 @@
 // EXTLIB INCLUDES
 
 // STD INCLUDES
+#include <vector>
 
 class DigiEvent;
 class CalDigi;
@@ -30,30 +31,25 @@ namespace calibGenCAL {
 
   /** \brief Build array of Cal signal responses for each channel in cal
 
+  fillArray() first gathers adc, pedestal & gain for every readout
+  face in event into contiguous structure-of-arrays buffers (only
+  step w/ table lookups), then applies pedestal & gain in single
+  branch & gather free pass over buffers, which compiler can
+  auto-vectorize, & finally scatters results into per-face arrays.
+  clear() only resets faces filled since previous clear().
+
+  \note pedestal & adc2nrg calibrations are copied at construction, so
+  they must be fully loaded beforehand.
+
   @author fewtrell
   */
   class CalSignalArray {
   public:
     CalSignalArray(const CalUtil::CalPed &ped,
-                   const CalUtil::ADC2NRG &adc2nrg) :
-      m_peds(ped),
-      m_adc2nrg(adc2nrg)
-    {
-      clear();
-    }
+                   const CalUtil::ADC2NRG &adc2nrg);
     
     /// 'zero-out' all members
-    void clear() {
-      fill(m_faceSignal.begin(),
-           m_faceSignal.end(),
-           0);
-      fill(m_adcPed.begin(),
-           m_adcPed.end(),
-           0);
-      fill(m_adcRng.begin(),
-           m_adcRng.end(),
-           CalUtil::LEX8);
-    }
+    void clear();
 
     /// populate array with data from new event.
     void fillArray(const DigiEvent &digiEvent);
@@ -80,9 +76,14 @@ namespace calibGenCAL {
     
   private:
 
-    /// add new xtal hit to event summary data
+    /// append readout & calibration constants for each face of new
+    /// xtal hit to hit buffers
     void addHit(const CalDigi &calDigi);
 
+    /// apply pedestal & gain to hit buffers starting at firstHit
+    /// (contiguous arrays only, no table lookups)
+    void calibrateHits(const unsigned firstHit);
+
     /// store face signal value for each xtal face
     FaceSignalArray m_faceSignal;
     /// pedestal subtracted adc ranges
@@ -90,8 +91,22 @@ namespace calibGenCAL {
     /// adc rng to go w/ m_adcPed
     CalUtil::CalVec<CalUtil::FaceIdx, CalUtil::RngNum> m_adcRng;
 
-    const CalUtil::CalPed &m_peds;
-    const CalUtil::ADC2NRG &m_adc2nrg;
+    /// (pedestal, mev per adc) pairs, indexed by 2*RngIdx::val(),
+    /// so each gather touches single cache line
+    std::vector<float> m_calibTable;
+
+    // per readout face hit buffers, 1 entry per face filled since
+    // last clear()
+    std::vector<CalUtil::FaceIdx> m_hitFace;
+    std::vector<CalUtil::RngNum>  m_hitRng;
+    /// raw adc
+    std::vector<float>            m_hitAdc;
+    /// pedestal for hit range
+    std::vector<float>            m_hitPed;
+    /// mev per adc for hit range
+    std::vector<float>            m_hitGain;
+    std::vector<float>            m_hitAdcPed;
+    std::vector<float>            m_hitSignal;
   };
 
 }; // namespace calibGenCAL
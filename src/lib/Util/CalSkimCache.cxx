@@ -0,0 +1,249 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "CalSkimCache.h"
+#include "RootFileAnalysis.h"
+#include "CGCUtil.h"
+
+// GLAST INCLUDES
+#include "digiRootData/DigiEvent.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <stdexcept>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace calibGenCAL {
+
+  using namespace std;
+
+  MappedCalSkim::MappedCalSkim(const string &path) :
+    m_path(path),
+    m_image(0),
+    m_size(0),
+    m_pos(sizeof(CalSkimFileHeader))
+  {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw runtime_error("Unable to open Cal skim file: " + path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CalSkimFileHeader)) {
+      close(fd);
+      throw runtime_error("Unable to read Cal skim file header: " + path);
+    }
+    m_size = st.st_size;
+
+    void *const image = mmap(0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // mapping stays valid after descriptor is closed
+    close(fd);
+    if (image == MAP_FAILED)
+      throw runtime_error("Unable to mmap Cal skim file: " + path);
+
+    m_image = static_cast<const char*>(image);
+    madvise(image, m_size, MADV_SEQUENTIAL);
+
+    memcpy(&m_header, m_image, sizeof(m_header));
+    try {
+      checkCalSkimHeader(m_header, path);
+    } catch (...) {
+      munmap(image, m_size);
+      throw;
+    }
+  }
+
+  MappedCalSkim::~MappedCalSkim() {
+    munmap(const_cast<char*>(m_image), m_size);
+  }
+
+  bool MappedCalSkim::nextBlock() {
+    if (m_pos == m_size)
+      return false;
+
+    if (!mapCalSkimBlock(m_image + m_pos, m_size - m_pos, m_block))
+      throw runtime_error("Corrupt Cal skim file: " + m_path);
+
+    CalSkimBlockHeader header;
+    memcpy(&header, m_image + m_pos, sizeof(header));
+    m_pos += header.nBytes;
+
+    return true;
+  }
+
+  void MappedCalSkim::rewind() {
+    m_pos = sizeof(CalSkimFileHeader);
+    m_block = CalSkimBlock();
+  }
+
+  void writeCalSkim(const vector<string> &digiFileList,
+                    const string &outputPath,
+                    const unsigned maxEvents) {
+    RootFileAnalysis rootFile(0,
+                              &digiFileList,
+                              0);
+
+    // ENABLE / REGISTER TUPLE BRANCHES
+    rootFile.getDigiChain()->SetBranchStatus("*", 0);
+    rootFile.getDigiChain()->SetBranchStatus("m_calDigiCloneCol");
+    rootFile.getDigiChain()->SetBranchStatus("m_summary");
+    rootFile.getDigiChain()->SetBranchStatus("m_gem");
+
+    // no ROOT objects are created in event loop
+    rootFile.useDefaultReadAhead();
+
+    LogStrm::get() << __FILE__ << ": Opening output skim file: " << outputPath << endl;
+    CalDigiSkimWriter skim(outputPath);
+
+    // EVENT LOOP
+    const unsigned nEvents = min<unsigned>(rootFile.getEntries(), maxEvents);
+    LogStrm::get() << __FILE__ << ": Skimming: " << nEvents << " events." << endl;
+
+    for (unsigned nEvt = 0;
+         nEvt < nEvents;
+         nEvt++) {
+      // status print out
+      if (nEvt % 10000 == 0)
+        LogStrm::get() << nEvt << endl;
+
+      // read new event (digi ptr is stale after failed read)
+      DigiEvent const*const digiEvent = rootFile.getEvent(nEvt) ?
+        rootFile.getDigiEvent() : 0;
+      if (!digiEvent)
+        LogStrm::get() << __FILE__ << ": Unable to read DigiEvent " << nEvt  << endl;
+
+      // unreadable events are still recorded (as invalid) so that
+      // skim event sequence matches input chain
+      skim.addEvent(nEvt, digiEvent);
+    }
+
+    skim.close();
+  }
+
+  namespace {
+    /// # of bytes sampled from each end of input file for checksum
+    const unsigned CHECKSUM_SAMPLE_BYTES = 1 << 20;
+
+    /// running adler32 checksum
+    uint32_t adler32(uint32_t adler,
+                     const char *buf,
+                     const unsigned len) {
+      static const uint32_t MOD_ADLER = 65521;
+      uint32_t a = adler & 0xffff;
+      uint32_t b = adler >> 16;
+
+      for (unsigned i = 0; i < len; i++) {
+        a = (a + (unsigned char)buf[i]) % MOD_ADLER;
+        b = (b + a) % MOD_ADLER;
+      }
+
+      return (b << 16) | a;
+    }
+
+    /// checksum of 1st & last CHECKSUM_SAMPLE_BYTES of file
+    uint32_t fileChecksum(const string &path,
+                          const uint64_t size) {
+      ifstream infile(path.c_str(), ios::in | ios::binary);
+      if (!infile.is_open())
+        throw runtime_error("Unable to open input file: " + path);
+
+      vector<char> buf(CHECKSUM_SAMPLE_BYTES);
+      uint32_t adler = 1;
+
+      infile.read(&buf[0], buf.size());
+      adler = adler32(adler, &buf[0], infile.gcount());
+
+      if (size > CHECKSUM_SAMPLE_BYTES) {
+        infile.clear();
+        infile.seekg(size - min<uint64_t>(size - CHECKSUM_SAMPLE_BYTES,
+                                          CHECKSUM_SAMPLE_BYTES));
+        infile.read(&buf[0], buf.size());
+        adler = adler32(adler, &buf[0], infile.gcount());
+      }
+
+      return adler;
+    }
+
+    bool fileExists(const string &path) {
+      struct stat st;
+      return stat(path.c_str(), &st) == 0;
+    }
+  }
+
+  string calSkimCachePath(const string &cacheDir,
+                          const vector<string> &digiFileList) {
+    // FNV-1a style combination of per file (dev, inode, size, mtime, checksum)
+    uint64_t key = 14695981039346656037ULL;
+    for (unsigned i = 0; i < digiFileList.size(); i++) {
+      struct stat st;
+      if (stat(digiFileList[i].c_str(), &st) != 0)
+        throw runtime_error("Unable to stat input file: " + digiFileList[i]);
+
+      const uint64_t size = st.st_size;
+      const uint64_t vals[5] = {(uint64_t)st.st_dev,
+                                (uint64_t)st.st_ino,
+                                size,
+                                (uint64_t)st.st_mtime,
+                                fileChecksum(digiFileList[i], size)};
+      for (unsigned n = 0; n < 5; n++) {
+        key ^= vals[n];
+        key *= 1099511628211ULL;
+      }
+    }
+
+    ostringstream path;
+    path << cacheDir << "/calSkim_"
+         << hex << setw(16) << setfill('0') << key
+         << ".skim";
+    return path.str();
+  }
+
+  string getCalSkimCache(const string &cacheDir,
+                         const vector<string> &digiFileList) {
+    const string path(calSkimCachePath(cacheDir, digiFileList));
+
+    if (fileExists(path)) {
+      try {
+        MappedCalSkim skim(path);
+        LogStrm::get() << __FILE__ << ": Using cached Cal skim: " << path
+                       << " (" << skim.getNEvents() << " events)" << endl;
+        return path;
+      } catch (exception &e) {
+        LogStrm::get() << __FILE__ << ": Regenerating invalid Cal skim cache: "
+                       << e.what() << endl;
+      }
+    }
+
+    // write to temporary file & rename when complete, so that an
+    // interrupted job never leaves a partial file in the cache.
+    ostringstream tmpPath;
+    tmpPath << path << ".tmp." << getpid();
+
+    try {
+      writeCalSkim(digiFileList, tmpPath.str());
+    } catch (...) {
+      remove(tmpPath.str().c_str());
+      throw;
+    }
+
+    if (rename(tmpPath.str().c_str(), path.c_str()) != 0) {
+      remove(tmpPath.str().c_str());
+      throw runtime_error("Unable to move Cal skim into cache: " + path);
+    }
+
+    return path;
+  }
+
+}; // namespace calibGenCAL
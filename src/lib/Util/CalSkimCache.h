@@ -0,0 +1,90 @@
+#ifndef CalSkimCache_h
+#define CalSkimCache_h
+
+// $Header: $
+
+/** @file
+    @brief on-disk cache of Cal skim files, keyed by input digi file checksum.
+*/
+
+// LOCAL INCLUDES
+#include "CalDigiSkim.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <string>
+#include <vector>
+
+namespace calibGenCAL {
+
+  /** \brief read-only memory mapped Cal skim file
+
+  same block iteration interface as CalDigiSkimReader, but block columns
+  point directly into the mapped file (no copy).
+  */
+  class MappedCalSkim {
+  public:
+    explicit MappedCalSkim(const std::string &path);
+
+    ~MappedCalSkim();
+
+    /// total # of events in file
+    uint64_t getNEvents() const {
+      return m_header.nEvents;
+    }
+
+    /// load next block
+    /// \return false at end of file
+    bool nextBlock();
+
+    /// current block, valid until object is destroyed
+    const CalSkimBlock &getBlock() const {
+      return m_block;
+    }
+
+    /// restart iteration at first block
+    void rewind();
+
+  private:
+    /// disabled
+    MappedCalSkim(const MappedCalSkim &);
+    MappedCalSkim &operator=(const MappedCalSkim &);
+
+    const std::string m_path;
+
+    const char *m_image;
+
+    uint64_t m_size;
+
+    /// offset of next block in image
+    uint64_t m_pos;
+
+    CalSkimFileHeader m_header;
+
+    CalSkimBlock m_block;
+  };
+
+  /// skim all events from digiFileList into Cal skim file at outputPath
+  void writeCalSkim(const std::vector<std::string> &digiFileList,
+                    const std::string &outputPath,
+                    const unsigned maxEvents = 0xffffffff);
+
+  /// return unique cache file path for given input digi files
+  /// key combines device, inode, size, mtime & adler32 checksum of
+  /// leading and trailing bytes of each file, in list order.
+  /// \note file rewritten in place w/ same size & unchanged ends still
+  /// gets a new key as its mtime changes.
+  std::string calSkimCachePath(const std::string &cacheDir,
+                               const std::vector<std::string> &digiFileList);
+
+  /// return path to cached skim of given digi files, generate skim file
+  /// first if not already in cache.
+  std::string getCalSkimCache(const std::string &cacheDir,
+                              const std::vector<std::string> &digiFileList);
+
+}; // namespace calibGenCAL
+
+#endif
@@ -0,0 +1,225 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "ChannelFitExecutor.h"
+#include "ProcessUtil.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+#include "TF1.h"
+#include "TH1.h"
+#include "TList.h"
+#include "TClass.h"
+
+// STD INCLUDES
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <sstream>
+#include <cstring>
+
+namespace calibGenCAL {
+
+  using namespace std;
+
+  namespace {
+    /// record header written by worker for each fitted channel
+    struct ResultHeader {
+      unsigned channel;
+      unsigned nVals;
+    };
+
+    /// split worker output into per channel results
+    /// \return false if output is truncated or invalid
+    bool decodeResults(const string &buf,
+                       vector<vector<double> > &results,
+                       vector<bool> &fitted) {
+      size_t pos = 0;
+      while (pos < buf.size()) {
+        ResultHeader header;
+        if (buf.size() - pos < sizeof(header))
+          return false;
+        memcpy(&header, buf.data() + pos, sizeof(header));
+        pos += sizeof(header);
+
+        const size_t nBytes = (size_t)header.nVals*sizeof(double);
+        if (header.channel >= results.size() ||
+            buf.size() - pos < nBytes)
+          return false;
+
+        vector<double> &dst = results[header.channel];
+        dst.resize(header.nVals);
+        if (nBytes > 0)
+          memcpy(&dst[0], buf.data() + pos, nBytes);
+        pos += nBytes;
+
+        fitted[header.channel] = true;
+      }
+
+      return true;
+    }
+
+    /// fit every nWorkers'th channel starting w/ 'worker' in worker process
+    class FitTask : public ProcessTask {
+    public:
+      FitTask(ChannelFitter &fitter,
+              const unsigned nChannels,
+              const unsigned nWorkers,
+              const unsigned worker,
+              vector<vector<double> > &results,
+              vector<bool> &fitted) :
+        m_fitter(fitter),
+        m_nChannels(nChannels),
+        m_nWorkers(nWorkers),
+        m_worker(worker),
+        m_results(results),
+        m_fitted(fitted)
+      {}
+
+      void run(string &result) {
+        vector<double> vals;
+        for (unsigned channel = m_worker; channel < m_nChannels; channel += m_nWorkers) {
+          vals.clear();
+          if (!m_fitter.fitChannel(channel, vals))
+            continue;
+
+          ResultHeader header;
+          header.channel = channel;
+          header.nVals   = vals.size();
+          result.append(reinterpret_cast<const char*>(&header), sizeof(header));
+          if (!vals.empty())
+            result.append(reinterpret_cast<const char*>(&vals[0]),
+                          vals.size()*sizeof(double));
+        }
+      }
+
+      void setResult(const string &result) {
+        if (!decodeResults(result, m_results, m_fitted)) {
+          ostringstream msg;
+          msg << "ChannelFitExecutor: invalid output from fit worker " << m_worker;
+          throw runtime_error(msg.str());
+        }
+      }
+
+    private:
+      ChannelFitter &m_fitter;
+      const unsigned m_nChannels;
+      const unsigned m_nWorkers;
+      const unsigned m_worker;
+      vector<vector<double> > &m_results;
+      vector<bool> &m_fitted;
+    };
+  }
+
+  void ChannelFitExecutor::runSerial(ChannelFitter &fitter,
+                                     const unsigned nChannels) const {
+    vector<double> results;
+    for (unsigned channel = 0; channel < nChannels; channel++) {
+      results.clear();
+      if (fitter.fitChannel(channel, results))
+        fitter.storeResults(channel, results);
+    }
+  }
+
+  void ChannelFitExecutor::run(ChannelFitter &fitter,
+                               const unsigned nChannels) const {
+    const unsigned nWorkers = min(m_nWorkers, nChannels);
+    if (nWorkers <= 1) {
+      runSerial(fitter, nChannels);
+      return;
+    }
+
+    vector<vector<double> > results(nChannels);
+    vector<bool> fitted(nChannels, false);
+
+    vector<ProcessTask*> tasks;
+    for (unsigned worker = 0; worker < nWorkers; worker++)
+      tasks.push_back(new FitTask(fitter, nChannels, nWorkers, worker, results, fitted));
+
+    try {
+      runProcessTasks(tasks, nWorkers);
+    } catch (...) {
+      for (unsigned i = 0; i < tasks.size(); i++)
+        delete tasks[i];
+      throw;
+    }
+
+    for (unsigned i = 0; i < tasks.size(); i++)
+      delete tasks[i];
+
+    for (unsigned channel = 0; channel < nChannels; channel++)
+      if (fitted[channel])
+        fitter.storeResults(channel, results[channel]);
+  }
+
+  void ChannelFitExecutor::packFitFunc(const TF1 &func,
+                                       vector<double> &results) {
+    const unsigned nPar = func.GetNpar();
+    results.push_back(nPar);
+    for (unsigned i = 0; i < nPar; i++)
+      results.push_back(func.GetParameter(i));
+    for (unsigned i = 0; i < nPar; i++)
+      results.push_back(func.GetParError(i));
+
+    results.push_back(func.GetChisquare());
+    results.push_back(func.GetNDF());
+
+    double xmin, xmax;
+    func.GetRange(xmin, xmax);
+    results.push_back(xmin);
+    results.push_back(xmax);
+  }
+
+  unsigned ChannelFitExecutor::unpackFitFunc(TF1 &func,
+                                             const vector<double> &results,
+                                             const unsigned offset) {
+    const unsigned nPar = (unsigned)results.at(offset);
+    if (nPar != (unsigned)func.GetNpar() ||
+        offset + 1 + 2*nPar + 4 > results.size())
+      throw runtime_error(string("ChannelFitExecutor: invalid fit results for: ") +
+                          func.GetName());
+
+    const double *const vals = &results[offset + 1];
+    for (unsigned i = 0; i < nPar; i++) {
+      func.SetParameter(i, vals[i]);
+      func.SetParError(i, vals[nPar + i]);
+    }
+    func.SetChisquare(vals[2*nPar]);
+    func.SetNDF((int)vals[2*nPar + 1]);
+    func.SetRange(vals[2*nPar + 2], vals[2*nPar + 3]);
+
+    return offset + 1 + 2*nPar + 4;
+  }
+
+  unsigned ChannelFitExecutor::attachFitFunc(TH1 &hist,
+                                             const TF1 &proto,
+                                             const vector<double> &results,
+                                             const unsigned offset) {
+    // copy function same way TH1::Fit() does
+    TF1 *const func = static_cast<TF1*>(proto.IsA()->New());
+    proto.Copy(*func);
+
+    unsigned next;
+    try {
+      next = unpackFitFunc(*func, results, offset);
+    } catch (...) {
+      delete func;
+      throw;
+    }
+
+    TList &funcList = *hist.GetListOfFunctions();
+    TObject *const oldFunc = funcList.FindObject(proto.GetName());
+    if (oldFunc) {
+      funcList.Remove(oldFunc);
+      delete oldFunc;
+    }
+    funcList.Add(func);
+
+    return next;
+  }
+
+}; // namespace calibGenCAL
@@ -0,0 +1,100 @@
+#ifndef ChannelFitExecutor_h
+#define ChannelFitExecutor_h
+
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <vector>
+
+class TF1;
+class TH1;
+
+namespace calibGenCAL {
+
+  /** \brief independent per-channel fits for ChannelFitExecutor
+
+  fitChannel() does the (expensive) fit & packs everything the caller
+  needs into a flat list of doubles.  storeResults() unpacks the list
+  into calibration tables, log output, histogram functions, etc.
+  */
+  class ChannelFitter {
+  public:
+    virtual ~ChannelFitter() {}
+
+    /// fit single channel & append fit results to (empty) results list
+    /// \return false to skip channel (storeResults() will not be called)
+    /// \note may run in worker process: any other side effect is lost.
+    virtual bool fitChannel(const unsigned channel,
+                            std::vector<double> &results) = 0;
+
+    /// apply results of fitChannel() in calling process.
+    /// \note called in increasing channel order regardless of # of
+    /// workers, so txt & tuple output is reproducible.
+    virtual void storeResults(const unsigned channel,
+                              const std::vector<double> &results) = 0;
+  };
+
+  /** \brief run ChannelFitter over all channels on N worker processes
+
+  ROOT 5 fitting (TH1::Fit(), TVirtualFitter, TMinuit) goes through
+  global state & is not thread safe, so each worker is a fork()ed
+  copy of the calling process w/ its own histograms, TF1 & Minuit
+  instances (see runProcessTasks()).  channels are dealt to workers
+  round robin (neighbouring channels have similar fit cost), results
+  are stored in channel order.
+
+  \note nWorkers <= 1 fits all channels in calling process (no fork)
+  \note no other threads should be running during run()
+  */
+  class ChannelFitExecutor {
+  public:
+    explicit ChannelFitExecutor(const unsigned nWorkers = 1) :
+      m_nWorkers(nWorkers)
+    {}
+
+    /// fit channels [0, nChannels)
+    void run(ChannelFitter &fitter,
+             const unsigned nChannels) const;
+
+    /// append function parameters, errors, chi2, ndf & range to results
+    static void packFitFunc(const TF1 &func,
+                            std::vector<double> &results);
+
+    /// load parameters, errors, chi2, ndf & range packed by
+    /// packFitFunc() starting at results[offset] into func
+    /// \return offset of first value after packed function
+    static unsigned unpackFitFunc(TF1 &func,
+                                  const std::vector<double> &results,
+                                  const unsigned offset);
+
+    /// rebuild function packed by packFitFunc() starting at results[offset]
+    /// & attach copy to hist, replacing any function w/ same name.
+    ///
+    /// restores TH1::Fit() side effect on histogram when fit was done in
+    /// worker process.
+    /// \param proto supplies name & formula of attached function
+    /// \return offset of first value after packed function
+    static unsigned attachFitFunc(TH1 &hist,
+                                  const TF1 &proto,
+                                  const std::vector<double> &results,
+                                  const unsigned offset);
+
+  private:
+    void runSerial(ChannelFitter &fitter,
+                   const unsigned nChannels) const;
+
+    const unsigned m_nWorkers;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef ChannelSampleBuf_h
+#define ChannelSampleBuf_h
+
+// $Header: $
+
+/** @file
+    @brief fixed size per channel sample storage & histogram-free
+    clipped mean / rms.
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+#include <cmath>
+
+namespace calibGenCAL {
+
+  /// same arithmetic as TAxis::FindFixBin()
+  inline int findFixBin(const double x,
+                        const unsigned nBins,
+                        const double xmin,
+                        const double xmax,
+                        const double binScale) {
+    if (x < xmin)
+      return 0;
+    if (!(x < xmax))
+      return nBins + 1;
+    return 1 + int(binScale*(x - xmin));
+  }
+
+  /** \brief mean & rms of samples after nIter passes of +/- nSigma clipping.
+
+  equivalent to filling TH1(nBins, xmin, xmax) w/ samples & then
+  nIter times { SetAxisRange(mean-nSigma*rms, mean+nSigma*rms);
+  mean = GetMean(); rms = GetRMS(); }, w/out any ROOT objects.
+
+  \note exact only for samples on bin centers (e.g. integer adc values
+  w/ unit bins), as histogram moments are computed from bin centers.
+  \param rawMean mean of all in range samples before clipping
+  \param rawRMS rms of all in range samples before clipping
+  */
+  template <typename SampleType>
+  void clippedMeanRMS(const SampleType *samples,
+                      const unsigned nSamples,
+                      const unsigned nBins,
+                      const double xmin,
+                      const double xmax,
+                      float &rawMean,
+                      float &rawRMS,
+                      float &mean,
+                      float &rms,
+                      const unsigned short nIter = 3,
+                      const float nSigma = 3) {
+    const double binScale = nBins/(xmax - xmin);
+
+    int first = 1;
+    int last  = nBins;
+    for (unsigned short iter = 0; iter <= nIter; iter++) {
+      if (iter > 0) {
+        first = std::max(1, findFixBin(mean - nSigma*rms, nBins, xmin, xmax, binScale));
+        last  = std::min((int)nBins, findFixBin(mean + nSigma*rms, nBins, xmin, xmax, binScale));
+      }
+
+      double sumw = 0, sumx = 0, sumx2 = 0;
+      for (unsigned i = 0; i < nSamples; i++) {
+        const double x = samples[i];
+        const int bin = findFixBin(x, nBins, xmin, xmax, binScale);
+        if (bin < first || bin > last)
+          continue;
+
+        sumw  += 1;
+        sumx  += x;
+        sumx2 += x*x;
+      }
+
+      // empty window, same as TH1::GetMean() / GetRMS()
+      if (sumw == 0) {
+        mean = 0;
+        rms  = 0;
+      } else {
+        const double av = sumx/sumw;
+        mean = av;
+        rms  = std::sqrt(std::fabs(sumx2/sumw - av*av));
+      }
+
+      if (iter == 0) {
+        rawMean = mean;
+        rawRMS  = rms;
+      }
+    }
+  }
+
+  /** \brief up to N samples for every channel in one contiguous
+      preallocated block.
+
+      replaces per channel histograms / graphs which are reset for each
+      new setting.  each sample is tagged w/ its setting (step), a
+      channel's samples are discarded on its 1st sample from a new step,
+      so channels which miss the 1st event of a step are still reset.
+
+      \param IdxType channel index type (val() / N_VALS conventions of CalUtil::CalDefs)
+  */
+  template <typename IdxType,
+            typename SampleType>
+  class ChannelSampleBuf {
+  public:
+    explicit ChannelSampleBuf(const unsigned nSamplesPerChannel) :
+      m_nSamplesPerChannel(nSamplesPerChannel),
+      m_samples((size_t)IdxType::N_VALS*nSamplesPerChannel),
+      m_nSamples(IdxType::N_VALS, 0),
+      m_step(IdxType::N_VALS, 0)
+    {}
+
+    /// discard all samples for given channel
+    void clear(const IdxType &idx) {
+      m_nSamples[idx.val()] = 0;
+    }
+
+    /// append single sample to given channel
+    /// \param step id of current setting, e.g. 1st event # of DAC step
+    /// \throw std::runtime_error if more than nSamplesPerChannel samples
+    /// are added in the same step
+    void add(const IdxType &idx,
+             const unsigned step,
+             const SampleType val) {
+      unsigned &nSamples = m_nSamples[idx.val()];
+      if (m_step[idx.val()] != step) {
+        m_step[idx.val()] = step;
+        nSamples = 0;
+      }
+
+      if (nSamples >= m_nSamplesPerChannel) {
+        std::ostringstream tmp;
+        tmp << "ChannelSampleBuf: more than " << m_nSamplesPerChannel
+            << " samples for channel " << idx.val();
+        throw std::runtime_error(tmp.str());
+      }
+
+      m_samples[idx.val()*m_nSamplesPerChannel + nSamples] = val;
+      nSamples++;
+    }
+
+    unsigned getNSamples(const IdxType &idx) const {
+      return m_nSamples[idx.val()];
+    }
+
+    /// samples for given channel in order added
+    const SampleType *getSamples(const IdxType &idx) const {
+      return &m_samples[idx.val()*m_nSamplesPerChannel];
+    }
+
+  private:
+    const unsigned m_nSamplesPerChannel;
+
+    /// IdxType::N_VALS * m_nSamplesPerChannel samples
+    std::vector<SampleType> m_samples;
+
+    /// # of valid samples per channel
+    std::vector<unsigned> m_nSamples;
+
+    /// step of last add() per channel
+    std::vector<unsigned> m_step;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
@@ -0,0 +1,98 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "FusedDigiLoop.h"
+#include "RootFileAnalysis.h"
+#include "CGCUtil.h"
+
+// GLAST INCLUDES
+#include "digiRootData/DigiEvent.h"
+
+// EXTLIB INCLUDES
+#include "TChain.h"
+
+// STD INCLUDES
+#include <set>
+#include <ostream>
+
+namespace calibGenCAL {
+
+  using namespace std;
+
+  unsigned FusedDigiLoop::run() {
+    if (m_consumers.empty())
+      return 0;
+
+    RootFileAnalysis rootFile(0,
+                              &m_digiFilenames,
+                              0);
+
+    // enable union of all consumers' branches
+    vector<string> branches;
+    for (unsigned i = 0; i < m_consumers.size(); i++)
+      m_consumers[i]->getDigiBranches(branches);
+    const set<string> branchSet(branches.begin(), branches.end());
+
+    rootFile.getDigiChain()->SetBranchStatus("*", 0);
+    for (set<string>::const_iterator it = branchSet.begin();
+         it != branchSet.end();
+         it++)
+      rootFile.getDigiChain()->SetBranchStatus(it->c_str());
+
+    // consumers follow RootFileAnalysis::enableReadAhead() rules (see DigiEventConsumer)
+    rootFile.useDefaultReadAhead();
+
+    const unsigned nEvents = rootFile.getEntries();
+    LogStrm::get() << __FILE__ << ": Processing: " << nEvents << " events for "
+                   << m_consumers.size() << " algorithms." << endl;
+
+    /// consumers which still want events
+    vector<DigiEventConsumer*> active(m_consumers);
+
+    unsigned eventNum = 0;
+    for (; eventNum < nEvents && !active.empty(); eventNum++) {
+      if (eventNum % 10000 == 0) {
+        LogStrm::get() << "Event: " << eventNum
+                       << " active algorithms: " << active.size()
+                       << endl;
+        LogStrm::get().flush();
+      }
+
+      if (!rootFile.getEvent(eventNum)) {
+        LogStrm::get() << "Warning, event " << eventNum << " not read." << endl;
+        continue;
+      }
+
+      DigiEvent const*const digiEvent = rootFile.getDigiEvent();
+      if (!digiEvent) {
+        LogStrm::get() << __FILE__ << ": Unable to read DigiEvent " << eventNum  << endl;
+        continue;
+      }
+
+      for (unsigned i = 0; i < active.size(); i++)
+        if (!active[i]->consumeEvent(eventNum, *digiEvent)) {
+          active.erase(active.begin() + i);
+          i--;
+        }
+
+      // e.g. fits between passes, may fork() worker processes
+      for (unsigned i = 0; i < active.size(); i++)
+        if (active[i]->hasIdleWork()) {
+          rootFile.disableReadAhead();
+          active[i]->runIdleWork();
+        }
+    }
+
+    LogStrm::get() << __FILE__ << ": Read " << eventNum << " events." << endl;
+
+    rootFile.disableReadAhead();
+    for (unsigned i = 0; i < m_consumers.size(); i++)
+      m_consumers[i]->finishConsumer();
+
+    return eventNum;
+  }
+
+}; // namespace calibGenCAL
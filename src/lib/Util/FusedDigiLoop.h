@@ -0,0 +1,88 @@
+#ifndef FusedDigiLoop_h
+#define FusedDigiLoop_h
+
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <string>
+#include <vector>
+
+class DigiEvent;
+
+namespace calibGenCAL {
+
+  /** \brief one calibration algorithm's view of a FusedDigiLoop
+
+  consumers only see events which could be read, in increasing event
+  order.
+  */
+  class DigiEventConsumer {
+  public:
+    virtual ~DigiEventConsumer() {}
+
+    /// append names of digi tree branches required by this consumer
+    virtual void getDigiBranches(std::vector<std::string> &branches) const = 0;
+
+    /// process single event
+    /// \param eventNum index of event in input digi chain
+    /// \return false once consumer needs no more events
+    /// \note input may be read ahead in background thread: no ROOT
+    /// calls which use gDirectory (see RootFileAnalysis::enableReadAhead()),
+    /// e.g. create histograms before loop or w/ HistVec / HistMap.
+    virtual bool consumeEvent(const unsigned eventNum,
+                              const DigiEvent &digiEvent) = 0;
+
+    /// true if consumer has pending work which must run w/ no
+    /// background threads (e.g. fork()ed ChannelFitExecutor fits)
+    virtual bool hasIdleWork() const {
+      return false;
+    }
+
+    /// run pending work, called between events w/ input read ahead
+    /// stopped
+    virtual void runIdleWork() {}
+
+    /// called once for every consumer after event loop ends, w/ input
+    /// read ahead stopped
+    virtual void finishConsumer() {}
+  };
+
+  /** \brief read digi files once for several calibration algorithms
+
+  union of all consumers' branches is enabled, then each event is read
+  once & passed to every consumer which still wants events.  loop ends
+  when input is exhausted or no consumer wants more events.
+  */
+  class FusedDigiLoop {
+  public:
+    explicit FusedDigiLoop(const std::vector<std::string> &digiFilenames) :
+      m_digiFilenames(digiFilenames)
+    {}
+
+    /// consumers are called in order of registration
+    void addConsumer(DigiEventConsumer &consumer) {
+      m_consumers.push_back(&consumer);
+    }
+
+    /// read all events (see class description)
+    /// \return # of events read
+    unsigned run();
+
+  private:
+    const std::vector<std::string> m_digiFilenames;
+
+    std::vector<DigiEventConsumer*> m_consumers;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef IdxPtrTable_h
+#define IdxPtrTable_h
+
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+#include "CalUtil/CalVec.h"
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <vector>
+
+namespace calibGenCAL {
+
+  /** \brief sparse per event map from channel index to object pointer.
+
+  fixed size pointer array indexed by channel plus list of touched
+  channels, so set(), take() & empty() are O(1) and clear() only
+  visits channels set since last clear().  no allocation after first
+  few events.
+
+  \param IdxType channel index type (conventions of CalUtil::CalDefs)
+  */
+  template <typename IdxType,
+            typename ObjType>
+  class IdxPtrTable {
+  public:
+    IdxPtrTable() :
+      m_nSet(0)
+    {
+      m_touched.reserve(IdxType::N_VALS);
+    }
+
+    /// assign pointer to channel (replaces any previous value)
+    void set(const IdxType &idx,
+             ObjType *const obj) {
+      ObjType *&entry = m_table[idx];
+      if (entry == 0) {
+        m_nSet++;
+        m_touched.push_back(idx);
+      }
+      entry = obj;
+    }
+
+    /// remove & return pointer for channel (0 if not set)
+    ObjType *take(const IdxType &idx) {
+      ObjType *&entry = m_table[idx];
+      ObjType *const retVal = entry;
+      if (retVal != 0) {
+        entry = 0;
+        m_nSet--;
+      }
+      return retVal;
+    }
+
+    /// true if no channel is currently set
+    bool empty() const {
+      return m_nSet == 0;
+    }
+
+    /// unset all channels
+    void clear() {
+      for (unsigned i = 0; i < m_touched.size(); i++)
+        m_table[m_touched[i]] = 0;
+      m_touched.clear();
+      m_nSet = 0;
+    }
+
+  private:
+    CalUtil::CalVec<IdxType, ObjType *> m_table;
+
+    /// channels set since last clear() (may contain since taken channels)
+    std::vector<IdxType> m_touched;
+
+    /// # of non-null entries in m_table
+    unsigned m_nSet;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
@@ -0,0 +1,54 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "InputReadCfg.h"
+#include "RootFileAnalysis.h"
+#include "string_util.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+
+namespace calibGenCAL {
+
+  using namespace std;
+  using namespace CfgMgr;
+
+  InputReadCfg::InputReadCfg() :
+    readAhead("readAhead",
+              0,
+              "decode up to n events ahead of current event in background thread (0 = disabled)",
+              0),
+    cacheSizeMB("cacheSizeMB",
+                0,
+                "TTreeCache size for each input chain in MB (0 = disabled)",
+                30),
+    cacheBranches("cacheBranches",
+                  0,
+                  "comma delimited list of extra branches to register w/ TTreeCache",
+                  "")
+  {
+  }
+
+  void InputReadCfg::registerVars(CmdLineParser &cmdParser) {
+    cmdParser.registerVar(readAhead);
+    cmdParser.registerVar(cacheSizeMB);
+    cmdParser.registerVar(cacheBranches);
+  }
+
+  void InputReadCfg::applyDefaults() const {
+    // optional background event decoding for all event loops
+    RootFileAnalysis::setDefaultReadAhead(readAhead.getVal());
+
+    // input TTreeCache settings for all event loops
+    RootFileAnalysis::CachePolicy cachePolicy((Long64_t)cacheSizeMB.getVal()*1024*1024);
+    cachePolicy.extraBranches = tokenize_str(cacheBranches.getVal(), ",");
+    RootFileAnalysis::setDefaultCachePolicy(cachePolicy);
+  }
+
+}; // namespace calibGenCAL
@@ -0,0 +1,51 @@
+#ifndef InputReadCfg_h
+#define InputReadCfg_h
+
+// $Header: $
+
+/** @file
+    @brief input read ahead & TTreeCache commandline options shared by
+    event loop applications.
+*/
+
+// LOCAL INCLUDES
+#include "CfgMgr.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <string>
+
+namespace calibGenCAL {
+
+  /** \brief --readAhead, --cacheSizeMB & --cacheBranches options
+
+  usage: make it a member of application's AppCfg, call registerVars()
+  before parsing command line & applyDefaults() before opening any
+  RootFileAnalysis.
+  */
+  class InputReadCfg {
+  public:
+    InputReadCfg();
+
+    /// register all options w/ application command line parser
+    void registerVars(CfgMgr::CmdLineParser &cmdParser);
+
+    /// install parsed options as RootFileAnalysis defaults for all event loops
+    void applyDefaults() const;
+
+    /// background event decoding depth
+    CfgMgr::CmdOptVar<unsigned> readAhead;
+
+    /// input TTreeCache size
+    CfgMgr::CmdOptVar<unsigned> cacheSizeMB;
+
+    /// extra TTreeCache branches
+    CfgMgr::CmdOptVar<std::string> cacheBranches;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
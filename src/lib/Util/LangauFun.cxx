@@ -6,6 +6,8 @@
 // LOCAL INCLUDES
 #include "LangauFun.h"
 #include "string_util.h"
+#include "ThreadUtil.h"
+#include "CGCUtil.h"
 
 // GLAST INCLUDES
 
@@ -18,6 +20,9 @@
 // STD INCLUDES
 #include <cmath>
 #include <sstream>
+#include <vector>
+#include <map>
+#include <algorithm>
 
 namespace calibGenCAL {
   using namespace std;
@@ -92,8 +97,9 @@ namespace calibGenCAL {
       return height/(1 + exp((x-mpv)/sigma));
     }
 
-    static Double_t langaufun(Double_t *x,
-                              Double_t *par)
+    /// original numerical convolution, used where tabulated kernel does not apply
+    static Double_t langaufunDirect(Double_t *x,
+                                    Double_t *par)
     {
       // Numeric constants
 
@@ -166,9 +172,247 @@ namespace calibGenCAL {
       return retVal;
     }
 
+    /// convolution constants (same as langaufunDirect())
+    static const unsigned short CONV_NP = 100;
+    static const unsigned short CONV_SC = 5;
+    static const double MP_SHIFT = -0.22278298;
+
+    /// gaussian convolved landau in units of landau width:
+    /// langaufunDirect() = area/landau_width * langauKernel(t, r) + background
+    /// where t = (x - mpc)/landau_width & r = gaussian_width/landau_width
+    static double langauKernel(const double t,
+                               const double ratio) {
+      static const double invsq2pi = pow(2*M_PI, -.5);
+
+      double sum = 0;
+      for (unsigned short i = 1; i <= CONV_NP/2; i++) {
+        const double d = CONV_SC - (i - .5)*2.0*CONV_SC/CONV_NP;
+        sum += exp(-.5*d*d)*(TMath::Landau(t - ratio*d, 0, 1) +
+                             TMath::Landau(t + ratio*d, 0, 1));
+      }
+
+      return sum*2.0*CONV_SC/CONV_NP*invsq2pi;
+    }
+
+    /** \brief langauKernel() tabulated on uniform grid in t for single
+        width ratio.
+
+        log of kernel is tabulated w/ cubic interpolation, which holds
+        relative precision from peak down to far left tail.  landau samples
+        are spaced so that every convolution term falls on a grid point, so
+        table is built w/ one TMath::Landau() call per point.  table is
+        checked against langauKernel() at construction.
+    */
+    class LangauTable {
+    public:
+      explicit LangauTable(const double ratio);
+
+      /// gaussian width / landau width
+      const double ratio;
+
+      /// \return false if t is not covered by table
+      bool eval(const double t,
+                double &k) const {
+        const double u = (t - m_lo)*m_invStep;
+        if (!m_valid || !(u < m_uMax))
+          return false;
+
+        // kernel underflows below table
+        if (u < 1) {
+          k = 0;
+          return true;
+        }
+
+        // 4 point lagrange interpolation
+        const unsigned j = (unsigned)u;
+        const double f = u - j;
+        const double *const p = &m_logVals[j - 1];
+        k = exp(-f*(f - 1)*(f - 2)/6*p[0]
+                + (f + 1)*(f - 1)*(f - 2)/2*p[1]
+                - (f + 1)*f*(f - 2)/2*p[2]
+                + (f + 1)*f*(f - 1)/6*p[3]);
+        return true;
+      }
+
+    private:
+      /// max grid spacing in t
+      static const double MAX_STEP;
+      /// table ends here (landau tail approximation changes at 300)
+      static const double T_HI;
+      /// kernel values below this are treated as 0
+      static const double MIN_VAL;
+      /// max allowed relative interpolation error
+      static const double MAX_REL_ERR;
+      /// check every n'th interval against langauKernel()
+      static const unsigned CHECK_STRIDE = 16;
+
+      /// t of 1st table entry
+      double m_lo;
+      double m_invStep;
+      /// upper limit of (t - m_lo)/step w/ full interpolation stencil
+      double m_uMax;
+
+      /// false if table failed validation
+      bool m_valid;
+
+      std::vector<double> m_logVals;
+    };
+
+    const double LangauTable::MAX_STEP    = 0.01;
+    const double LangauTable::T_HI        = 290;
+    const double LangauTable::MIN_VAL     = 1e-290;
+    const double LangauTable::MAX_REL_ERR = 1e-4;
+
+    LangauTable::LangauTable(const double r) :
+      ratio(r),
+      m_lo(0),
+      m_invStep(0),
+      m_uMax(0),
+      m_valid(true)
+    {
+      static const double invsq2pi = pow(2*M_PI, -.5);
+
+      // convolution terms are at t +- r*(CONV_SC/CONV_NP)*(CONV_NP + 1 - 2i),
+      // so grid step must divide r*CONV_SC/CONV_NP
+      const double halfStep = r*CONV_SC/CONV_NP;
+      const unsigned m = max<unsigned>(1, (unsigned)ceil(halfStep/MAX_STEP));
+      const double step = halfStep/m;
+
+      // TMath::Landau() is exactly 0 below -24 (cernlib denlan)
+      const double tLo = -(CONV_SC*r + 25);
+      const unsigned n = (unsigned)((T_HI - tLo)/step) + 1;
+      const unsigned maxOff = (CONV_NP - 1)*m;
+
+      std::vector<double> landau(n + 2*maxOff);
+      for (unsigned p = 0; p < landau.size(); p++)
+        landau[p] = TMath::Landau(tLo + ((double)p - maxOff)*step, 0, 1);
+
+      std::vector<double> gaus(CONV_NP/2 + 1);
+      for (unsigned short i = 1; i <= CONV_NP/2; i++) {
+        const double d = CONV_SC - (i - .5)*2.0*CONV_SC/CONV_NP;
+        gaus[i] = exp(-.5*d*d);
+      }
+
+      std::vector<double> vals(n);
+      for (unsigned j = 0; j < n; j++) {
+        double sum = 0;
+        for (unsigned short i = 1; i <= CONV_NP/2; i++) {
+          const unsigned off = (CONV_NP + 1 - 2*i)*m;
+          sum += gaus[i]*(landau[j + maxOff - off] + landau[j + maxOff + off]);
+        }
+        vals[j] = sum*2.0*CONV_SC/CONV_NP*invsq2pi;
+      }
+
+      // start table where log is well defined
+      unsigned first = 0;
+      while (first + 4 < n && vals[first] < MIN_VAL)
+        first++;
+
+      m_logVals.resize(n - first);
+      for (unsigned j = 0; j < m_logVals.size(); j++)
+        m_logVals[j] = log(vals[first + j]);
+
+      m_lo = tLo + first*step;
+      m_invStep = 1/step;
+      m_uMax = m_logVals.size() - 2.0;
+
+      // validate interpolation against direct sum at interval midpoints
+      for (unsigned j = 1; j + 2 < m_logVals.size(); j += CHECK_STRIDE) {
+        const double t = m_lo + (j + .5)*step;
+        const double exact = langauKernel(t, r);
+        double k = 0;
+        eval(t, k);
+        if (exact > MIN_VAL && fabs(k - exact) > MAX_REL_ERR*exact) {
+          LogStrm::get() << __FILE__ << ": WARNING: langau table for width ratio " << r
+                         << " exceeds tolerance at t=" << t
+                         << ", using numerical convolution" << endl;
+          m_valid = false;
+          return;
+        }
+      }
+    }
+
+    /// max # of width ratios w/ tables (only needed if widths are free fit parameters)
+    static const unsigned MAX_LANGAU_TABLES = 16;
+
+    /// tables are built on first use & kept until exit
+    static Mutex langauTableMutex;
+    static std::map<double, LangauTable*> langauTables;
+
+    /// \return table for given width ratio, NULL if table limit is reached
+    static const LangauTable *getLangauTable(const double ratio) {
+      MutexLock lock(langauTableMutex);
+
+      const std::map<double, LangauTable*>::const_iterator it(langauTables.find(ratio));
+      if (it != langauTables.end())
+        return it->second;
+
+      if (langauTables.size() >= MAX_LANGAU_TABLES)
+        return 0;
+
+      return langauTables[ratio] = new LangauTable(ratio);
+    }
+
+    /** \brief fit function: tabulated kernel where possible, otherwise
+        langaufunDirect()
+
+        each TF1 holds its own copy (TF1 copies clone the functor), w/
+        table for last width ratio, so table is only looked up when
+        ratio changes (never in default fit, where both widths are
+        fixed).
+    */
+    class LangauFunctor {
+    public:
+      LangauFunctor() :
+        m_ratio(0),
+        m_table(0),
+        m_cached(false)
+      {}
+
+      Double_t operator()(Double_t *x,
+                          Double_t *par) const {
+        const double real_lan = par[PARM_LAN_WID]*par[PARM_MPV];
+        const double real_gau = par[PARM_GAU_WID]*par[PARM_MPV];
+        if (!(real_lan > 0 && real_gau > 0))
+          return langaufunDirect(x, par);
+
+        // ratio from fractional widths so that it is independent of mpv
+        const LangauTable *const table = getTable(par[PARM_GAU_WID]/par[PARM_LAN_WID]);
+        double k;
+        if (table == 0 ||
+            !table->eval((x[0] - (par[PARM_MPV] - MP_SHIFT*real_lan))/real_lan, k))
+          return langaufunDirect(x, par);
+
+        const double convolved_width = sqrt(real_gau*real_gau + real_lan*real_lan);
+        return par[PARM_LAN_AREA]*k/real_lan +
+          bckgnd_model(x[0],
+                       par[PARM_BKGND_HEIGHT],
+                       par[PARM_MPV],
+                       convolved_width);
+      }
+
+    private:
+      /// \return table for given width ratio, NULL if table limit is reached
+      const LangauTable *getTable(const double ratio) const {
+        if (!m_cached || ratio != m_ratio) {
+          m_table = getLangauTable(ratio);
+          m_ratio = ratio;
+          m_cached = true;
+        }
+
+        return m_table;
+      }
+
+      /// width ratio of m_table
+      mutable double m_ratio;
+      mutable const LangauTable *m_table;
+      /// false until 1st lookup
+      mutable bool m_cached;
+    };
+
     static TF1 *buildLangauDAC() {
       TF1 *ffit = new TF1(func_name.c_str(),
-                          langaufun,
+                          LangauFunctor(),
                           fitRange[0],
                           fitRange[1],
                           N_PARMS);
@@ -0,0 +1,96 @@
+#ifndef LineFit_h
+#define LineFit_h
+
+// $Header: $
+
+/** @file
+    @brief closed form least squares straight line fit
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+
+namespace calibGenCAL {
+
+  /** \brief unweighted least squares fit of y = intercept + slope*x
+
+  same result as TGraph::Fit("pol1", "WQN") w/out going through
+  TVirtualFitter, intended for the handful of points in a hodoscopic
+  track.  points are accumulated as running sums, so no storage is
+  needed.
+  */
+  class LineFit {
+  public:
+    LineFit() {
+      clear();
+    }
+
+    /// discard all points & fit results
+    void clear() {
+      m_n      = 0;
+      m_sumX   = 0;
+      m_sumY   = 0;
+      m_sumXX  = 0;
+      m_sumXY  = 0;
+      m_slope     = 0;
+      m_intercept = 0;
+    }
+
+    void addPoint(const double x,
+                  const double y) {
+      m_n++;
+      m_sumX  += x;
+      m_sumY  += y;
+      m_sumXX += x*x;
+      m_sumXY += x*y;
+    }
+
+    unsigned getNPoints() const {
+      return m_n;
+    }
+
+    /// fit line through all points added since clear()
+    /// \return false (& leave previous slope / intercept) if there
+    /// are fewer than 2 distinct x values.
+    bool fit() {
+      const double denom = m_n*m_sumXX - m_sumX*m_sumX;
+      if (m_n < 2 || !(denom > 0))
+        return false;
+
+      m_slope     = (m_n*m_sumXY - m_sumX*m_sumY)/denom;
+      m_intercept = (m_sumY - m_slope*m_sumX)/m_n;
+      return true;
+    }
+
+    double getSlope() const {
+      return m_slope;
+    }
+
+    double getIntercept() const {
+      return m_intercept;
+    }
+
+    /// evaluate fitted line at x
+    double eval(const double x) const {
+      return m_intercept + m_slope*x;
+    }
+
+  private:
+    unsigned m_n;
+    double   m_sumX;
+    double   m_sumY;
+    double   m_sumXX;
+    double   m_sumXY;
+
+    double   m_slope;
+    double   m_intercept;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
@@ -0,0 +1,225 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "ProcessUtil.h"
+#include "CGCUtil.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+namespace calibGenCAL {
+
+  using namespace std;
+
+  namespace {
+    /// flush everything buffered in this process so that fork()ed
+    /// copies do not output it a second time.
+    void flushAllStreams() {
+      LogStrm::flush();
+      cout.flush();
+      cerr.flush();
+    }
+
+    /// run single task & send result down pipe
+    /// \note runs in child process, never returns
+    void runChild(ProcessTask &task,
+                  const unsigned nTask,
+                  const int fd) {
+      int status = 0;
+      try {
+        string result;
+        task.run(result);
+
+        const char *pos = result.data();
+        size_t nLeft = result.size();
+        while (nLeft > 0) {
+          const ssize_t n = write(fd, pos, nLeft);
+          if (n < 0) {
+            if (errno == EINTR)
+              continue;
+            status = 1;
+            break;
+          }
+          pos   += n;
+          nLeft -= n;
+        }
+      } catch (exception &e) {
+        cerr << "runProcessTasks: task " << nTask
+             << " exception thrown: " << e.what() << endl;
+        status = 1;
+      } catch (...) {
+        cerr << "runProcessTasks: task " << nTask
+             << " unknown exception thrown" << endl;
+        status = 1;
+      }
+
+      close(fd);
+      flushAllStreams();
+
+      // skip atexit handlers & static destructors, which would
+      // otherwise close / write parent's open ROOT files
+      _exit(status);
+    }
+
+    /// single running child
+    struct Child {
+      unsigned nTask;
+      pid_t pid;
+      /// read end of result pipe, -1 after EOF
+      int fd;
+    };
+
+    /// wait for child to exit
+    /// \return true if child exited normally w/ 0 status
+    bool reapChild(const pid_t pid) {
+      int status = 0;
+      while (waitpid(pid, &status, 0) < 0)
+        if (errno != EINTR)
+          return false;
+
+      return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+  }
+
+  void ResultReader::readBytes(void *dst,
+                               const size_t nBytes) {
+    if (m_buf.size() - m_pos < nBytes)
+      throw runtime_error("ResultReader: truncated process task result");
+
+    memcpy(dst, m_buf.data() + m_pos, nBytes);
+    m_pos += nBytes;
+  }
+
+  void ResultReader::readString(string &str) {
+    unsigned len = 0;
+    read(len);
+    if (m_buf.size() - m_pos < len)
+      throw runtime_error("ResultReader: truncated process task result");
+
+    str.assign(m_buf, m_pos, len);
+    m_pos += len;
+  }
+
+  void runProcessTasks(const vector<ProcessTask*> &tasks,
+                       const unsigned nProcs) {
+    const unsigned maxChildren = max(1U, nProcs);
+
+    vector<string> results(tasks.size());
+    vector<bool> failed(tasks.size(), false);
+    string forkError;
+
+    vector<Child> running;
+    vector<char> chunk(1<<16);
+    unsigned nextTask = 0;
+    while (nextTask < tasks.size() || !running.empty()) {
+      // start new children up to limit, unless a fork has failed
+      while (forkError.empty() &&
+             nextTask < tasks.size() &&
+             running.size() < maxChildren) {
+        int pipeFds[2];
+        if (pipe(pipeFds) != 0) {
+          forkError = "pipe() failed";
+          break;
+        }
+
+        flushAllStreams();
+        const pid_t pid = fork();
+        if (pid < 0) {
+          close(pipeFds[0]);
+          close(pipeFds[1]);
+          forkError = "fork() failed";
+          break;
+        }
+
+        if (pid == 0) {
+          // child does not need read ends of any pipe
+          close(pipeFds[0]);
+          for (unsigned i = 0; i < running.size(); i++)
+            close(running[i].fd);
+
+          runChild(*tasks[nextTask], nextTask, pipeFds[1]);
+        }
+
+        close(pipeFds[1]);
+        Child child;
+        child.nTask = nextTask;
+        child.pid   = pid;
+        child.fd    = pipeFds[0];
+        running.push_back(child);
+        nextTask++;
+      }
+
+      if (running.empty())
+        break;
+
+      // read from all running children until at least one finishes
+      vector<struct pollfd> pfds(running.size());
+      for (unsigned i = 0; i < running.size(); i++) {
+        pfds[i].fd      = running[i].fd;
+        pfds[i].events  = POLLIN;
+        pfds[i].revents = 0;
+      }
+
+      if (poll(&pfds[0], pfds.size(), -1) < 0) {
+        if (errno == EINTR)
+          continue;
+        // drain remaining children w/ blocking reads
+        for (unsigned i = 0; i < pfds.size(); i++)
+          pfds[i].revents = POLLIN;
+      }
+
+      for (unsigned i = 0; i < running.size(); i++) {
+        if (pfds[i].revents == 0)
+          continue;
+
+        Child &child = running[i];
+        const ssize_t n = read(child.fd, &chunk[0], chunk.size());
+        if (n > 0)
+          results[child.nTask].append(&chunk[0], n);
+        else if (n == 0 || errno != EINTR) {
+          close(child.fd);
+          child.fd = -1;
+        }
+      }
+
+      // reap finished children
+      for (unsigned i = 0; i < running.size(); i++)
+        if (running[i].fd < 0) {
+          if (!reapChild(running[i].pid))
+            failed[running[i].nTask] = true;
+          running.erase(running.begin() + i);
+          i--;
+        }
+    }
+
+    if (!forkError.empty())
+      throw runtime_error("runProcessTasks: " + forkError);
+
+    for (unsigned nTask = 0; nTask < tasks.size(); nTask++)
+      if (failed[nTask]) {
+        ostringstream msg;
+        msg << "runProcessTasks: task " << nTask << " failed";
+        throw runtime_error(msg.str());
+      }
+
+    for (unsigned nTask = 0; nTask < tasks.size(); nTask++)
+      tasks[nTask]->setResult(results[nTask]);
+  }
+
+}; // namespace calibGenCAL
@@ -0,0 +1,114 @@
+#ifndef ProcessUtil_h
+#define ProcessUtil_h
+
+// $Header: $
+
+/** @file
+    @brief run independent units of work in fork()ed worker processes
+    (for ROOT I/O & other code which is not thread safe).
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <string>
+#include <vector>
+
+namespace calibGenCAL {
+
+  /// single unit of work for runProcessTasks()
+  class ProcessTask {
+  public:
+    virtual ~ProcessTask() {}
+
+    /// runs in fork()ed child process: all side effects except output
+    /// files & result string are lost.
+    /// \param result (empty) opaque result, passed to setResult() in
+    /// calling process
+    /// \note exceptions thrown here fail the task
+    virtual void run(std::string &result) = 0;
+
+    /// store result of successful run() in calling process
+    virtual void setResult(const std::string &result) {}
+  };
+
+  /// append plain data value to ProcessTask result
+  template <typename T>
+  inline void packVal(std::string &buf,
+                      const T &val) {
+    buf.append(reinterpret_cast<const char*>(&val), sizeof(val));
+  }
+
+  /// append n plain data values to ProcessTask result
+  template <typename T>
+  inline void packArray(std::string &buf,
+                        const T *vals,
+                        const size_t n) {
+    if (n > 0)
+      buf.append(reinterpret_cast<const char*>(vals), n*sizeof(T));
+  }
+
+  /// append length & contents of string to ProcessTask result
+  inline void packString(std::string &buf,
+                         const std::string &str) {
+    packVal(buf, (unsigned)str.size());
+    buf.append(str);
+  }
+
+  /// sequential reader for result built w/ packVal(), packArray() & packString()
+  class ResultReader {
+  public:
+    explicit ResultReader(const std::string &buf) :
+      m_buf(buf),
+      m_pos(0)
+    {}
+
+    template <typename T>
+    void read(T &val) {
+      readBytes(&val, sizeof(val));
+    }
+
+    template <typename T>
+    void readArray(T *vals,
+                   const size_t n) {
+      if (n > 0)
+        readBytes(vals, n*sizeof(T));
+    }
+
+    void readString(std::string &str);
+
+    /// true when all of result has been read
+    bool atEnd() const {
+      return m_pos == m_buf.size();
+    }
+
+  private:
+    /// 	hrow std::runtime_error if result is truncated
+    void readBytes(void *dst,
+                   const size_t nBytes);
+
+    const std::string &m_buf;
+
+    size_t m_pos;
+  };
+
+  /// run each task in its own fork()ed copy of calling process, w/ up
+  /// to nProcs children at once, return when all are finished.
+  ///
+  /// tasks are started in list order.  if any task fails, the
+  /// remaining tasks still run & failure of lowest numbered failed
+  /// task is thrown as std::runtime_error.  setResult() is called in
+  /// list order for successful tasks.
+  /// \note children exit via _exit(), so they never close / write
+  /// calling process's open ROOT files
+  /// \note no other threads should be running (see RootFileAnalysis::disableReadAhead())
+  void runProcessTasks(const std::vector<ProcessTask*> &tasks,
+                       const unsigned nProcs);
+
+}; // namespace calibGenCAL
+
+#endif
@@ -8,10 +8,13 @@
 // STD INCLUDES
 #include <string>
 #include <queue>
+#include <map>
 #include <stdexcept>
 
 // EXTLIB INCLUDES
 #include "TDirectory.h"
+#include "TKey.h"
+#include "TList.h"
 
 // GLAST INCLUDES
 
@@ -79,6 +82,60 @@ namespace calibGenCAL {
     return child;
   }
 
+  void indexROOTKeys(TDirectory &rootDir,
+                     const string &prefix,
+                     map<string, TKey*> &keyIndex) {
+    TIter nextKey(rootDir.GetListOfKeys());
+    while (TKey *const key = (TKey*)nextKey()) {
+      const TClass *const cls(gROOT->GetClass(key->GetClassName()));
+      if (cls == 0)
+        continue;
+
+      const string name(key->GetName());
+
+      /// if key is sub dir, recursively scan it
+      if (cls->InheritsFrom(TDirectory::Class())) {
+        TDirectory *const subdir = rootDir.GetDirectory(name.c_str());
+        if (subdir != 0)
+          indexROOTKeys(*subdir, prefix, keyIndex);
+      }
+
+      /// keys are sorted by decreasing cycle, so 1st key w/ any name wins
+      else if (name.find(prefix) == 0)
+        keyIndex.insert(make_pair(name, key));
+    }
+  }
+
+  TDirectory &ROOTDirCache::produceDir(const string &subPath) {
+    if (m_topDir == 0)
+      throw runtime_error("ROOTDirCache: top level directory not set");
+
+    // ignore trailing '/'
+    const string::size_type last = subPath.find_last_not_of('/');
+    if (last == string::npos)
+      return *m_topDir;
+    const string path(subPath, 0, last + 1);
+
+    const map<string, TDirectory*>::const_iterator it(m_dirs.find(path));
+    if (it != m_dirs.end())
+      return *it->second;
+
+    /// resolve parent (cached) then single child
+    const string::size_type slash = path.rfind('/');
+    TDirectory &parent = (slash == string::npos) ? *m_topDir : produceDir(path.substr(0, slash));
+    const string childName = (slash == string::npos) ? path : path.substr(slash + 1);
+
+    TDirectory *child = parent.GetDirectory(childName.c_str());
+    if (child == 0) {
+      child = parent.mkdir(childName.c_str());
+      if (child == 0)
+        throw runtime_error("Unable to create ROOT dir: " + string(parent.GetPath()) + "/" + childName);
+    }
+
+    m_dirs[path] = child;
+    return *child;
+  }
+
   TDirectory *deliverROOTDir(TDirectory *const parent,
                              const string &childPath) {
     const string fullpath(string(parent->GetPath()) + childPath);
@@ -23,6 +23,7 @@
 #include <cassert>
 #include <string>
 #include <vector>
+#include <map>
 
 namespace calibGenCAL {
   /// use this method to retrieve a histogram of given
@@ -94,6 +95,15 @@ namespace calibGenCAL {
 
     return retVal;
   }
+
+  /// map object name -> TKey for all keys below given dir (recursively)
+  /// whose name starts w/ given prefix, w/out reading any objects.
+  /// \note only highest cycle of each name is kept
+  /// \note keys are owned by their TFile, which must stay open while
+  /// index is in use
+  void indexROOTKeys(TDirectory &rootDir,
+                     const std::string &prefix,
+                     std::map<std::string, TKey*> &keyIndex);
                      
   /// create new 1D histogram w/ residuals from fitted 1D histogram
   /// and 1st TF1 on histogram list-of-fuctions
@@ -135,6 +145,41 @@ namespace calibGenCAL {
   TDirectory *deliverROOTDir(TDirectory *const parent,
                              const std::string &childPath);
 
+  /** \brief subdirectories of single top level ROOT directory, each one
+      looked up (or created) only once.
+
+      replaces repeated deliverROOTDir() calls for large histogram
+      collections.
+  */
+  class ROOTDirCache {
+  public:
+    explicit ROOTDirCache(TDirectory *const topDir = 0) :
+      m_topDir(topDir)
+    {}
+
+    /// change top level directory & discard cached subdirectories
+    void reset(TDirectory *const topDir) {
+      m_topDir = topDir;
+      m_dirs.clear();
+    }
+
+    TDirectory *getTopDir() const {
+      return m_topDir;
+    }
+
+    /// return subdirectory of top level dir at '/' separated path,
+    /// create subfolders as needed
+    /// \throws std::runtime_error if top level dir is not set or
+    /// directory cannot be created
+    TDirectory &produceDir(const std::string &subPath);
+
+  private:
+    TDirectory *m_topDir;
+
+    /// cached subdirectories by path (w/out trailing '/')
+    std::map<std::string, TDirectory*> m_dirs;
+  };
+
   /// reset histogram limits to remove outliers using TH1::SetAxisRange()
   /// \note algorithm works by iteratively clipping @ mean +/- 3*RMS
   template <class HistType>
@@ -7,6 +7,7 @@
 // LOCAL INCLUDES
 #include "RootFileAnalysis.h"
 #include "CGCUtil.h"
+#include "ThreadUtil.h"
 
 // GLAST INCLUDES
 #include "digiRootData/DigiEvent.h"
@@ -17,22 +18,366 @@
 // EXTLIB INCLUDES
 #include "TChainElement.h"
 #include "TStreamerInfo.h"
+#include "TBranch.h"
 
 // STD INCLUDES
 #include <vector>
 #include <string>
 #include <ostream>
+#include <stdexcept>
 
 namespace calibGenCAL {
 
   using namespace std;
 
+  /** \brief decode events in background thread into ring of preallocated event objects
+
+  ring slots in [m_consumePos, m_consumePos + m_nFilled) are decoded &
+  waiting for the consumer.  slot (m_consumePos - 1) belongs to the
+  consumer while m_holding is true.  the producer always writes the slot
+  following the last filled one.
+  */
+  class RootFileAnalysis::ReadAhead {
+  public:
+    ReadAhead(RootFileAnalysis &parent,
+              const unsigned depth) :
+      m_parent(parent),
+      m_slots(depth+1),
+      m_nEntries(parent.getEntries()),
+      m_origMcEvt(parent.m_mcEvt),
+      m_origDigiEvt(parent.m_digiEvt),
+      m_origReconEvt(parent.m_reconEvt),
+      m_origGcrSelectEvt(parent.m_gcrSelectEvt),
+      m_readMcEvt(0),
+      m_readDigiEvt(0),
+      m_readReconEvt(0),
+      m_readGcrSelectEvt(0),
+      m_running(false)
+    {
+      // preallocate all event objects in main thread
+      for (unsigned i = 0; i < m_slots.size(); i++) {
+        Slot &slot = m_slots[i];
+        if (isEnabled(parent.m_mcChain))
+          slot.mcEvt = new McEvent;
+        if (isEnabled(parent.m_digiChain))
+          slot.digiEvt = new DigiEvent;
+        if (isEnabled(parent.m_reconChain))
+          slot.reconEvt = new ReconEvent;
+        if (isEnabled(parent.m_gcrSelectChain))
+          slot.gcrSelectEvt = new GcrSelectEvent;
+      }
+
+      // bind each chain once (in main thread) to a fixed pointer, the
+      // producer only points it at the slot being read.
+      m_readMcEvt        = m_slots[0].mcEvt;
+      m_readDigiEvt      = m_slots[0].digiEvt;
+      m_readReconEvt     = m_slots[0].reconEvt;
+      m_readGcrSelectEvt = m_slots[0].gcrSelectEvt;
+      if (isEnabled(parent.m_mcChain))
+        parent.m_mcChain.SetBranchAddress("McEvent", &m_readMcEvt);
+      if (isEnabled(parent.m_digiChain))
+        parent.m_digiChain.SetBranchAddress("DigiEvent", &m_readDigiEvt);
+      if (isEnabled(parent.m_reconChain))
+        parent.m_reconChain.SetBranchAddress("ReconEvent", &m_readReconEvt);
+      if (isEnabled(parent.m_gcrSelectChain))
+        parent.m_gcrSelectChain.SetBranchAddress("GcrSelectEvent", &m_readGcrSelectEvt);
+
+      resetRing(0);
+    }
+
+    ~ReadAhead() {
+      stop();
+
+      // restore parent's own event objects so parent dtor cleans up
+      // properly & chains no longer point into ring
+      m_parent.m_mcEvt        = m_origMcEvt;
+      m_parent.m_digiEvt      = m_origDigiEvt;
+      m_parent.m_reconEvt     = m_origReconEvt;
+      m_parent.m_gcrSelectEvt = m_origGcrSelectEvt;
+      if (isEnabled(m_parent.m_mcChain))
+        m_parent.m_mcChain.SetBranchAddress("McEvent", &m_parent.m_mcEvt);
+      if (isEnabled(m_parent.m_digiChain))
+        m_parent.m_digiChain.SetBranchAddress("DigiEvent", &m_parent.m_digiEvt);
+      if (isEnabled(m_parent.m_reconChain))
+        m_parent.m_reconChain.SetBranchAddress("ReconEvent", &m_parent.m_reconEvt);
+      if (isEnabled(m_parent.m_gcrSelectChain))
+        m_parent.m_gcrSelectChain.SetBranchAddress("GcrSelectEvent", &m_parent.m_gcrSelectEvt);
+
+      for (unsigned i = 0; i < m_slots.size(); i++) {
+        delete m_slots[i].mcEvt;
+        delete m_slots[i].digiEvt;
+        delete m_slots[i].reconEvt;
+        delete m_slots[i].gcrSelectEvt;
+      }
+    }
+
+    /// # of events decoded ahead of consumer
+    unsigned getDepth() const {
+      return m_slots.size() - 1;
+    }
+
+    /// retrieve decoded event objects for given entry into parent's event pointers
+    /// \param unmatched set if entry was dropped by event alignment
+    /// \return # of bytes read for event chains, 0 if entry could not be read
+    UInt_t getEvent(const UInt_t iEvt,
+                    bool &unmatched) {
+      unmatched = false;
+
+      MutexLock lock(m_mutex);
+
+      // release previous event
+      if (m_holding) {
+        m_holding = false;
+        m_cond.broadcast();
+      }
+
+      // out of sequence request, restart producer @ new position
+      if (iEvt != m_expectEntry || !m_running) {
+        m_mutex.unlock();
+        stop();
+        m_mutex.lock();
+        resetRing(iEvt);
+        start();
+      }
+
+      while (m_nFilled == 0 && !m_producerDone)
+        m_cond.wait(m_mutex);
+
+      if (m_nFilled == 0)
+        return 0;
+
+      Slot &slot = m_slots[m_consumePos];
+      m_consumePos = (m_consumePos + 1) % m_slots.size();
+      m_nFilled--;
+      m_holding = true;
+      m_expectEntry = iEvt + 1;
+
+      m_parent.m_mcEvt        = slot.mcEvt;
+      m_parent.m_digiEvt      = slot.digiEvt;
+      m_parent.m_reconEvt     = slot.reconEvt;
+      m_parent.m_gcrSelectEvt = slot.gcrSelectEvt;
+
+      unmatched = slot.unmatched;
+      return slot.nBytes;
+    }
+
+  private:
+    /// one set of event objects
+    class Slot {
+    public:
+      Slot() :
+        mcEvt(0),
+        digiEvt(0),
+        reconEvt(0),
+        gcrSelectEvt(0),
+        nBytes(0),
+        unmatched(false)
+      {}
+
+      McEvent        *mcEvt;
+      DigiEvent      *digiEvt;
+      ReconEvent     *reconEvt;
+      GcrSelectEvent *gcrSelectEvt;
+
+      /// total bytes read for this entry
+      UInt_t          nBytes;
+
+      /// true if entry had no match in aligned chain
+      bool            unmatched;
+    };
+
+    /// true if chain is in parent's active chain list
+    bool isEnabled(TChain &chain) const {
+      return m_parent.isActive(chain);
+    }
+
+    /// empty ring, next entry produced will be iEvt
+    /// \note caller must hold lock, producer must be stopped
+    void resetRing(const UInt_t iEvt) {
+      m_consumePos  = 0;
+      m_nFilled     = 0;
+      m_holding     = false;
+      m_nextRead    = iEvt;
+      m_expectEntry = iEvt;
+      m_stop        = false;
+      m_producerDone = false;
+    }
+
+    /// launch producer thread
+    /// \note caller must hold lock
+    void start() {
+      if (pthread_create(&m_thread, 0, producerMain, this) != 0)
+        throw runtime_error("RootFileAnalysis: unable to start read ahead thread");
+      m_running = true;
+    }
+
+    /// stop & join producer thread
+    /// \note caller must NOT hold lock
+    void stop() {
+      {
+        MutexLock lock(m_mutex);
+        if (!m_running)
+          return;
+        m_stop = true;
+        m_cond.broadcast();
+      }
+
+      pthread_join(m_thread, 0);
+
+      MutexLock lock(m_mutex);
+      m_running = false;
+    }
+
+    static void *producerMain(void *arg) {
+      static_cast<ReadAhead*>(arg)->produce();
+      return 0;
+    }
+
+    /// producer loop, decode events until end of input or stop request
+    void produce() {
+      MutexLock lock(m_mutex);
+      const unsigned nSlots = m_slots.size();
+
+      while (true) {
+        // wait for free slot
+        while (!m_stop && m_nFilled + (m_holding ? 1 : 0) >= nSlots)
+          m_cond.wait(m_mutex);
+
+        if (m_stop)
+          break;
+
+        if (m_nextRead >= m_nEntries) {
+          m_producerDone = true;
+          m_cond.broadcast();
+          break;
+        }
+
+        const UInt_t iEvt = m_nextRead++;
+        Slot &slot = m_slots[(m_consumePos + m_nFilled) % nSlots];
+
+        // slot is not visible to consumer until m_nFilled is updated
+        m_mutex.unlock();
+        readSlot(slot, iEvt);
+        m_mutex.lock();
+
+        m_nFilled++;
+        m_cond.broadcast();
+      }
+    }
+
+    /// read single entry from all event object chains into given slot
+    /// \note reads (incl. opening of next file in chain) are done under
+    /// ROOTIOLock so gDirectory is never changed under caller's feet.
+    void readSlot(Slot &slot,
+                  const UInt_t iEvt) {
+      ROOTIOLock ioLock;
+
+      slot.nBytes = 0;
+      slot.unmatched = false;
+
+      // digi is read 1st as it is the reference for alignment mode
+      if (slot.digiEvt) {
+        slot.digiEvt->Clear();
+        m_readDigiEvt = slot.digiEvt;
+        slot.nBytes += m_parent.m_digiChain.GetEvent(iEvt);
+
+        if (m_parent.m_aligned && slot.nBytes == 0)
+          return;
+      }
+
+      if (slot.mcEvt)
+        if (!readAligned(m_parent.m_mcChain, slot.mcEvt, m_readMcEvt, slot, iEvt))
+          return;
+
+      if (slot.reconEvt)
+        if (!readAligned(m_parent.m_reconChain, slot.reconEvt, m_readReconEvt, slot, iEvt))
+          return;
+
+      if (slot.gcrSelectEvt)
+        if (!readAligned(m_parent.m_gcrSelectChain, slot.gcrSelectEvt, m_readGcrSelectEvt, slot, iEvt))
+          return;
+    }
+
+    /// read secondary chain into slot object (at aligned entry if alignment enabled)
+    /// \param readPtr chain's bound branch address
+    /// \return false (& mark slot unreadable) if no matching event
+    template <typename EventType>
+    bool readAligned(TChain &chain,
+                     EventType *evt,
+                     EventType *&readPtr,
+                     Slot &slot,
+                     const UInt_t iEvt) {
+      evt->Clear();
+      readPtr = evt;
+
+      Long64_t entry = iEvt;
+      if (m_parent.m_aligned) {
+        entry = m_parent.alignedEntry(chain, *slot.digiEvt);
+        if (entry < 0) {
+          slot.nBytes = 0;
+          slot.unmatched = true;
+          return false;
+        }
+      }
+
+      slot.nBytes += chain.GetEvent(entry);
+      return true;
+    }
+
+    RootFileAnalysis &m_parent;
+
+    std::vector<Slot> m_slots;
+
+    /// producer stops here
+    const UInt_t m_nEntries;
+
+    /// parent's original event objects, restored on destruction
+    McEvent        *const m_origMcEvt;
+    DigiEvent      *const m_origDigiEvt;
+    ReconEvent     *const m_origReconEvt;
+    GcrSelectEvent *const m_origGcrSelectEvt;
+
+    /// branch addresses bound to chains, point at slot being read
+    /// \note only touched by producer thread after construction
+    McEvent        *m_readMcEvt;
+    DigiEvent      *m_readDigiEvt;
+    ReconEvent     *m_readReconEvt;
+    GcrSelectEvent *m_readGcrSelectEvt;
+
+    /// protects all state below
+    Mutex     m_mutex;
+    /// signalled on any change to ring state
+    Condition m_cond;
+
+    pthread_t m_thread;
+    bool      m_running;
+
+    /// next slot to hand to consumer
+    unsigned  m_consumePos;
+    /// # of decoded slots waiting for consumer
+    unsigned  m_nFilled;
+    /// true if consumer holds slot (m_consumePos - 1)
+    bool      m_holding;
+
+    /// next entry for producer to read
+    UInt_t    m_nextRead;
+    /// next entry consumer is expected to ask for
+    UInt_t    m_expectEntry;
+
+    /// tell producer to quit
+    bool      m_stop;
+    /// producer reached end of input
+    bool      m_producerDone;
+  };
+
   RootFileAnalysis::RootFileAnalysis(const vector<string> *mcFilenames,
                                      const vector<string> *digiFilenames,
                                      const vector<string> *reconFilenames,
                                      const vector<string> *svacFilenames,
                                      const vector<string> *gcrSelectFilenames,
                                      const vector<string> *calTupleFilenames) :
+    m_cachePolicy(s_defaultCachePolicy),
+    m_cacheApplied(false),
     m_mcChain("MC"),
     m_mcEvt(0),
     m_digiChain("Digi"),
@@ -42,7 +387,13 @@ namespace calibGenCAL {
     m_svacChain("Output"),
     m_gcrSelectChain("GcrSelect"),
     m_calTupleChain("CalTuple"),
-    m_gcrSelectEvt(0)
+    m_gcrSelectEvt(0),
+    m_nextEvt(0),
+    m_readAhead(0),
+    m_pendingReadAhead(0),
+    m_aligned(false),
+    m_nUnmatched(0),
+    m_nFailedReads(0)
 
   {
     // add mc file list into mc ROOT chain
@@ -113,6 +464,8 @@ namespace calibGenCAL {
   }
 
   RootFileAnalysis::~RootFileAnalysis() {
+    delete m_readAhead;
+
     if (m_mcEvt) {
       m_mcEvt->Clear();
       delete m_mcEvt;
@@ -134,7 +487,257 @@ namespace calibGenCAL {
     }
   }
 
+  RootFileAnalysis::CachePolicy RootFileAnalysis::s_defaultCachePolicy;
+
+  void RootFileAnalysis::setDefaultCachePolicy(const CachePolicy &policy) {
+    s_defaultCachePolicy = policy;
+  }
+
+  void RootFileAnalysis::setCachePolicy(const CachePolicy &policy) {
+    m_cachePolicy = policy;
+    m_cacheApplied = false;
+  }
+
+  void RootFileAnalysis::applyCachePolicy() {
+    for (int i = 0; i < m_chainArr.GetEntries(); i++)
+      applyCachePolicy(*(TChain *)m_chainArr.At(i));
+
+    m_cacheApplied = true;
+  }
+
+  namespace {
+    /// collect names of all enabled branches in branch list (recursive)
+    void collectEnabledBranches(TChain &chain,
+                                TObjArray &branchList,
+                                vector<string> &names) {
+      for (int i = 0; i < branchList.GetEntriesFast(); i++) {
+        TBranch *const branch = dynamic_cast<TBranch*>(branchList.At(i));
+        if (branch == 0)
+          continue;
+
+        if (chain.GetBranchStatus(branch->GetName()))
+          names.push_back(branch->GetName());
+
+        collectEnabledBranches(chain, *branch->GetListOfBranches(), names);
+      }
+    }
+  }
+
+  void RootFileAnalysis::applyCachePolicy(TChain &chain) {
+    chain.SetCacheSize(m_cachePolicy.cacheSize);
+    if (m_cachePolicy.cacheSize <= 0)
+      return;
+
+    chain.SetCacheLearnEntries(m_cachePolicy.learnEntries);
+
+    // 1st tree must be loaded before branches can be registered w/ its cache.
+    if (chain.LoadTree(0) < 0)
+      return;
+
+    vector<string> branchNames(m_cachePolicy.extraBranches);
+    if (m_cachePolicy.cacheEnabledBranches && chain.GetTree() != 0)
+      collectEnabledBranches(chain, *chain.GetTree()->GetListOfBranches(), branchNames);
+
+    // fall back to learning phase if no branches are known up front
+    if (branchNames.empty()) {
+      LogStrm::get() << "chain " << chain.GetName() << ": " << m_cachePolicy.cacheSize
+                     << " byte TTreeCache, branches learned from 1st "
+                     << m_cachePolicy.learnEntries << " entries" << endl;
+      return;
+    }
+
+    for (unsigned i = 0; i < branchNames.size(); i++)
+      chain.AddBranchToCache(branchNames[i].c_str(), kFALSE);
+
+    // registered branch set is complete, skip learning phase
+    chain.StopCacheLearningPhase();
+
+    LogStrm::get() << "chain " << chain.GetName() << ": " << branchNames.size()
+                   << " branches registered w/ " << m_cachePolicy.cacheSize
+                   << " byte TTreeCache" << endl;
+  }
+
+  bool RootFileAnalysis::isActive(const TChain &chain) const {
+    return m_chainArr.FindObject(&chain) != 0;
+  }
+
+  void RootFileAnalysis::setIndexNames(const TChain &chain,
+                                       const string &runName,
+                                       const string &eventName) {
+    m_indexNames[&chain] = make_pair(runName, eventName);
+  }
+
+  void RootFileAnalysis::enableEventAlignment() {
+    if (!isActive(m_digiChain))
+      throw runtime_error("RootFileAnalysis: event alignment requires digi chain");
+
+    // reference ids are read from DigiEvent
+    m_digiChain.SetBranchStatus("m_runId", 1);
+    m_digiChain.SetBranchStatus("m_eventId", 1);
+
+    // default index expressions
+    const pair<string, string> tupleNames("RunID", "EventID");
+    const pair<string, string> eventNames("m_runId", "m_eventId");
+    if (m_indexNames.find(&m_svacChain) == m_indexNames.end())
+      m_indexNames[&m_svacChain] = tupleNames;
+    if (m_indexNames.find(&m_calTupleChain) == m_indexNames.end())
+      m_indexNames[&m_calTupleChain] = tupleNames;
+    if (m_indexNames.find(&m_mcChain) == m_indexNames.end())
+      m_indexNames[&m_mcChain] = eventNames;
+    if (m_indexNames.find(&m_reconChain) == m_indexNames.end())
+      m_indexNames[&m_reconChain] = eventNames;
+    if (m_indexNames.find(&m_gcrSelectChain) == m_indexNames.end())
+      m_indexNames[&m_gcrSelectChain] = eventNames;
+
+    for (int i = 0; i < m_chainArr.GetEntries(); i++) {
+      TChain &chain = *(TChain *)m_chainArr.At(i);
+      if (&chain == &m_digiChain)
+        continue;
+
+      const pair<string, string> &names = m_indexNames[&chain];
+
+      // index branches must be readable
+      chain.SetBranchStatus(names.first.c_str(), 1);
+      chain.SetBranchStatus(names.second.c_str(), 1);
+
+      LogStrm::get() << "building (" << names.first << ", " << names.second
+                     << ") index for chain: " << chain.GetName() << endl;
+      if (chain.BuildIndex(names.first.c_str(), names.second.c_str()) <= 0)
+        throw runtime_error(string("RootFileAnalysis: unable to build event index for chain: ") +
+                            chain.GetName());
+    }
+
+    m_aligned = true;
+    m_nUnmatched = 0;
+    m_nFailedReads = 0;
+  }
+
+  Long64_t RootFileAnalysis::alignedEntry(TChain &chain,
+                                          const DigiEvent &digiEvt) const {
+    return chain.GetEntryNumberWithIndex((Int_t)digiEvt.getRunId(),
+                                         (Int_t)digiEvt.getEventId());
+  }
+
+  UInt_t RootFileAnalysis::getAlignedEvent(const UInt_t iEvt) {
+    UInt_t nBytes = m_digiChain.GetEvent(iEvt);
+    if (nBytes == 0 || m_digiEvt == 0) {
+      m_nFailedReads++;
+      return 0;
+    }
+
+    for (int i = 0; i < m_chainArr.GetEntries(); i++) {
+      TChain &chain = *(TChain *)m_chainArr.At(i);
+      if (&chain == &m_digiChain)
+        continue;
+
+      const Long64_t entry = alignedEntry(chain, *m_digiEvt);
+      if (entry < 0) {
+        m_nUnmatched++;
+        return 0;
+      }
+
+      nBytes += chain.GetEvent(entry);
+    }
+
+    return nBytes;
+  }
+
+  unsigned RootFileAnalysis::s_defaultReadAhead = 0;
+
+  void RootFileAnalysis::setDefaultReadAhead(const unsigned depth) {
+    s_defaultReadAhead = depth;
+  }
+
+  void RootFileAnalysis::useDefaultReadAhead() {
+    if (m_readAhead == 0)
+      m_pendingReadAhead = s_defaultReadAhead;
+  }
+
+  void RootFileAnalysis::enableReadAhead(const unsigned depth) {
+    m_pendingReadAhead = 0;
+
+    delete m_readAhead;
+    m_readAhead = 0;
+
+    if (depth == 0 || m_chainArr.GetEntries() == 0)
+      return;
+
+    // cache must be configured before producer thread owns the chains
+    if (!m_cacheApplied) {
+      ROOTIOLock ioLock;
+      applyCachePolicy();
+    }
+
+    initROOTThreads();
+    m_readAhead = new ReadAhead(*this, depth);
+  }
+
+  void RootFileAnalysis::disableReadAhead() {
+    if (m_readAhead == 0)
+      return;
+
+    const unsigned depth = m_readAhead->getDepth();
+    enableReadAhead(0);
+    m_pendingReadAhead = depth;
+  }
+
   UInt_t RootFileAnalysis::getEvent(UInt_t iEvt) {
+    // default read ahead is deferred until caller has enabled branches
+    if (m_pendingReadAhead != 0)
+      enableReadAhead(m_pendingReadAhead);
+
+    if (!m_cacheApplied) {
+      ROOTIOLock ioLock;
+      applyCachePolicy();
+    }
+
+    if (m_readAhead) {
+      bool unmatched = false;
+      UInt_t nBytes = m_readAhead->getEvent(iEvt, unmatched);
+
+      m_nextEvt++;
+
+      if (unmatched) {
+        m_nUnmatched++;
+        return 0;
+      }
+
+      // read error or entry past end of input (tuple chains are
+      // aligned to digi event)
+      if (m_aligned && nBytes == 0) {
+        m_nFailedReads++;
+        return 0;
+      }
+
+      // tuple chains are read here in caller's thread
+      ROOTIOLock ioLock;
+      TChain *const tupleChains[] = {&m_svacChain, &m_calTupleChain};
+      for (unsigned i = 0; i < 2; i++) {
+        TChain &chain = *tupleChains[i];
+        if (!isActive(chain))
+          continue;
+
+        Long64_t entry = iEvt;
+        if (m_aligned) {
+          entry = alignedEntry(chain, *m_digiEvt);
+          if (entry < 0) {
+            m_nUnmatched++;
+            return 0;
+          }
+        }
+
+        nBytes += chain.GetEvent(entry);
+      }
+
+      if (nBytes == 0)
+        m_nFailedReads++;
+
+      return nBytes;
+    }
+
+    // read ahead threads of other readers may be running
+    ROOTIOLock ioLock;
+
     // delete any old event data.
     if (m_mcEvt)
       m_mcEvt->Clear();
@@ -148,21 +751,52 @@ namespace calibGenCAL {
     if (m_gcrSelectEvt)
       m_gcrSelectEvt->Clear();
 
+    m_nextEvt++;
+
+    if (m_aligned)
+      return getAlignedEvent(iEvt);
+
     UInt_t nBytes = 0;
     // if using chains, check the array of chains and move
     // the event pointer to the Req event
     for (int i = 0; i < m_chainArr.GetEntries(); i++)
       nBytes += ((TChain *)m_chainArr.At(i))->GetEvent(iEvt);
 
-    m_nextEvt++;
+    if (nBytes == 0)
+      m_nFailedReads++;
+
     return nBytes;
   }
 
+  vector<RootFileAnalysis::EntryRange> RootFileAnalysis::partitionEntries(const UInt_t nEntries,
+                                                                          const unsigned nParts) {
+    vector<EntryRange> retVal;
+    if (nParts == 0)
+      return retVal;
+
+    // 1st (nEntries % nParts) ranges get 1 extra entry
+    const UInt_t partSize  = nEntries / nParts;
+    const UInt_t remainder = nEntries % nParts;
+
+    UInt_t begin = 0;
+    for (unsigned i = 0; i < nParts; i++) {
+      const UInt_t end = begin + partSize + ((i < remainder) ? 1 : 0);
+      retVal.push_back(EntryRange(begin, end));
+      begin = end;
+    }
+
+    return retVal;
+  }
+
   UInt_t RootFileAnalysis::getEntries() const {
     // Purpose and Method:  Determine the number of events to iterate over
     //   checking to be sure that the Req number of events is less than
     //   the min number of events in all files
 
+    // all other chains are looked up by index
+    if (m_aligned)
+      return (UInt_t)m_digiChain.GetEntries();
+
     UInt_t nEntries = 0;
 
     nEntries = (int)(((TChain *)m_chainArr.At(0))->GetEntries());
@@ -16,6 +16,8 @@
 // STD INCLUDES
 #include <iostream>
 #include <vector>
+#include <string>
+#include <map>
 
 class McEvent;
 class DigiEvent;
@@ -62,14 +64,136 @@ namespace calibGenCAL {
 
     ~RootFileAnalysis();
 
+    /// half open range [begin, end) of chain entry numbers
+    struct EntryRange {
+      EntryRange(const UInt_t first = 0,
+                 const UInt_t last = 0) :
+        begin(first),
+        end(last)
+      {}
+
+      UInt_t size() const {
+        return (end > begin) ? end - begin : 0;
+      }
+
+      UInt_t begin;
+      UInt_t end;
+    };
+
+    /// split [0, nEntries) into nParts contiguous, non-overlapping ranges
+    /// of (nearly) equal size.  ranges are returned in entry order.
+    static std::vector<EntryRange> partitionEntries(const UInt_t nEntries,
+                                                    const unsigned nParts);
+
+    /// TTreeCache settings applied to every active chain
+    struct CachePolicy {
+      CachePolicy(const Long64_t size = 30*1024*1024,
+                  const Int_t nLearnEntries = 100,
+                  const bool cacheEnabled = true) :
+        cacheSize(size),
+        learnEntries(nLearnEntries),
+        cacheEnabledBranches(cacheEnabled)
+      {}
+
+      /// TTreeCache size in bytes (0 disables cache)
+      Long64_t cacheSize;
+
+      /// # of entries in cache learning phase (only used if no
+      /// branches are registered explicitly)
+      Int_t learnEntries;
+
+      /// if true, register all branches enabled w/ SetBranchStatus()
+      /// w/ the cache (skips learning phase)
+      bool cacheEnabledBranches;
+
+      /// additional branch names to register w/ cache (all chains)
+      std::vector<std::string> extraBranches;
+    };
+
+    /// set cache policy for all chains, policy is applied on first
+    /// getEvent() call (after caller has enabled branches)
+    void setCachePolicy(const CachePolicy &policy);
+
+    /// cache policy used by all subsequently created RootFileAnalysis objects
+    static void setDefaultCachePolicy(const CachePolicy &policy);
+
+    /// match events across chains by (run, event) id rather than entry number.
+    ///
+    /// digi chain is the reference: getEvent(iEvt) reads digi entry iEvt,
+    /// then reads the entry of each other active chain whose index
+    /// (see setIndexNames()) matches the digi event's (run, event) ids.
+    /// getEvent() returns 0 if any chain has no matching event, so chains
+    /// w/ dropped or extra events no longer need to be re-skimmed.
+    /// \note index is built w/ TChain::BuildIndex() (one pass over index branches)
+    /// \note call after all SetBranchStatus() calls & before enableReadAhead()
+    /// \throws std::runtime_error if digi chain is not active or index cannot be built
+    void enableEventAlignment();
+
+    /// override (run, event) index expressions used to align given chain.
+    /// defaults are "RunID"/"EventID" for svac & calTuple chains and
+    /// "m_runId"/"m_eventId" for event object chains.
+    void setIndexNames(const TChain &chain,
+                       const std::string &runName,
+                       const std::string &eventName);
+
+    /// # of events skipped because they could not be matched in all chains
+    unsigned getNUnmatched() const {
+      return m_nUnmatched;
+    }
+
+    /// # of getEvent() calls which read no event data (read error or
+    /// entry past end of input), not incl. getNUnmatched()
+    unsigned getNFailedReads() const {
+      return m_nFailedReads;
+    }
+
     /// returns total number of events in all open files
+    /// \note in alignment mode, returns # of events in digi chain
     UInt_t getEntries() const;
 
     /// Retrieve pointers to given event #.
     /// \note events are numbered by position in root chain, not
     /// by EventID field
+    /// \note all chain reads are done under ROOTIOLock, so several
+    /// readers may be used from different threads.
     UInt_t getEvent(UInt_t iEvt);
 
+    /// decode up to depth events ahead of the current one in a
+    /// background thread.  (depth = 0 disables read ahead)
+    ///
+    /// event objects (mc, digi, recon, gcrSelect) are read into a ring of
+    /// preallocated objects while caller processes the current event.
+    /// \note call after all SetBranchStatus() calls.
+    /// \note overrides setDefaultReadAhead() for this object
+    /// \note producer thread changes gDirectory (under ROOTIOLock) when it
+    /// opens the next file in a chain.  while read ahead runs, caller
+    /// must not make any ROOT call which uses gDirectory (histogram or
+    /// function creation, Fit(), TFile::cd() ...) outside ROOTIOLock.
+    /// HistVec & HistMap create histograms under ROOTIOLock.
+    /// see disableReadAhead() for fits between event loops.
+    /// \note tuple chains (svac, calTuple) are still read in getEvent()
+    /// as their branch buffers belong to the caller.
+    /// \note pointers returned by getXXXEvent() are valid until next getEvent() call
+    /// \note out of sequence getEvent() calls are supported, but restart the read ahead.
+    void enableReadAhead(const unsigned depth);
+
+    /// stop & join read ahead thread (if any), e.g. before fork().
+    /// read ahead w/ same depth restarts on next getEvent() call.
+    /// \note event pointers from getXXXEvent() are invalid afterwards
+    void disableReadAhead();
+
+    /// read ahead depth for readers which opt in w/
+    /// useDefaultReadAhead() (default 0 = disabled), e.g. from
+    /// command line.
+    static void setDefaultReadAhead(const unsigned depth);
+
+    /// opt in to setDefaultReadAhead() depth.  read ahead is started on
+    /// first getEvent() call (after caller has enabled branches)
+    /// \note only for event loops audited to follow enableReadAhead()
+    /// rules, other readers never read ahead unless enableReadAhead() is
+    /// called explicitly.
+    void useDefaultReadAhead();
+
     const McEvent   *getMcEvent() const {
       return m_mcEvt;
     }
@@ -111,6 +235,34 @@ namespace calibGenCAL {
     }
 
   private:
+    /// background event reader (see enableReadAhead())
+    class ReadAhead;
+
+    /// return entry in given chain which matches (run, event) of current
+    /// digi event, -1 if none.
+    Long64_t alignedEntry(TChain &chain,
+                          const DigiEvent &digiEvt) const;
+
+    /// read event objects for entry iEvt in alignment mode
+    UInt_t getAlignedEvent(const UInt_t iEvt);
+
+    /// true if chain is in active chain list
+    bool isActive(const TChain &chain) const;
+
+    /// apply m_cachePolicy to all active chains
+    void applyCachePolicy();
+
+    /// apply cache policy to single chain
+    void applyCachePolicy(TChain &chain);
+
+    /// default for new objects
+    static CachePolicy s_defaultCachePolicy;
+
+    /// current cache settings
+    CachePolicy      m_cachePolicy;
+
+    /// true once m_cachePolicy has been applied to chains
+    bool             m_cacheApplied;
 
     /// helpful list of all TChains
     TObjArray        m_chainArr;
@@ -145,6 +297,28 @@ namespace calibGenCAL {
 
     /// current event number
     unsigned         m_nextEvt;
+
+    /// non-NULL if read ahead is enabled
+    ReadAhead       *m_readAhead;
+
+    /// default for new objects
+    static unsigned  s_defaultReadAhead;
+
+    /// read ahead depth to enable on first getEvent() call (0 = none)
+    unsigned         m_pendingReadAhead;
+
+    /// true if chains are aligned by (run, event) index
+    bool             m_aligned;
+
+    /// (run, event) index expression pair per chain
+    typedef std::map<const TChain*, std::pair<std::string, std::string> > IndexNameMap;
+    IndexNameMap     m_indexNames;
+
+    /// # of events dropped in alignment mode
+    unsigned         m_nUnmatched;
+
+    /// # of getEvent() calls which read no data
+    unsigned         m_nFailedReads;
   };
 
 }; // namespace calibGenCAL
@@ -0,0 +1,114 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "ShardedEventLoop.h"
+#include "ProcessUtil.h"
+#include "CGCUtil.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <ostream>
+#include <memory>
+
+namespace calibGenCAL {
+
+  using namespace std;
+
+  namespace {
+    /// process single shard in worker process
+    class ShardTask : public ProcessTask {
+    public:
+      ShardTask(EventShard &shard,
+                const ShardedEventLoop &eventLoop,
+                const RootFileAnalysis::EntryRange &range) :
+        m_shard(shard),
+        m_eventLoop(eventLoop),
+        m_range(range)
+      {}
+
+      void run(string &result) {
+        // private reader, opened in worker so that no file handles
+        // are shared w/ other workers
+        auto_ptr<RootFileAnalysis> rootFile(m_eventLoop.newReader());
+        m_shard.cfgBranches(*rootFile);
+        m_shard.processRange(*rootFile, m_range);
+        m_shard.packResult(result);
+      }
+
+      void setResult(const string &result) {
+        m_shard.unpackResult(result);
+      }
+
+    private:
+      EventShard &m_shard;
+      const ShardedEventLoop &m_eventLoop;
+      const RootFileAnalysis::EntryRange m_range;
+    };
+  }
+
+  ShardedEventLoop::ShardedEventLoop(const vector<string> *mcFilenames,
+                                     const vector<string> *digiFilenames,
+                                     const vector<string> *reconFilenames,
+                                     const vector<string> *svacFilenames,
+                                     const vector<string> *gcrSelectFilenames,
+                                     const vector<string> *calTupleFilenames) :
+    m_mcFiles(mcFilenames),
+    m_digiFiles(digiFilenames),
+    m_reconFiles(reconFilenames),
+    m_svacFiles(svacFilenames),
+    m_gcrSelectFiles(gcrSelectFilenames),
+    m_calTupleFiles(calTupleFilenames)
+  {
+  }
+
+  RootFileAnalysis *ShardedEventLoop::newReader() const {
+    return new RootFileAnalysis(m_mcFiles.get(),
+                                m_digiFiles.get(),
+                                m_reconFiles.get(),
+                                m_svacFiles.get(),
+                                m_gcrSelectFiles.get(),
+                                m_calTupleFiles.get());
+  }
+
+  vector<RootFileAnalysis::EntryRange> ShardedEventLoop::run(const vector<EventShard*> &shards) {
+    if (shards.empty())
+      return vector<RootFileAnalysis::EntryRange>();
+
+    // reader is closed again before workers are started
+    UInt_t nEvents = 0;
+    {
+      auto_ptr<RootFileAnalysis> rootFile(newReader());
+      nEvents = rootFile->getEntries();
+    }
+
+    const vector<RootFileAnalysis::EntryRange> ranges(RootFileAnalysis::partitionEntries(nEvents,
+                                                                                          shards.size()));
+
+    LogStrm::get() << __FILE__ << ": Processing: " << nEvents << " events in "
+                   << shards.size() << " worker processes." << endl;
+
+    vector<ProcessTask*> tasks;
+    for (unsigned i = 0; i < shards.size(); i++)
+      tasks.push_back(new ShardTask(*shards[i], *this, ranges[i]));
+
+    try {
+      runProcessTasks(tasks, shards.size());
+    } catch (...) {
+      for (unsigned i = 0; i < tasks.size(); i++)
+        delete tasks[i];
+      throw;
+    }
+
+    for (unsigned i = 0; i < tasks.size(); i++)
+      delete tasks[i];
+
+    return ranges;
+  }
+
+}; // namespace calibGenCAL
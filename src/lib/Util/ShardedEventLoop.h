@@ -0,0 +1,111 @@
+#ifndef ShardedEventLoop_h
+#define ShardedEventLoop_h
+
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "RootFileAnalysis.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <string>
+#include <vector>
+
+namespace calibGenCAL {
+
+  /** \brief one worker's share of a ShardedEventLoop
+
+  cfgBranches(), processRange() & packResult() run in a fork()ed worker
+  process, so all state they modify is lost except for the packed
+  result, which is handed to unpackResult() in the calling process.
+  */
+  class EventShard {
+  public:
+    virtual ~EventShard() {}
+
+    /// enable required branches on this shard's private reader.
+    /// \note called in worker process
+    virtual void cfgBranches(RootFileAnalysis &rootFile) = 0;
+
+    /// process entries in given range w/ private reader
+    /// \note called in worker process
+    virtual void processRange(RootFileAnalysis &rootFile,
+                              const RootFileAnalysis::EntryRange &range) = 0;
+
+    /// pack results (histogram shards, counters, log...) after processRange()
+    /// \note called in worker process, see ProcessUtil.h for pack helpers
+    virtual void packResult(std::string &result) const = 0;
+
+    /// load results written by packResult()
+    /// \note called in calling process, in shard order
+    virtual void unpackResult(const std::string &result) = 0;
+  };
+
+  /** \brief run N independent readers over disjoint entry ranges of the same input files
+
+  1) [0, nEntries) is split into one contiguous range per shard, in shard order
+  2) each shard runs in its own fork()ed worker process (see
+  runProcessTasks()) which opens a private RootFileAnalysis reader &
+  processes its range
+  3) results are unpacked in calling process in shard order
+
+  \note ROOT 5 I/O is not thread safe, worker processes read
+  concurrently w/out any locking.
+  \note no other threads may be running (see RootFileAnalysis::disableReadAhead())
+  */
+  class ShardedEventLoop {
+  public:
+    /// same input file lists as RootFileAnalysis ctor (NULL disables chain)
+    ShardedEventLoop(const std::vector<std::string> *mcFilenames = 0,
+                     const std::vector<std::string> *digiFilenames = 0,
+                     const std::vector<std::string> *reconFilenames = 0,
+                     const std::vector<std::string> *svacFilenames = 0,
+                     const std::vector<std::string> *gcrSelectFilenames = 0,
+                     const std::vector<std::string> *calTupleFilenames = 0);
+
+    /// process all events in input files, shards[i] receives i'th entry range
+    /// \return entry ranges, shards[i] processed (part of) ranges[i]
+    std::vector<RootFileAnalysis::EntryRange> run(const std::vector<EventShard*> &shards);
+
+    /// open new reader on same input files (e.g. to process
+    /// remainder of entry range in calling process)
+    /// \note caller owns returned object
+    RootFileAnalysis *newReader() const;
+
+  private:
+    /// one optional file list per RootFileAnalysis chain
+    class FileList {
+    public:
+      explicit FileList(const std::vector<std::string> *filenames) :
+        enabled(filenames != 0)
+      {
+        if (filenames)
+          files = *filenames;
+      }
+
+      /// return ptr suitable for RootFileAnalysis ctor
+      const std::vector<std::string> *get() const {
+        return enabled ? &files : 0;
+      }
+
+      bool enabled;
+      std::vector<std::string> files;
+    };
+
+    FileList m_mcFiles;
+    FileList m_digiFiles;
+    FileList m_reconFiles;
+    FileList m_svacFiles;
+    FileList m_gcrSelectFiles;
+    FileList m_calTupleFiles;
+  };
+
+}; // namespace calibGenCAL
+
+#endif
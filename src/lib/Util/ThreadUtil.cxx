@@ -0,0 +1,191 @@
+// $Header: $
+
+/** @file
+*/
+
+// LOCAL INCLUDES
+#include "ThreadUtil.h"
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+#include "RVersion.h"
+#include "TDirectory.h"
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,5,2)
+#include "TROOT.h"
+#else
+#include "TThread.h"
+#endif
+
+// STD INCLUDES
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <sstream>
+
+namespace calibGenCAL {
+
+  using namespace std;
+
+  void initROOTThreads() {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,5,2)
+    ROOT::EnableThreadSafety();
+#else
+    TThread::Initialize();
+#endif
+  }
+
+  Mutex::Mutex() {
+    if (pthread_mutex_init(&m_mutex, 0) != 0)
+      throw runtime_error("Mutex: pthread_mutex_init() failed");
+  }
+
+  Mutex::~Mutex() {
+    pthread_mutex_destroy(&m_mutex);
+  }
+
+  void Mutex::lock() {
+    pthread_mutex_lock(&m_mutex);
+  }
+
+  void Mutex::unlock() {
+    pthread_mutex_unlock(&m_mutex);
+  }
+
+  namespace {
+    /// see rootIOMutex()
+    Mutex s_rootIOMutex;
+  }
+
+  Mutex &rootIOMutex() {
+    return s_rootIOMutex;
+  }
+
+  ROOTIOLock::ROOTIOLock() :
+    m_lock(rootIOMutex()),
+    m_dir(gDirectory)
+  {
+  }
+
+  ROOTIOLock::~ROOTIOLock() {
+    gDirectory = m_dir;
+  }
+
+  Condition::Condition() {
+    if (pthread_cond_init(&m_cond, 0) != 0)
+      throw runtime_error("Condition: pthread_cond_init() failed");
+  }
+
+  Condition::~Condition() {
+    pthread_cond_destroy(&m_cond);
+  }
+
+  void Condition::wait(Mutex &mutex) {
+    pthread_cond_wait(&m_cond, &mutex.m_mutex);
+  }
+
+  void Condition::signal() {
+    pthread_cond_signal(&m_cond);
+  }
+
+  void Condition::broadcast() {
+    pthread_cond_broadcast(&m_cond);
+  }
+
+  namespace {
+    /// shared state for all threads in one runWorkerTasks() call
+    class TaskQueue {
+    public:
+      explicit TaskQueue(const vector<WorkerTask*> &tasks) :
+        m_tasks(tasks),
+        m_next(0),
+        m_errors(tasks.size())
+      {}
+
+      /// retrieve index of next task to run
+      /// \return false when all tasks have been dispatched
+      bool nextTask(unsigned &taskIdx) {
+        MutexLock lock(m_mutex);
+        if (m_next >= m_tasks.size())
+          return false;
+
+        taskIdx = m_next++;
+        return true;
+      }
+
+      /// run single task, capture any error message
+      void runTask(const unsigned taskIdx) {
+        try {
+          m_tasks[taskIdx]->run();
+        } catch (exception &e) {
+          m_errors[taskIdx] = string(e.what()) + " ";
+        } catch (...) {
+          m_errors[taskIdx] = "unknown exception ";
+        }
+      }
+
+      /// rethrow error from lowest numbered failed task (if any)
+      void checkErrors() const {
+        for (unsigned i = 0; i < m_errors.size(); i++)
+          if (!m_errors[i].empty()) {
+            ostringstream tmp;
+            tmp << "worker task #" << i << " failed: " << m_errors[i];
+            throw runtime_error(tmp.str());
+          }
+      }
+
+    private:
+      const vector<WorkerTask*> &m_tasks;
+
+      Mutex m_mutex;
+
+      /// index of next task to dispatch
+      unsigned m_next;
+
+      /// one error string per task (empty on success)
+      vector<string> m_errors;
+    };
+
+    /// pthread entry point, pull tasks from queue until none remain
+    void *workerThreadMain(void *arg) {
+      TaskQueue &queue = *static_cast<TaskQueue*>(arg);
+
+      unsigned taskIdx;
+      while (queue.nextTask(taskIdx))
+        queue.runTask(taskIdx);
+
+      return 0;
+    }
+  }
+
+  void runWorkerTasks(const vector<WorkerTask*> &tasks,
+                      const unsigned nThreads) {
+    TaskQueue queue(tasks);
+
+    const unsigned nWorkers = min<unsigned>(nThreads, tasks.size());
+    if (nWorkers <= 1) {
+      workerThreadMain(&queue);
+      queue.checkErrors();
+      return;
+    }
+
+    vector<pthread_t> threads;
+    for (unsigned i = 0; i < nWorkers; i++) {
+      pthread_t thread;
+      // on failure just run w/ the threads we have
+      if (pthread_create(&thread, 0, workerThreadMain, &queue) != 0)
+        break;
+      threads.push_back(thread);
+    }
+
+    // no threads could be started, run in this thread
+    if (threads.empty())
+      workerThreadMain(&queue);
+
+    for (unsigned i = 0; i < threads.size(); i++)
+      pthread_join(threads[i], 0);
+
+    queue.checkErrors();
+  }
+
+}; // namespace calibGenCAL
@@ -0,0 +1,137 @@
+#ifndef ThreadUtil_h
+#define ThreadUtil_h
+
+// $Header: $
+
+/** @file
+    @brief minimal POSIX thread helpers (mutex, condition, worker pool)
+    for running independent units of work concurrently.
+*/
+
+// LOCAL INCLUDES
+
+// GLAST INCLUDES
+
+// EXTLIB INCLUDES
+
+// STD INCLUDES
+#include <pthread.h>
+#include <vector>
+
+class TDirectory;
+
+namespace calibGenCAL {
+
+  /// enable ROOT internal locking.
+  /// \note must be called from main thread before any worker threads
+  /// touch ROOT I/O.  safe to call more than once.
+  void initROOTThreads();
+
+  /// thin wrapper around pthread_mutex_t
+  class Mutex {
+  public:
+    Mutex();
+    ~Mutex();
+
+    void lock();
+    void unlock();
+
+  private:
+    friend class Condition;
+
+    pthread_mutex_t m_mutex;
+
+    /// disabled
+    Mutex(const Mutex &);
+    /// disabled
+    Mutex &operator=(const Mutex &);
+  };
+
+  /// lock given mutex for lifetime of this object
+  class MutexLock {
+  public:
+    explicit MutexLock(Mutex &mutex) :
+      m_mutex(mutex)
+    {
+      m_mutex.lock();
+    }
+
+    ~MutexLock() {
+      m_mutex.unlock();
+    }
+
+  private:
+    Mutex &m_mutex;
+
+    /// disabled
+    MutexLock(const MutexLock &);
+    /// disabled
+    MutexLock &operator=(const MutexLock &);
+  };
+
+  /// process wide lock for ROOT I/O (TFile / TTree reads, histogram
+  /// creation & anything else which uses gDirectory).
+  /// \note ROOT 5 I/O is not thread safe even after initROOTThreads(),
+  /// worker threads must hold this lock (via ROOTIOLock) for all such calls.
+  Mutex &rootIOMutex();
+
+  /// hold rootIOMutex() for lifetime of this object & restore
+  /// gDirectory to its value on entry
+  class ROOTIOLock {
+  public:
+    ROOTIOLock();
+    ~ROOTIOLock();
+
+  private:
+    MutexLock m_lock;
+
+    /// gDirectory on entry
+    TDirectory *const m_dir;
+
+    /// disabled
+    ROOTIOLock(const ROOTIOLock &);
+    /// disabled
+    ROOTIOLock &operator=(const ROOTIOLock &);
+  };
+
+  /// thin wrapper around pthread_cond_t
+  class Condition {
+  public:
+    Condition();
+    ~Condition();
+
+    /// \note caller must hold mutex
+    void wait(Mutex &mutex);
+    void signal();
+    void broadcast();
+
+  private:
+    pthread_cond_t m_cond;
+
+    /// disabled
+    Condition(const Condition &);
+    /// disabled
+    Condition &operator=(const Condition &);
+  };
+
+  /// single unit of work for runWorkerTasks()
+  class WorkerTask {
+  public:
+    virtual ~WorkerTask() {}
+
+    /// \note exceptions thrown here are captured & rethrown by runWorkerTasks()
+    virtual void run() = 0;
+  };
+
+  /// run all tasks on up to nThreads concurrent threads, return when all are finished.
+  ///
+  /// tasks are dispatched in list order.  if any task throws, the
+  /// remaining tasks still run & the error from the lowest numbered
+  /// failed task is rethrown as std::runtime_error.
+  /// \note nThreads <= 1 runs all tasks sequentially in calling thread.
+  void runWorkerTasks(const std::vector<WorkerTask*> &tasks,
+                      const unsigned nThreads);
+
+}; // namespace calibGenCAL
+
+#endif
@@ -7,16 +7,17 @@
 // LOCAL INCLUDES
 #include "TwrHodoscope.h"
 #include "stl_util.h"
+#include "BitUtil.h"
+#include "src/lib/CalibDataTypes/CIDAC2ADCTable.h"
 
 // GLAST INCLUDES
 #include "digiRootData/CalDigi.h"
 #include "CalUtil/SimpleCalCalib/CalPed.h"
-#include "CalUtil/SimpleCalCalib/CIDAC2ADC.h"
 
 // EXTLIB INCLUDES
 
 // STD INCLUDES
-#include <functional>
+#include <algorithm>
 #include <ostream>
 
 namespace calibGenCAL {
@@ -24,17 +25,26 @@ namespace calibGenCAL {
 
 
   void TwrHodoscope::clear() {
-    // zero out all vectors
-    fill_zero(adc_ped);
-    fill_zero(dac);
-    fill_zero(perLyrX);
-    fill_zero(perLyrY);
-    fill_zero(perColX);
-    fill_zero(perColY);
-
-    // empty hit lists
-    hitListX.clear();
-    hitListY.clear();
+    // zero out diode values only for xtals touched since last clear()
+    for (unsigned i = 0; i < m_dirtyXtals.size(); i++)
+      for (XtalDiode xDiode; xDiode.isValid(); xDiode++) {
+        const tDiodeIdx diodeIdx(m_dirtyXtals[i], xDiode);
+        adc_ped[diodeIdx] = 0;
+        dac[diodeIdx]     = 0;
+      }
+    m_dirtyXtals.clear();
+
+    // hit histograms & lists are only filled by xtals which pass hit cut
+    if (count) {
+      fill_zero(perLyrX);
+      fill_zero(perLyrY);
+      fill_zero(perColX);
+      fill_zero(perColY);
+
+      // empty hit lists
+      hitListX.clear();
+      hitListY.clear();
+    }
 
     // zero out primitives
     count      = 0;
@@ -47,6 +57,11 @@ namespace calibGenCAL {
     maxPerLyrY = 0;
     firstColX  = 0;
     firstColY  = 0;
+
+    lyrMaskX   = 0;
+    lyrMaskY   = 0;
+    colMaskX   = 0;
+    colMaskY   = 0;
   }
 
   void TwrHodoscope::addHit(const CalDigi &calDigi) {
@@ -59,6 +74,9 @@ namespace calibGenCAL {
 
     const XtalIdx xtalIdx(id);
 
+    // any diode value below may be set, even if hit is rejected
+    m_dirtyXtals.push_back(xtalIdx.getTXtalIdx());
+
     // now trying to work w/ 1 range data, just don't fill all hists
     //   // check that we are in 4-range readout mode
     //   unsigned nRO = calDigi.getNumReadouts();
@@ -115,14 +133,18 @@ namespace calibGenCAL {
     if (lyr.getDir() == X_DIR) {
       // X layer
       GCRCNum gcrc = lyr.getGCRC();
-      perLyrX[gcrc]++;
+      maxPerLyrX = max<unsigned short>(maxPerLyrX, ++perLyrX[gcrc]);
       perColX[col]++;
+      lyrMaskX |= bitMask(gcrc.val());
+      colMaskX |= bitMask(col.val());
       hitListX.push_back(xtalIdx);
     } else {
       // y layer
       GCRCNum gcrc = lyr.getGCRC();
-      perLyrY[gcrc]++;
+      maxPerLyrY = max<unsigned short>(maxPerLyrY, ++perLyrY[gcrc]);
       perColY[col]++;
+      lyrMaskY |= bitMask(gcrc.val());
+      colMaskY |= bitMask(col.val());
       hitListY.push_back(xtalIdx);
     }
   }
@@ -131,32 +153,21 @@ namespace calibGenCAL {
     // we're done if there were no hits
     if (count) {
       // POST-PROCESS: after we have registered all hits, summarize them all
-      // find highest hits per layer
-      maxPerLyrX = *(max_element(perLyrX.begin(),
-                                 perLyrX.end()));
-      maxPerLyrY = *(max_element(perLyrY.begin(),
-                                 perLyrY.end()));
+      // max hits per layer in each direction is kept up to date by addHit()
       maxPerLyr  = max(maxPerLyrX, maxPerLyrY);
 
       // count all layers w/ count > 0
-      nLyrsX     = count_if(perLyrX.begin(), perLyrX.end(),
-                            bind2nd(greater < unsigned short > (), 0));
-      nLyrsY     = count_if(perLyrY.begin(), perLyrY.end(),
-                            bind2nd(greater < unsigned short > (), 0));
+      nLyrsX     = popCount(lyrMaskX);
+      nLyrsY     = popCount(lyrMaskY);
 
       // count all cols w/ count > 0
-      nColsX     = count_if(perColX.begin(), perColX.end(),
-                            bind2nd(greater < unsigned short > (), 0));
-      nColsY     = count_if(perColY.begin(), perColY.end(),
-                            bind2nd(greater < unsigned short > (), 0));
+      nColsX     = popCount(colMaskX);
+      nColsY     = popCount(colMaskY);
 
       // find 1st col hit in each direction (will be only col hit if evt is good)
-      // find_if returns iterator to 1st true element...
-      // ...subtract begin() iterator to get distance or index
-      firstColX = find_if(perColX.begin(), perColX.end(),
-                          bind2nd(greater < unsigned short > (), 0)) - perColX.begin();
-      firstColY = find_if(perColY.begin(), perColY.end(),
-                          bind2nd(greater < unsigned short > (), 0)) - perColY.begin();
+      // ColNum::N_VALS if no col hit in given direction
+      firstColX  = lowestBit(colMaskX, ColNum::N_VALS);
+      firstColY  = lowestBit(colMaskY, ColNum::N_VALS);
     }
   }
 
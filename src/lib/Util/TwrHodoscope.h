@@ -14,6 +14,7 @@
 #include "CalUtil/CalVec.h"
 
 // EXTLIB INCLUDES
+#include "Rtypes.h"
 
 // STD INCLUDES
 #include <vector>
@@ -22,11 +23,12 @@ class CalDigi;
 
 namespace CalUtil {
   class CalPed;
-  class CIDAC2ADC;
 }
 
 namespace calibGenCAL {
 
+  class CIDAC2ADCTable;
+
 
   /** \brief Accumulate crystal hits in single tower and summarize into
       information which can be used for track determination.
@@ -36,14 +38,17 @@ namespace calibGenCAL {
   public:
     /// default ctor
     TwrHodoscope(const CalUtil::CalPed &ped,
-                 const CalUtil::CIDAC2ADC &cidac2adc) :
+                 const CIDAC2ADCTable &cidac2adc) :
+      count(0),
       m_peds(ped),
       m_cidac2adc(cidac2adc)
     {
+      m_dirtyXtals.reserve(CalUtil::tXtalIdx::N_VALS);
       clear();
     }
 
     /// 'zero-out' all members
+    /// \note only visits xtals passed to addHit() since last clear()
     void clear();
 
     /// add new xtal hit to event summary data
@@ -96,14 +101,28 @@ namespace calibGenCAL {
     /// fisrt hit Y col (will be only hit col in good Y track)
     unsigned short firstColY;
 
+    // Hit occupancy masks (bit n set if perLyr / perCol [n] > 0)
+    /// hit X layers
+    ULong64_t lyrMaskX;
+    /// hit Y layers
+    ULong64_t lyrMaskY;
+    /// hit X columns
+    ULong64_t colMaskX;
+    /// hit Y columns
+    ULong64_t colMaskY;
+
     /// reference to pedestal calibrations needed for some operations
     const CalUtil::CalPed &m_peds;
 
-    /// reference to cidac2adc calibs needed for some ops
-    const CalUtil::CIDAC2ADC &m_cidac2adc;
+    /// reference to (tabulated) cidac2adc calibs needed for some ops
+    const CIDAC2ADCTable &m_cidac2adc;
 
     /// threshold (LEX8 ADCP + ADCN) for couniting a 'hit' xtal
     static const unsigned short hitThresh = 100;
+
+  private:
+    /// xtals w/ possibly non-zero adc_ped / dac values
+    std::vector<CalUtil::tXtalIdx> m_dirtyXtals;
   };
 
 }; // namespace calibGenCAL
@@ -0,0 +1,236 @@
+// $Header: $
+
+/** @file
+    unit tests for histogram-free fit shortcuts: closed form pedestal
+    estimate (PedHists::fitHists() w/ fastFit) vs Minuit 'gaus' fit and
+    ChannelSampleBuf / clippedMeanRMS() vs clipped TH1 moments.
+*/
+
+// LOCAL INCLUDES
+#include "src/lib/Hists/PedHists.h"
+#include "src/lib/Util/ChannelSampleBuf.h"
+
+// GLAST INCLUDES
+#include "CalUtil/CalDefs.h"
+#include "CalUtil/SimpleCalCalib/CalPed.h"
+
+// EXTLIB INCLUDES
+#include "TH1S.h"
+#include "TF1.h"
+#include "TRandom3.h"
+
+// STD INCLUDES
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+using namespace calibGenCAL;
+using namespace CalUtil;
+
+#define TEST_ASSERT(str, test) if (!(test)) retVal = false, \
+                                    cout << "TESTFAIL! " __FILE__ \
+                                    << ":" << __LINE__ << " "<< str << endl;
+
+namespace {
+  /// generated pedestal peak
+  const double PED_MEAN  = 512.3;
+  const double PED_SIGMA = 4.7;
+  const unsigned N_PED_ENTRIES = 100000;
+
+  /// integer adc sample from gaussian
+  double gausADC(TRandom3 &rand,
+                 const double mean,
+                 const double sigma) {
+    return floor(rand.Gaus(mean, sigma) + 0.5);
+  }
+
+  /// fill same generated samples into fast & Minuit collections
+  void fillPeds(PedHists &fastHists,
+                PedHists &minuitHists,
+                const RngIdx &rngIdx,
+                const bool flat) {
+    TRandom3 rand(4357);
+    for (unsigned n = 0; n < N_PED_ENTRIES; n++) {
+      const double adc = flat ?
+        floor(rand.Uniform(PED_MEAN - 50, PED_MEAN + 50)) :
+        gausADC(rand, PED_MEAN, PED_SIGMA);
+      fastHists.fill(rngIdx, adc);
+      minuitHists.fill(rngIdx, adc);
+    }
+  }
+
+  /// closed form estimate used instead of Minuit (no fit ndf recorded)
+  bool usedFastFit(PedHists &hists,
+                   const RngIdx &rngIdx) {
+    const TF1 *const gaus = hists.getHist(rngIdx)->GetFunction("gaus");
+    return gaus != 0 && gaus->GetNDF() == 0;
+  }
+
+  /// closed form estimate agrees w/ Minuit fit on gaussian peak
+  bool test_estimateGaus() {
+    bool retVal = true;
+
+    const RngIdx rngIdx;
+    PedHists fastHists;
+    PedHists minuitHists;
+    fastHists.detachHists();
+    minuitHists.detachHists();
+    fillPeds(fastHists, minuitHists, rngIdx, false);
+
+    CalPed fastPed;
+    CalPed minuitPed;
+    fastHists.fitHists(fastPed, 1, true);
+    minuitHists.fitHists(minuitPed, 1, false);
+
+    TEST_ASSERT("gaussian peak passes closed form quality check",
+                usedFastFit(fastHists, rngIdx));
+    TEST_ASSERT("Minuit path records fit",
+                !usedFastFit(minuitHists, rngIdx));
+
+    const float fastMean = fastPed.getPed(rngIdx);
+    const float fastSig  = fastPed.getPedSig(rngIdx);
+    const float fitMean  = minuitPed.getPed(rngIdx);
+    const float fitSig   = minuitPed.getPedSig(rngIdx);
+
+    // statistical error on mean ~ sigma/sqrt(N) ~ 0.015 adc
+    TEST_ASSERT("fast mean matches Minuit",
+                fabs(fastMean - fitMean) < 0.05);
+    TEST_ASSERT("fast sigma matches Minuit",
+                fabs(fastSig/fitSig - 1) < 0.02);
+    TEST_ASSERT("fast mean matches generated",
+                fabs(fastMean - PED_MEAN) < 0.1);
+    TEST_ASSERT("fast sigma matches generated",
+                fabs(fastSig/PED_SIGMA - 1) < 0.03);
+
+    fastHists.deleteHists();
+    minuitHists.deleteHists();
+    return retVal;
+  }
+
+  /// non gaussian peak falls back to Minuit
+  bool test_estimateGausReject() {
+    bool retVal = true;
+
+    const RngIdx rngIdx;
+    PedHists fastHists;
+    PedHists minuitHists;
+    fastHists.detachHists();
+    minuitHists.detachHists();
+    fillPeds(fastHists, minuitHists, rngIdx, true);
+
+    CalPed fastPed;
+    fastHists.fitHists(fastPed, 1, true);
+
+    TEST_ASSERT("flat distribution fails closed form quality check",
+                !usedFastFit(fastHists, rngIdx));
+
+    fastHists.deleteHists();
+    minuitHists.deleteHists();
+    return retVal;
+  }
+
+  /// same binning as IntNonlinAlg per channel samples
+  const unsigned N_SAMPLE_BINS = 4096;
+  const double   SAMPLE_XMIN   = -0.5;
+  const double   SAMPLE_XMAX   = 4095.5;
+  const unsigned N_SAMPLES     = 200;
+
+  /// clippedMeanRMS() matches original TH1 SetAxisRange() clipping loop
+  bool test_clippedMeanRMS() {
+    bool retVal = true;
+
+    typedef ChannelSampleBuf<RngIdx, unsigned short> SampleBuf;
+    SampleBuf buf(N_SAMPLES);
+
+    RngIdx chans[2];
+    chans[1]++;
+
+    TRandom3 rand(65539);
+    for (unsigned n = 0; n < N_SAMPLES; n++) {
+      // few far outliers which clipping must remove
+      const double adc = (n % 50 == 0) ?
+        gausADC(rand, 3000, 10) :
+        gausADC(rand, 1000, 3);
+      buf.add(chans[0], 0, (unsigned short)adc);
+    }
+    TEST_ASSERT("samples counted", buf.getNSamples(chans[0]) == N_SAMPLES);
+    TEST_ASSERT("other channel empty", buf.getNSamples(chans[1]) == 0);
+
+    TH1S h("", "", N_SAMPLE_BINS, SAMPLE_XMIN, SAMPLE_XMAX);
+    h.SetDirectory(0);
+    const unsigned short *const samples = buf.getSamples(chans[0]);
+    for (unsigned n = 0; n < N_SAMPLES; n++)
+      h.Fill(samples[n]);
+
+    const float histRawMean = h.GetMean();
+    const float histRawRMS  = h.GetRMS();
+    float av = histRawMean;
+    float err = histRawRMS;
+    for (unsigned short iter = 0; iter < 3; iter++) {
+      h.SetAxisRange(av-3*err, av+3*err);
+      av = h.GetMean(); err = h.GetRMS();
+    }
+
+    float rawMean, rawRMS, mean, rms;
+    clippedMeanRMS(samples, buf.getNSamples(chans[0]),
+                   N_SAMPLE_BINS, SAMPLE_XMIN, SAMPLE_XMAX,
+                   rawMean, rawRMS, mean, rms);
+
+    TEST_ASSERT("raw mean matches TH1", fabs(rawMean - histRawMean) < 1e-3);
+    TEST_ASSERT("raw rms matches TH1", fabs(rawRMS - histRawRMS) < 1e-3);
+    TEST_ASSERT("clipped mean matches TH1", fabs(mean - av) < 1e-3);
+    TEST_ASSERT("clipped rms matches TH1", fabs(rms - err) < 1e-3);
+    TEST_ASSERT("outliers clipped", fabs(mean - 1000) < 1);
+
+    // clear() starts new setting, buffer is fixed size
+    buf.clear(chans[0]);
+    TEST_ASSERT("clear() discards samples", buf.getNSamples(chans[0]) == 0);
+
+    for (unsigned n = 0; n < N_SAMPLES; n++)
+      buf.add(chans[1], 0, 1);
+    bool threw = false;
+    try {
+      buf.add(chans[1], 0, 1);
+    } catch (runtime_error &) {
+      threw = true;
+    }
+    TEST_ASSERT("overflow throws", threw);
+
+    // channel which missed 1st event of new step is still reset
+    threw = false;
+    try {
+      buf.add(chans[1], N_SAMPLES + 1, 2);
+    } catch (runtime_error &) {
+      threw = true;
+    }
+    TEST_ASSERT("new step resets channel", !threw && buf.getNSamples(chans[1]) == 1);
+    TEST_ASSERT("new step sample stored", buf.getSamples(chans[1])[0] == 2);
+
+    return retVal;
+  }
+}; // end  anon namespace
+
+/// used to get the type name into the test msg:
+#define RUN_TEST(x) ((std::cout << "Testing: " << # x << " ... " << std::endl), test_ ## x());
+
+int main() {
+  try {
+    bool pass = true;
+
+    pass &= RUN_TEST(estimateGaus);
+    pass &= RUN_TEST(estimateGausReject);
+    pass &= RUN_TEST(clippedMeanRMS);
+
+    cout << "ALL_TESTS_COMPLETE: " <<
+      string((pass) ? "PASS" : "FAIL");
+    cout << endl;
+
+    return pass ? 0 : -1;
+  } catch (exception &e) {
+    cout << "Unexpected exception: " << e.what() << endl;
+    return -1;
+  }
+}
@@ -0,0 +1,469 @@
+// $Header: $
+
+/** @file
+    unit tests for buffered HistVec::fill() (FlatHistBuf), merging of
+    thread private collections w/ HistVec::addHists() & merging of per
+    worker HistShard fill buffers into HistVec / HistMap collections.
+*/
+
+// LOCAL INCLUDES
+#include "src/lib/Hists/HistVec.h"
+#include "src/lib/Hists/FlatHistBuf.h"
+#include "src/lib/Hists/HistShard.h"
+#include "src/lib/Hists/HistMap.h"
+#include "src/lib/Hists/GCRHists.h"
+
+// GLAST INCLUDES
+#include "CalUtil/CalDefs.h"
+
+// EXTLIB INCLUDES
+#include "TH1S.h"
+#include "TH1I.h"
+#include "TProfile.h"
+
+// STD INCLUDES
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+using namespace calibGenCAL;
+using namespace CalUtil;
+
+#define TEST_ASSERT(str, test) if (!(test)) retVal = false, \
+                                    cout << "TESTFAIL! " __FILE__ \
+                                    << ":" << __LINE__ << " "<< str << endl;
+
+namespace {
+  typedef HistVec<RngIdx, TH1S> TestHists;
+
+  const unsigned N_BINS   = 50;
+  const float    LO_LIMIT = 0;
+  const float    HI_LIMIT = 100;
+
+  /// # of channels filled in each test
+  const unsigned N_TEST_CHANS = 3;
+
+  /// deterministic integer 'adc' values in [-10, 110), incl under/overflow
+  class FillGen {
+  public:
+    FillGen() : m_state(12345) {}
+
+    double next() {
+      m_state = m_state*1103515245 + 12345;
+      return (double)((m_state >> 16) % 120) - 10;
+    }
+
+  private:
+    unsigned m_state;
+  };
+
+  /// spread test channels over full index range
+  vector<RngIdx> testChannels() {
+    vector<RngIdx> retVal;
+    const unsigned step = RngIdx::N_VALS/N_TEST_CHANS;
+
+    unsigned n = 0;
+    for (RngIdx idx; idx.isValid(); idx++, n++)
+      if (n % step == 0 && retVal.size() < N_TEST_CHANS)
+        retVal.push_back(idx);
+
+    return retVal;
+  }
+
+  /// new detached collection w/ fixed test binning
+  TestHists *newHists(const string &name) {
+    TestHists *const hists = new TestHists(name, 0, 0, N_BINS, LO_LIMIT, HI_LIMIT);
+    hists->detachHists();
+    return hists;
+  }
+
+  /// true if histograms have identical contents, entries & moments
+  bool sameHist(const TH1 &a,
+                const TH1 &b) {
+    if (a.GetNbinsX() != b.GetNbinsX())
+      return false;
+
+    for (int bin = 0; bin <= a.GetNbinsX() + 1; bin++)
+      if (a.GetBinContent(bin) != b.GetBinContent(bin))
+        return false;
+
+    return a.GetEntries() == b.GetEntries() &&
+      fabs(a.GetMean() - b.GetMean()) < 1e-9 &&
+      fabs(a.GetRMS() - b.GetRMS()) < 1e-9;
+  }
+
+  /// true if histograms are bit-identical: bins, Sumw2, entries & statistics
+  bool identicalHist(const TH1 &a,
+                     const TH1 &b) {
+    if (a.GetNbinsX() != b.GetNbinsX() ||
+        a.GetEntries() != b.GetEntries())
+      return false;
+
+    for (int bin = 0; bin <= a.GetNbinsX() + 1; bin++)
+      if (a.GetBinContent(bin) != b.GetBinContent(bin) ||
+          a.GetBinError(bin) != b.GetBinError(bin))
+        return false;
+
+    Double_t statsA[TH1::kNstat];
+    Double_t statsB[TH1::kNstat];
+    fill(statsA, statsA + TH1::kNstat, 0);
+    fill(statsB, statsB + TH1::kNstat, 0);
+    a.GetStats(statsA);
+    b.GetStats(statsB);
+    for (unsigned i = 0; i < TH1::kNstat; i++)
+      if (statsA[i] != statsB[i])
+        return false;
+
+    return true;
+  }
+
+  /// fill() through buffer gives same histograms as TH1::Fill()
+  bool test_FlatHistBuf() {
+    bool retVal = true;
+
+    const vector<RngIdx> chans(testChannels());
+    TestHists *const hists = newHists("flat");
+
+    vector<TH1S*> refs;
+    for (unsigned i = 0; i < chans.size(); i++) {
+      refs.push_back(new TH1S("", "", N_BINS, LO_LIMIT, HI_LIMIT));
+      refs.back()->SetDirectory(0);
+    }
+
+    // different # of fills per channel
+    FillGen gen;
+    for (unsigned i = 0; i < chans.size(); i++)
+      for (unsigned n = 0; n < 1000*(i+1); n++) {
+        const double x = gen.next();
+        hists->fill(chans[i], x);
+        refs[i]->Fill(x);
+      }
+
+    TEST_ASSERT("getMinEntries() counts buffered fills",
+                hists->getMinEntries() == 1000);
+
+    // getHist() merges requested channel only
+    hists->getHist(chans[0]);
+    TEST_ASSERT("getHist() leaves other channels buffered", !hists->hasHist(chans[1]));
+    TEST_ASSERT("getMinEntries() after single channel flush",
+                hists->getMinEntries() == 1000);
+
+    for (unsigned i = 0; i < chans.size(); i++) {
+      const TH1S *const hist = hists->getHist(chans[i]);
+      TEST_ASSERT("buffered channel has histogram", hist != 0);
+      if (hist != 0)
+        TEST_ASSERT("buffered fills match TH1::Fill()", sameHist(*hist, *refs[i]));
+    }
+
+    // channel w/ no fills has no histogram
+    RngIdx unfilled;
+    unfilled++;
+    TEST_ASSERT("unfilled channel has no histogram", hists->getHist(unfilled) == 0);
+
+    // later fills are added to flushed histogram
+    for (unsigned n = 0; n < 500; n++) {
+      const double x = gen.next();
+      hists->fill(chans[0], x);
+      refs[0]->Fill(x);
+    }
+    hists->trimHists();
+    TEST_ASSERT("2nd flush adds to existing histogram",
+                sameHist(*hists->getHist(chans[0]), *refs[0]));
+
+    hists->deleteHists();
+    delete hists;
+    for (unsigned i = 0; i < refs.size(); i++)
+      delete refs[i];
+
+    return retVal;
+  }
+
+  /// channels are allocated on 1st fill only
+  bool test_FlatHistBufAlloc() {
+    bool retVal = true;
+
+    const vector<RngIdx> chans(testChannels());
+    FlatHistBuf<RngIdx, TH1S> buf(N_BINS, LO_LIMIT, HI_LIMIT);
+    TEST_ASSERT("empty buffer allocates nothing", buf.getNAllocated() == 0);
+    TEST_ASSERT("empty buffer not pending", !buf.isPending());
+
+    buf.fill(chans[1], 10);
+    buf.fill(chans[1], 20);
+    TEST_ASSERT("1 channel allocated", buf.getNAllocated() == 1);
+    TEST_ASSERT("fills counted", buf.getEntries(chans[1]) == 2);
+    TEST_ASSERT("other channel empty", buf.getEntries(chans[0]) == 0);
+
+    buf.reset();
+    TEST_ASSERT("reset() clears entries", buf.getEntries(chans[1]) == 0);
+    TEST_ASSERT("reset() clears pending", !buf.isPending());
+
+    // TH1S saturates at SHRT_MAX, Sumw2 keeps counting past 16 bit range
+    TH1S ref("", "", N_BINS, LO_LIMIT, HI_LIMIT);
+    ref.SetDirectory(0);
+    ref.Sumw2();
+    for (unsigned n = 0; n < 70000; n++) {
+      buf.fill(chans[2], 50);
+      ref.Fill(50);
+    }
+    TH1S merged("", "", N_BINS, LO_LIMIT, HI_LIMIT);
+    merged.SetDirectory(0);
+    merged.Sumw2();
+    buf.mergeInto(chans[2], merged);
+    TEST_ASSERT("saturated bin matches TH1S", identicalHist(merged, ref));
+
+    // resetChannel() clears single channel
+    buf.fill(chans[1], 10);
+    buf.resetChannel(chans[2]);
+    TEST_ASSERT("resetChannel() clears entries", buf.getEntries(chans[2]) == 0);
+    TEST_ASSERT("resetChannel() keeps other channels", buf.getEntries(chans[1]) == 1);
+
+    // binning must match
+    bool threw = false;
+    try {
+      TH1S wrong("", "", N_BINS + 1, LO_LIMIT, HI_LIMIT);
+      wrong.SetDirectory(0);
+      buf.mergeInto(chans[2], wrong);
+    } catch (runtime_error &) {
+      threw = true;
+    }
+    TEST_ASSERT("binning mismatch throws", threw);
+
+    return retVal;
+  }
+
+  /// merging per shard collections w/ addHists() matches serial filling
+  bool test_addHists() {
+    bool retVal = true;
+
+    const vector<RngIdx> chans(testChannels());
+    const unsigned N_SHARDS = 3;
+    const unsigned N_FILLS  = 3000;
+
+    TestHists *const serial = newHists("serial");
+    vector<TestHists*> shards;
+    for (unsigned i = 0; i < N_SHARDS; i++)
+      shards.push_back(newHists("shard"));
+
+    // contiguous fill ranges, same as ShardedEventLoop
+    FillGen gen;
+    for (unsigned n = 0; n < N_FILLS; n++)
+      for (unsigned i = 0; i < chans.size(); i++) {
+        const double x = gen.next();
+        serial->fill(chans[i], x);
+        shards[n*N_SHARDS/N_FILLS]->fill(chans[i], x);
+      }
+
+    // one shard already flushed to histograms, others still buffered
+    shards[1]->trimHists();
+
+    TestHists *const merged = newHists("merged");
+    for (unsigned i = 0; i < N_SHARDS; i++)
+      merged->addHists(*shards[i]);
+
+    TEST_ASSERT("merged min entries",
+                merged->getMinEntries() == serial->getMinEntries());
+
+    for (unsigned i = 0; i < chans.size(); i++) {
+      const TH1S *const a = serial->getHist(chans[i]);
+      const TH1S *const b = merged->getHist(chans[i]);
+      TEST_ASSERT("merged channel has histogram", a != 0 && b != 0);
+      if (a != 0 && b != 0)
+        TEST_ASSERT("merged shards match serial fill", sameHist(*a, *b));
+    }
+
+    serial->deleteHists();
+    delete serial;
+    merged->deleteHists();
+    delete merged;
+    for (unsigned i = 0; i < shards.size(); i++) {
+      shards[i]->deleteHists();
+      delete shards[i];
+    }
+
+    return retVal;
+  }
+
+  /// HistVec::mergeShard() in shard order is bit-identical to serial filling
+  bool test_HistVecShard() {
+    bool retVal = true;
+
+    const vector<RngIdx> chans(testChannels());
+    const unsigned N_SHARDS = 3;
+    const unsigned N_FILLS  = 3000;
+
+    TestHists *const serial = newHists("serial");
+    TestHists *const merged = newHists("merged");
+
+    typedef HistVec<RngIdx, TProfile> TestProfs;
+    TestProfs serialProf("serialProf", 0, 0, N_BINS, LO_LIMIT, HI_LIMIT);
+    TestProfs mergedProf("mergedProf", 0, 0, N_BINS, LO_LIMIT, HI_LIMIT);
+    serialProf.detachHists();
+    mergedProf.detachHists();
+
+    vector<TestHists::shard_type*> shards;
+    vector<TestProfs::shard_type*> profShards;
+    for (unsigned i = 0; i < N_SHARDS; i++) {
+      shards.push_back(merged->newShard());
+      profShards.push_back(mergedProf.newShard());
+    }
+
+    // contiguous fill ranges, same as ShardedEventLoop
+    FillGen gen;
+    for (unsigned n = 0; n < N_FILLS; n++)
+      for (unsigned i = 0; i < chans.size(); i++) {
+        const double x = gen.next();
+        const double y = gen.next();
+        const unsigned shard = n*N_SHARDS/N_FILLS;
+
+        serial->fill(chans[i], x);
+        shards[shard]->fill(chans[i], x);
+
+        serialProf.produceHist(chans[i]).Fill(x, y);
+        profShards[shard]->fill(chans[i], x, y);
+      }
+
+    TEST_ASSERT("shard entries",
+                shards[0]->getEntries(chans[0]) == N_FILLS/N_SHARDS);
+
+    for (unsigned i = 0; i < N_SHARDS; i++) {
+      merged->mergeShard(*shards[i]);
+      mergedProf.mergeShard(*profShards[i]);
+    }
+
+    TEST_ASSERT("merged min entries",
+                merged->getMinEntries() == serial->getMinEntries());
+
+    for (unsigned i = 0; i < chans.size(); i++) {
+      const TH1S *const a = serial->getHist(chans[i]);
+      const TH1S *const b = merged->getHist(chans[i]);
+      TEST_ASSERT("merged channel has histogram", a != 0 && b != 0);
+      if (a != 0 && b != 0)
+        TEST_ASSERT("merged shards bit-identical to serial fill", identicalHist(*a, *b));
+
+      const TProfile *const pa = serialProf.getHist(chans[i]);
+      const TProfile *const pb = mergedProf.getHist(chans[i]);
+      TEST_ASSERT("merged channel has profile", pa != 0 && pb != 0);
+      if (pa != 0 && pb != 0) {
+        TEST_ASSERT("merged profile shards bit-identical to serial fill",
+                    identicalHist(*pa, *pb));
+        for (int bin = 0; bin <= pa->GetNbinsX() + 1; bin++)
+          TEST_ASSERT("merged profile bin entries",
+                      pa->GetBinEntries(bin) == pb->GetBinEntries(bin));
+      }
+    }
+
+    // binning must match
+    bool threw = false;
+    try {
+      TH1S wrong("", "", N_BINS + 1, LO_LIMIT, HI_LIMIT);
+      wrong.SetDirectory(0);
+      shards[0]->mergeInto(chans[0], wrong);
+    } catch (runtime_error &) {
+      threw = true;
+    }
+    TEST_ASSERT("binning mismatch throws", threw);
+
+    for (unsigned i = 0; i < N_SHARDS; i++) {
+      delete shards[i];
+      delete profShards[i];
+    }
+    serial->deleteHists();
+    delete serial;
+    merged->deleteHists();
+    delete merged;
+    serialProf.deleteHists();
+    mergedProf.deleteHists();
+
+    return retVal;
+  }
+
+  /// HistMap::mergeShard() of packed & unpacked shards in shard order is
+  /// bit-identical to serial filling
+  bool test_HistMapShard() {
+    bool retVal = true;
+
+    typedef HistMap<ZDiodeId, TH1I> TestMap;
+    const unsigned N_SHARDS = 4;
+    const unsigned N_FILLS  = 4000;
+    const unsigned N_Z      = 5;
+
+    TestMap serial("serialMap", 0, 0, N_BINS, LO_LIMIT, HI_LIMIT);
+    TestMap merged("mergedMap", 0, 0, N_BINS, LO_LIMIT, HI_LIMIT);
+    serial.detachHists();
+    merged.detachHists();
+
+    vector<TestMap::shard_type*> shards;
+    for (unsigned i = 0; i < N_SHARDS; i++)
+      shards.push_back(merged.newShard());
+
+    // sparse index, not every shard fills every histogram
+    FillGen gen;
+    for (unsigned n = 0; n < N_FILLS; n++) {
+      const ZDiodeId id(n % N_Z + (n < N_FILLS/2 ? 0 : 10), LRG_DIODE);
+      const double x = gen.next();
+      serial.produceHist(id).Fill(x);
+      shards[n*N_SHARDS/N_FILLS]->fill(id, x);
+    }
+
+    // shards come back from worker processes packed (see ShardedEventLoop)
+    for (unsigned i = 0; i < N_SHARDS; i++) {
+      string buf;
+      shards[i]->pack(buf);
+
+      TestMap::shard_type *const unpacked = merged.newShard();
+      ResultReader reader(buf);
+      unpacked->unpack(reader);
+      TEST_ASSERT("packed shard fully read", reader.atEnd());
+
+      merged.mergeShard(*unpacked);
+      delete unpacked;
+    }
+
+    unsigned nHists = 0;
+    for (TestMap::const_iterator it = serial.begin(); it != serial.end(); it++, nHists++) {
+      const TH1I *const b = merged.getHist(it->first);
+      TEST_ASSERT("merged index has histogram", b != 0);
+      if (b != 0)
+        TEST_ASSERT("merged shards bit-identical to serial fill",
+                    identicalHist(*it->second, *b));
+    }
+    TEST_ASSERT("all indices filled", nHists == 2*N_Z);
+
+    unsigned nMerged = 0;
+    for (TestMap::const_iterator it = merged.begin(); it != merged.end(); it++)
+      nMerged++;
+    TEST_ASSERT("no extra indices", nMerged == nHists);
+
+    for (unsigned i = 0; i < N_SHARDS; i++)
+      delete shards[i];
+
+    return retVal;
+  }
+}; // end  anon namespace
+
+/// used to get the type name into the test msg:
+#define RUN_TEST(x) ((std::cout << "Testing: " << # x << " ... " << std::endl), test_ ## x());
+
+int main() {
+  try {
+    bool pass = true;
+
+    pass &= RUN_TEST(FlatHistBuf);
+    pass &= RUN_TEST(FlatHistBufAlloc);
+    pass &= RUN_TEST(addHists);
+    pass &= RUN_TEST(HistVecShard);
+    pass &= RUN_TEST(HistMapShard);
+
+    cout << "ALL_TESTS_COMPLETE: " <<
+      string((pass) ? "PASS" : "FAIL");
+    cout << endl;
+
+    return pass ? 0 : -1;
+  } catch (exception &e) {
+    cout << "Unexpected exception: " << e.what() << endl;
+    return -1;
+  }
+}